@@ -0,0 +1,180 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#ifndef HOLOLIGHT_UNREAL_STREAMAUDIO_H
+#define HOLOLIGHT_UNREAL_STREAMAUDIO_H
+
+#include "CoreMinimal.h"
+
+#include <cstdint>
+
+#if PLATFORM_CPU_X86_FAMILY
+#include <immintrin.h>
+#endif
+
+namespace stream::audio
+{
+
+using FFloatToPcm16Kernel = void (*)(const float* in, int16_t* out, int32 count);
+
+// Reference implementation, positive and negative halves are scaled separately so -1.0 maps to MIN_int16
+inline void FloatToPcm16_Scalar(const float* in, int16_t* out, int32 count)
+{
+	for (int32 i = 0; i < count; i++)
+	{
+		const float sample = FMath::Clamp(in[i], -1.0f, 1.0f);
+		const int32 value = sample >= 0 ? sample * int32(MAX_int16) : sample * (int32(MAX_int16) + 1);
+		out[i] = static_cast<int16_t>(FMath::Clamp(value, int32(MIN_int16), int32(MAX_int16)));
+	}
+}
+
+#if PLATFORM_CPU_X86_FAMILY
+// SSE2 is the x64 baseline, so this path is always available on supported platforms
+inline void FloatToPcm16_SSE2(const float* in, int16_t* out, int32 count)
+{
+	const __m128 minValue = _mm_set1_ps(-1.0f);
+	const __m128 maxValue = _mm_set1_ps(1.0f);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 positiveScale = _mm_set1_ps(float(MAX_int16));
+	const __m128 negativeScale = _mm_set1_ps(float(int32(MAX_int16) + 1));
+
+	auto convert = [&](__m128 samples) {
+		// min first, so NaN ends up at the upper bound the same way FMath::Clamp does
+		samples = _mm_max_ps(_mm_min_ps(samples, maxValue), minValue);
+		const __m128 negative = _mm_cmplt_ps(samples, zero);
+		const __m128 scale = _mm_or_ps(_mm_and_ps(negative, negativeScale), _mm_andnot_ps(negative, positiveScale));
+		return _mm_cvttps_epi32(_mm_mul_ps(samples, scale));
+	};
+
+	int32 i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		const __m128i low = convert(_mm_loadu_ps(in + i));
+		const __m128i high = convert(_mm_loadu_ps(in + i + 4));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packs_epi32(low, high));
+	}
+
+	FloatToPcm16_Scalar(in + i, out + i, count - i);
+}
+
+// Compiled without /arch:AVX2, only selected after checking the CPU supports it
+inline void FloatToPcm16_AVX2(const float* in, int16_t* out, int32 count)
+{
+	const __m256 minValue = _mm256_set1_ps(-1.0f);
+	const __m256 maxValue = _mm256_set1_ps(1.0f);
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 positiveScale = _mm256_set1_ps(float(MAX_int16));
+	const __m256 negativeScale = _mm256_set1_ps(float(int32(MAX_int16) + 1));
+
+	auto convert = [&](__m256 samples) {
+		samples = _mm256_max_ps(_mm256_min_ps(samples, maxValue), minValue);
+		const __m256 negative = _mm256_cmp_ps(samples, zero, _CMP_LT_OQ);
+		const __m256 scale = _mm256_blendv_ps(positiveScale, negativeScale, negative);
+		return _mm256_cvttps_epi32(_mm256_mul_ps(samples, scale));
+	};
+
+	int32 i = 0;
+	for (; i + 16 <= count; i += 16)
+	{
+		const __m256i low = convert(_mm256_loadu_ps(in + i));
+		const __m256i high = convert(_mm256_loadu_ps(in + i + 8));
+		// packs works per 128 bit lane, restore the sample order afterwards
+		const __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(low, high), 0xD8);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), packed);
+	}
+
+	FloatToPcm16_SSE2(in + i, out + i, count - i);
+}
+#endif
+
+inline FFloatToPcm16Kernel SelectFloatToPcm16Kernel()
+{
+#if PLATFORM_CPU_X86_FAMILY
+	if (FPlatformMisc::HasAVX2InstructionSupport())
+	{
+		return &FloatToPcm16_AVX2;
+	}
+	return &FloatToPcm16_SSE2;
+#else
+	return &FloatToPcm16_Scalar;
+#endif
+}
+
+// Converts normalized float samples to PCM16 with the best kernel the CPU supports
+FORCEINLINE void FloatToPcm16(const float* in, int16_t* out, int32 count)
+{
+	static const FFloatToPcm16Kernel kernel = SelectFloatToPcm16Kernel();
+	kernel(in, out, count);
+}
+
+using FPcm16ToFloatKernel = void (*)(const int16_t* in, float* out, int32 count);
+
+inline void Pcm16ToFloat_Scalar(const int16_t* in, float* out, int32 count)
+{
+	constexpr float scale = 1.0f / float(MAX_int16);
+	for (int32 i = 0; i < count; i++)
+	{
+		out[i] = in[i] * scale;
+	}
+}
+
+#if PLATFORM_CPU_X86_FAMILY
+inline void Pcm16ToFloat_SSE2(const int16_t* in, float* out, int32 count)
+{
+	const __m128 scale = _mm_set1_ps(1.0f / float(MAX_int16));
+
+	int32 i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+		// Duplicating each sample into both halves and shifting back sign extends it to 32 bit
+		const __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+		const __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+		_mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(low), scale));
+		_mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), scale));
+	}
+
+	Pcm16ToFloat_Scalar(in + i, out + i, count - i);
+}
+
+inline void Pcm16ToFloat_AVX2(const int16_t* in, float* out, int32 count)
+{
+	const __m256 scale = _mm256_set1_ps(1.0f / float(MAX_int16));
+
+	int32 i = 0;
+	for (; i + 16 <= count; i += 16)
+	{
+		const __m256i low = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)));
+		const __m256i high = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 8)));
+		_mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(low), scale));
+		_mm256_storeu_ps(out + i + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(high), scale));
+	}
+
+	Pcm16ToFloat_SSE2(in + i, out + i, count - i);
+}
+#endif
+
+inline FPcm16ToFloatKernel SelectPcm16ToFloatKernel()
+{
+#if PLATFORM_CPU_X86_FAMILY
+	if (FPlatformMisc::HasAVX2InstructionSupport())
+	{
+		return &Pcm16ToFloat_AVX2;
+	}
+	return &Pcm16ToFloat_SSE2;
+#else
+	return &Pcm16ToFloat_Scalar;
+#endif
+}
+
+// Converts PCM16 samples to normalized float with the best kernel the CPU supports
+FORCEINLINE void Pcm16ToFloat(const int16_t* in, float* out, int32 count)
+{
+	static const FPcm16ToFloatKernel kernel = SelectPcm16ToFloatKernel();
+	kernel(in, out, count);
+}
+
+} // namespace stream::audio
+
+#endif // HOLOLIGHT_UNREAL_STREAMAUDIO_H
\ No newline at end of file
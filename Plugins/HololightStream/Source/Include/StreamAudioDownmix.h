@@ -0,0 +1,194 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#ifndef HOLOLIGHT_UNREAL_STREAMAUDIODOWNMIX_H
+#define HOLOLIGHT_UNREAL_STREAMAUDIODOWNMIX_H
+
+#include "CoreMinimal.h"
+
+#if PLATFORM_CPU_X86_FAMILY
+#include <immintrin.h>
+#endif
+
+namespace stream::audio
+{
+
+/// <summary>
+/// Mixes interleaved float audio down to mono or stereo with a gain matrix. Configure loads the ITU-R BS.775 reference
+/// coefficients for the layout, individual gains can be overridden afterwards. Input channels follow the audio mixer
+/// order: FL, FR, FC, LFE, followed by the surround pair for 5.1 and by the back and side pairs for 7.1. LFE is
+/// dropped by the reference matrix.
+/// </summary>
+class FStreamAudioDownmix
+{
+public:
+	static constexpr int32 MAX_INPUT_CHANNELS = 8;
+	static constexpr int32 MAX_OUTPUT_CHANNELS = 2;
+
+	bool Configure(int32 inputChannels, int32 outputChannels)
+	{
+		if (inputChannels < 1 || inputChannels > MAX_INPUT_CHANNELS || outputChannels < 1 ||
+			outputChannels > MAX_OUTPUT_CHANNELS || outputChannels > inputChannels)
+		{
+			return false;
+		}
+
+		constexpr float minus3dB = 0.70710678f;
+		FMemory::Memzero(m_matrix, sizeof(m_matrix));
+
+		float* left = m_matrix[0];
+		float* right = m_matrix[1];
+		switch (inputChannels)
+		{
+		case 1:
+			left[0] = 1.0f;
+			break;
+		case 2:
+			left[0] = 1.0f;
+			right[1] = 1.0f;
+			break;
+		case 4:
+			// Quad: FL, FR, BL, BR
+			left[0] = 1.0f;
+			right[1] = 1.0f;
+			left[2] = minus3dB;
+			right[3] = minus3dB;
+			break;
+		case 6:
+		case 8:
+			left[0] = 1.0f;
+			right[1] = 1.0f;
+			left[2] = minus3dB;
+			right[2] = minus3dB;
+			for (int32 channel = 4; channel < inputChannels; channel += 2)
+			{
+				left[channel] = minus3dB;
+				right[channel + 1] = minus3dB;
+			}
+			break;
+		default:
+			// Odd layouts have no reference matrix, fold them evenly into both sides
+			for (int32 channel = 0; channel < inputChannels; channel++)
+			{
+				left[channel] = 1.0f / inputChannels;
+				right[channel] = 1.0f / inputChannels;
+			}
+			break;
+		}
+
+		if (outputChannels == 1)
+		{
+			// Mono is the average of the stereo fold-down, a mono input passes through unchanged
+			for (int32 channel = 0; channel < MAX_INPUT_CHANNELS; channel++)
+			{
+				left[channel] = inputChannels == 1 ? left[channel] : 0.5f * (left[channel] + right[channel]);
+				right[channel] = 0.0f;
+			}
+		}
+
+		m_inputChannels = inputChannels;
+		m_outputChannels = outputChannels;
+		return true;
+	}
+
+	void SetCoefficient(int32 outputChannel, int32 inputChannel, float gain)
+	{
+		check(outputChannel < MAX_OUTPUT_CHANNELS && inputChannel < MAX_INPUT_CHANNELS);
+		m_matrix[outputChannel][inputChannel] = gain;
+	}
+
+	float GetCoefficient(int32 outputChannel, int32 inputChannel) const
+	{
+		check(outputChannel < MAX_OUTPUT_CHANNELS && inputChannel < MAX_INPUT_CHANNELS);
+		return m_matrix[outputChannel][inputChannel];
+	}
+
+	bool IsConfiguredFor(int32 inputChannels, int32 outputChannels) const
+	{
+		return m_inputChannels == inputChannels && m_outputChannels == outputChannels;
+	}
+
+	// Writes numFrames * outputChannels samples to output
+	void Process(const float* input, int32 numFrames, float* output) const
+	{
+#if PLATFORM_CPU_X86_FAMILY
+		switch (m_inputChannels * 10 + m_outputChannels)
+		{
+		case 41: ProcessSSE<4, 1>(input, numFrames, output); return;
+		case 42: ProcessSSE<4, 2>(input, numFrames, output); return;
+		case 61: ProcessSSE<6, 1>(input, numFrames, output); return;
+		case 62: ProcessSSE<6, 2>(input, numFrames, output); return;
+		case 81: ProcessSSE<8, 1>(input, numFrames, output); return;
+		case 82: ProcessSSE<8, 2>(input, numFrames, output); return;
+		default: break;
+		}
+#endif
+		for (int32 frame = 0; frame < numFrames; frame++)
+		{
+			const float* in = input + frame * m_inputChannels;
+			for (int32 outChannel = 0; outChannel < m_outputChannels; outChannel++)
+			{
+				float sum = 0.0f;
+				for (int32 inChannel = 0; inChannel < m_inputChannels; inChannel++)
+				{
+					sum += m_matrix[outChannel][inChannel] * in[inChannel];
+				}
+				output[frame * m_outputChannels + outChannel] = sum;
+			}
+		}
+	}
+
+private:
+	int32 m_inputChannels = 0;
+	int32 m_outputChannels = 0;
+	// Zero padded to MAX_INPUT_CHANNELS so the vector path can always load two full registers per row
+	alignas(16) float m_matrix[MAX_OUTPUT_CHANNELS][MAX_INPUT_CHANNELS] = {};
+
+#if PLATFORM_CPU_X86_FAMILY
+	template <int32 InputChannels, int32 OutputChannels>
+	void ProcessSSE(const float* input, int32 numFrames, float* output) const
+	{
+		const __m128 left0 = _mm_load_ps(&m_matrix[0][0]);
+		const __m128 left1 = _mm_load_ps(&m_matrix[0][4]);
+		const __m128 right0 = _mm_load_ps(&m_matrix[1][0]);
+		const __m128 right1 = _mm_load_ps(&m_matrix[1][4]);
+
+		for (int32 frame = 0; frame < numFrames; frame++)
+		{
+			const float* in = input + frame * InputChannels;
+			const __m128 front = _mm_loadu_ps(in);
+			__m128 back = _mm_setzero_ps();
+			if constexpr (InputChannels == 8)
+			{
+				back = _mm_loadu_ps(in + 4);
+			}
+			else if constexpr (InputChannels == 6)
+			{
+				// Loads the last two channels without reading past the frame
+				back = _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(in + 4)));
+			}
+
+			const __m128 left = _mm_add_ps(_mm_mul_ps(front, left0), _mm_mul_ps(back, left1));
+			if constexpr (OutputChannels == 1)
+			{
+				__m128 sum = _mm_add_ps(left, _mm_movehl_ps(left, left));
+				sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 1, 1, 1)));
+				_mm_store_ss(output + frame, sum);
+			}
+			else
+			{
+				const __m128 right = _mm_add_ps(_mm_mul_ps(front, right0), _mm_mul_ps(back, right1));
+				// Horizontal sums of both rows at once, ends up as [L, R, L, R]
+				__m128 sum = _mm_add_ps(_mm_unpacklo_ps(left, right), _mm_unpackhi_ps(left, right));
+				sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+				_mm_storel_pi(reinterpret_cast<__m64*>(output + frame * 2), sum);
+			}
+		}
+	}
+#endif
+};
+
+} // namespace stream::audio
+
+#endif // HOLOLIGHT_UNREAL_STREAMAUDIODOWNMIX_H
\ No newline at end of file
@@ -0,0 +1,179 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#ifndef HOLOLIGHT_UNREAL_STREAMAUDIORESAMPLER_H
+#define HOLOLIGHT_UNREAL_STREAMAUDIORESAMPLER_H
+
+#include "CoreMinimal.h"
+
+#include <numeric>
+
+namespace stream::audio
+{
+
+/// <summary>
+/// Streaming polyphase FIR resampler for interleaved float audio with a rational in/out ratio. The filter history and
+/// phase are kept between calls, so blocks of any size can be fed without discontinuities. Each phase has
+/// TAPS_PER_PHASE taps, times the decimation factor when downsampling, so the transition band stays as narrow relative
+/// to the output rate and the stopband rejection does not drop with the ratio. No memory is allocated once the work
+/// buffer has grown to the largest block size.
+/// </summary>
+class FStreamAudioResampler
+{
+public:
+	static constexpr int32 TAPS_PER_PHASE = 16;
+	// Bounds the coefficient table to TAPS_PER_PHASE * MAX_DECIMATION * MAX_PHASES floats
+	static constexpr int32 MAX_PHASES = 1024;
+	// Ratios beyond 8:1 keep the taps of 8:1, their cutoff still applies but the transition band gets wider
+	static constexpr int32 MAX_DECIMATION = 8;
+
+	bool Configure(int32 inputRate, int32 outputRate, int32 numChannels)
+	{
+		if (inputRate <= 0 || outputRate <= 0 || numChannels <= 0)
+		{
+			return false;
+		}
+
+		const int32 divisor = std::gcd(inputRate, outputRate);
+		const int32 upFactor = outputRate / divisor;
+		const int32 downFactor = inputRate / divisor;
+		if (upFactor > MAX_PHASES)
+		{
+			return false;
+		}
+
+		m_inputRate = inputRate;
+		m_outputRate = outputRate;
+		m_upFactor = upFactor;
+		m_downFactor = downFactor;
+		m_numChannels = numChannels;
+		m_tapsPerPhase = TAPS_PER_PHASE * FMath::Clamp((downFactor + upFactor - 1) / upFactor, 1, MAX_DECIMATION);
+
+		BuildCoefficients();
+		Reset();
+		return true;
+	}
+
+	void Reset()
+	{
+		m_phase = 0;
+		m_inputIndex = 0;
+		// SetNumZeroed only zeroes samples it adds, a history that keeps its size would still hold the old audio
+		const int32 historySamples = (m_tapsPerPhase - 1) * m_numChannels;
+		m_history.SetNumUninitialized(historySamples);
+		FMemory::Memzero(m_history.GetData(), historySamples * sizeof(float));
+	}
+
+	bool IsConfiguredFor(int32 inputRate, int32 outputRate, int32 numChannels) const
+	{
+		return m_inputRate == inputRate && m_outputRate == outputRate && m_numChannels == numChannels;
+	}
+
+	bool IsPassthrough() const { return m_upFactor == m_downFactor; }
+
+	int32 GetTapsPerPhase() const { return m_tapsPerPhase; }
+
+	// Group delay of the linear phase filter in output frames
+	double GetLatencyFrames() const
+	{
+		return (m_tapsPerPhase * m_upFactor - 1) * 0.5 / m_downFactor;
+	}
+
+	// Upper bound of output frames one Process call can produce for the given input
+	int32 GetMaxOutputFrames(int32 inputFrames) const
+	{
+		return static_cast<int32>((int64(inputFrames) * m_upFactor) / m_downFactor) + 1;
+	}
+
+	// Consumes all input frames and returns the number of frames written to output, which must have room for
+	// GetMaxOutputFrames(inputFrames) frames
+	int32 Process(const float* input, int32 inputFrames, float* output)
+	{
+		const int32 tapsPerPhase = m_tapsPerPhase;
+		const int32 historyFrames = tapsPerPhase - 1;
+		const int32 numChannels = m_numChannels;
+
+		// Work buffer is the filter history followed by the new block, so the filter never has to branch on the
+		// block boundary
+		const int32 workSamples = (historyFrames + inputFrames) * numChannels;
+		if (m_work.Num() < workSamples)
+		{
+			m_work.SetNumUninitialized(workSamples);
+		}
+		FMemory::Memcpy(m_work.GetData(), m_history.GetData(), historyFrames * numChannels * sizeof(float));
+		FMemory::Memcpy(m_work.GetData() + historyFrames * numChannels, input, inputFrames * numChannels * sizeof(float));
+
+		const float* work = m_work.GetData();
+		int32 outputFrames = 0;
+		while (m_inputIndex < inputFrames)
+		{
+			const float* coefficients = m_coefficients.GetData() + m_phase * tapsPerPhase;
+			// Newest sample the filter reads, taps walk backwards in time from here
+			const float* newest = work + (historyFrames + m_inputIndex) * numChannels;
+
+			for (int32 channel = 0; channel < numChannels; channel++)
+			{
+				float sum = 0.0f;
+				for (int32 tap = 0; tap < tapsPerPhase; tap++)
+				{
+					sum += coefficients[tap] * newest[channel - tap * numChannels];
+				}
+				output[outputFrames * numChannels + channel] = sum;
+			}
+			outputFrames++;
+
+			m_phase += m_downFactor;
+			m_inputIndex += m_phase / m_upFactor;
+			m_phase %= m_upFactor;
+		}
+		m_inputIndex -= inputFrames;
+
+		FMemory::Memcpy(m_history.GetData(), work + inputFrames * numChannels, historyFrames * numChannels * sizeof(float));
+		return outputFrames;
+	}
+
+private:
+	int32 m_inputRate = 0;
+	int32 m_outputRate = 0;
+	int32 m_upFactor = 1;
+	int32 m_downFactor = 1;
+	int32 m_numChannels = 1;
+	int32 m_tapsPerPhase = TAPS_PER_PHASE;
+
+	int32 m_phase = 0;
+	int32 m_inputIndex = 0;
+
+	// Laid out as [phase][tap] so each output reads one contiguous row
+	TArray<float> m_coefficients;
+	TArray<float> m_history;
+	TArray<float> m_work;
+
+	void BuildCoefficients()
+	{
+		const int32 length = m_tapsPerPhase * m_upFactor;
+		// Cutoff relative to the upsampled rate, just below the lower of the two Nyquist frequencies
+		const double cutoff = 0.45 * FMath::Min(1.0, double(m_upFactor) / m_downFactor) / m_upFactor;
+		const double center = (length - 1) * 0.5;
+
+		m_coefficients.SetNumUninitialized(length);
+		for (int32 i = 0; i < length; i++)
+		{
+			const double x = i - center;
+			const double sinc = FMath::IsNearlyZero(x) ? 1.0 : FMath::Sin(2.0 * PI * cutoff * x) / (2.0 * PI * cutoff * x);
+			// Blackman window
+			const double t = 2.0 * PI * i / (length - 1);
+			const double window = 0.42 - 0.5 * FMath::Cos(t) + 0.08 * FMath::Cos(2.0 * t);
+			// Gain of upFactor makes up for the zero stuffing
+			const double value = 2.0 * cutoff * sinc * window * m_upFactor;
+
+			const int32 phase = i % m_upFactor;
+			const int32 tap = i / m_upFactor;
+			m_coefficients[phase * m_tapsPerPhase + tap] = static_cast<float>(value);
+		}
+	}
+};
+
+} // namespace stream::audio
+
+#endif // HOLOLIGHT_UNREAL_STREAMAUDIORESAMPLER_H
\ No newline at end of file
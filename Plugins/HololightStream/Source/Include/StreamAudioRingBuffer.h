@@ -0,0 +1,158 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#ifndef HOLOLIGHT_UNREAL_STREAMAUDIORINGBUFFER_H
+#define HOLOLIGHT_UNREAL_STREAMAUDIORINGBUFFER_H
+
+#include "CoreMinimal.h"
+
+#include <atomic>
+#include <cstdint>
+
+namespace stream::audio
+{
+
+/// <summary>
+/// Fixed capacity, lock-free single producer/single consumer ring of interleaved PCM16 samples. One thread receives
+/// the audio and writes, another one sends it on and reads. Read and write indices live on separate cache lines so the
+/// two threads do not invalidate each other's lines on every access.
+/// </summary>
+class FStreamAudioRingBuffer
+{
+public:
+	// Capacity is rounded up to the next power of two
+	explicit FStreamAudioRingBuffer(uint32 capacity)
+		: m_capacity(FMath::RoundUpToPowerOfTwo(FMath::Max(capacity, 2u))),
+		  m_mask(m_capacity - 1),
+		  m_writeIndex(0),
+		  m_cachedReadIndex(0),
+		  m_overflowCount(0),
+		  m_readIndex(0),
+		  m_cachedWriteIndex(0),
+		  m_underflowCount(0)
+	{
+		m_buffer.SetNumZeroed(m_capacity);
+	}
+
+	FStreamAudioRingBuffer(const FStreamAudioRingBuffer&) = delete;
+	FStreamAudioRingBuffer& operator=(const FStreamAudioRingBuffer&) = delete;
+
+	// Producer side. Writes all samples or none, so interleaved frames are never split. Dropped samples are counted
+	// as overflow.
+	bool Write(const int16_t* data, uint32 count)
+	{
+		return WriteWith(count, [data](int16_t* destination, uint32 offset, uint32 numSamples) {
+			FMemory::Memcpy(destination, data + offset, numSamples * sizeof(int16_t));
+		});
+	}
+
+	// Producer side. Same as Write, but lets the caller produce the samples directly into the ring. The writer is
+	// called once or twice as writer(destination, sourceOffset, sampleCount), once per contiguous region.
+	template <typename WriterType>
+	bool WriteWith(uint32 count, WriterType&& writer)
+	{
+		const uint64 writeIndex = m_writeIndex.load(std::memory_order_relaxed);
+		if (!HasSpaceFor(writeIndex, count))
+		{
+			m_overflowCount.fetch_add(count, std::memory_order_relaxed);
+			return false;
+		}
+
+		const uint32 start = static_cast<uint32>(writeIndex) & m_mask;
+		const uint32 firstPart = FMath::Min(count, m_capacity - start);
+		writer(m_buffer.GetData() + start, 0u, firstPart);
+		if (firstPart < count)
+		{
+			writer(m_buffer.GetData(), firstPart, count - firstPart);
+		}
+
+		m_writeIndex.store(writeIndex + count, std::memory_order_release);
+		return true;
+	}
+
+	// Consumer side. Reads exactly count samples, or nothing and counts an underflow if not enough are queued.
+	bool Read(int16_t* data, uint32 count)
+	{
+		const uint64 readIndex = m_readIndex.load(std::memory_order_relaxed);
+
+		if (static_cast<uint32>(m_cachedWriteIndex - readIndex) < count)
+		{
+			m_cachedWriteIndex = m_writeIndex.load(std::memory_order_acquire);
+			if (static_cast<uint32>(m_cachedWriteIndex - readIndex) < count)
+			{
+				m_underflowCount.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+		}
+
+		const uint32 start = static_cast<uint32>(readIndex) & m_mask;
+		const uint32 firstPart = FMath::Min(count, m_capacity - start);
+		FMemory::Memcpy(data, m_buffer.GetData() + start, firstPart * sizeof(int16_t));
+		FMemory::Memcpy(data + firstPart, m_buffer.GetData(), (count - firstPart) * sizeof(int16_t));
+
+		m_readIndex.store(readIndex + count, std::memory_order_release);
+		return true;
+	}
+
+	// Consumer side. Discards up to count of the oldest samples and returns how many were discarded.
+	uint32 Skip(uint32 count)
+	{
+		const uint64 readIndex = m_readIndex.load(std::memory_order_relaxed);
+		m_cachedWriteIndex = m_writeIndex.load(std::memory_order_acquire);
+		const uint32 skipped = FMath::Min(count, static_cast<uint32>(m_cachedWriteIndex - readIndex));
+		m_readIndex.store(readIndex + skipped, std::memory_order_release);
+		return skipped;
+	}
+
+	// Consumer side. Discards all queued samples.
+	void Reset()
+	{
+		m_cachedWriteIndex = m_writeIndex.load(std::memory_order_acquire);
+		m_readIndex.store(m_cachedWriteIndex, std::memory_order_release);
+	}
+
+	uint32 Num() const
+	{
+		return static_cast<uint32>(m_writeIndex.load(std::memory_order_acquire) -
+								   m_readIndex.load(std::memory_order_acquire));
+	}
+	uint32 Capacity() const { return m_capacity; }
+
+	uint64 GetOverflowCount() const { return m_overflowCount.load(std::memory_order_relaxed); }
+	uint64 GetUnderflowCount() const { return m_underflowCount.load(std::memory_order_relaxed); }
+
+private:
+	bool HasSpaceFor(uint64 writeIndex, uint32 count)
+	{
+		if (m_capacity - static_cast<uint32>(writeIndex - m_cachedReadIndex) >= count)
+		{
+			return true;
+		}
+
+		// Only touch the consumer line when the stale view says we are out of space
+		m_cachedReadIndex = m_readIndex.load(std::memory_order_acquire);
+		return m_capacity - static_cast<uint32>(writeIndex - m_cachedReadIndex) >= count;
+	}
+
+	TArray<int16_t> m_buffer;
+	uint32 m_capacity;
+	uint32 m_mask;
+
+	// Producer owned line
+	alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> m_writeIndex;
+	uint64 m_cachedReadIndex;
+	std::atomic<uint64> m_overflowCount;
+
+	// Consumer owned line
+	alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> m_readIndex;
+	uint64 m_cachedWriteIndex;
+	std::atomic<uint64> m_underflowCount;
+
+	// Keeps the consumer line from sharing with whatever follows this object
+	alignas(PLATFORM_CACHE_LINE_SIZE) uint8 m_padding[1];
+};
+
+} // namespace stream::audio
+
+#endif // HOLOLIGHT_UNREAL_STREAMAUDIORINGBUFFER_H
\ No newline at end of file
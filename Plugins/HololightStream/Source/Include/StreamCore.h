@@ -57,4 +57,10 @@ FORCEINLINE XrPosef ToXrPose(FTransform Transform, float Scale = 1.0f)
 	return XrPosef{ ToXrQuat(Transform.GetRotation()), ToXrVector(Transform.GetTranslation(), Scale) };
 }
 
+// Pose timestamps are the client's XrTime, in nanoseconds
+FORCEINLINE double PoseTimestampToSeconds(int64_t Timestamp)
+{
+	return Timestamp * 1e-9;
+}
+
 #endif // HOLOLIGHT_UNREAL_STREAMCORE_H
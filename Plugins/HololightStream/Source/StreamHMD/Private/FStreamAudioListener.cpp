@@ -4,15 +4,61 @@
 
 #include "FStreamAudioListener.h"
 
-#include "Runtime/Launch/Resources/Version.h"
+#include "StreamAudio.h"
 
-#include <algorithm>
-#include <execution>
+#include "ProfilingDebugging/CsvProfiler.h"
+
+#include <chrono>
+
+CSV_DEFINE_CATEGORY(StreamAudio, true);
+
+static TAutoConsoleVariable<int32> CVarStreamAudioOutputChannels(
+	TEXT("vr.StreamAudioOutputChannels"),
+	2,
+	TEXT("Maximum number of channels of the streamed game audio, 1 for mono or 2 for stereo. Submixes with more channels are mixed down."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarStreamAudioTargetLatency(
+	TEXT("vr.StreamAudioTargetLatencyMs"),
+	40,
+	TEXT("Amount of game audio in milliseconds the Stream plugin keeps queued before pushing to the client."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarStreamAudioSilenceGate(
+	TEXT("vr.StreamAudioSilenceGate"),
+	1,
+	TEXT("Whether the Stream plugin stops pushing game audio packets while the game is silent."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarStreamAudioSilenceThreshold(
+	TEXT("vr.StreamAudioSilenceThresholdDb"),
+	-70.0f,
+	TEXT("Peak level in dBFS above which game audio opens the silence gate. The gate closes again 6 dB below."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarStreamAudioSilenceKeepalive(
+	TEXT("vr.StreamAudioSilenceKeepaliveMs"),
+	0,
+	TEXT("Interval in milliseconds of keepalive packets sent while the silence gate is closed, 0 disables them."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarStreamAudioComfortNoise(
+	TEXT("vr.StreamAudioComfortNoise"),
+	0,
+	TEXT("Whether keepalive packets carry low level comfort noise instead of digital silence."),
+	ECVF_Default);
+
+// Queue depth may deviate this much from the target before the feedback correction kicks in
+static constexpr int LATENCY_TOLERANCE_FRAMES = FStreamAudioListener::SAMPLE_RATE / 100;
+// The drift estimate is too noisy to act on before the clocks were compared for this long
+static constexpr double DRIFT_WARMUP_SECONDS = 2.0;
+static constexpr double MAX_DRIFT_PPM = 5000.0;
 
 FStreamAudioListener::FStreamAudioListener()
 	: m_connected(false),
 	  m_streamConnection(nullptr),
 	  m_serverApi(nullptr),
+	  m_carryBuffer(RING_BUFFER_CAPACITY),
 	  m_isRunning(true)
 {
 	m_pushThread = std::thread(&FStreamAudioListener::PushCarryBuffer, this);
@@ -38,6 +84,26 @@ void FStreamAudioListener::SetStreamApi(isar::IsarConnection connection, isar::I
 void FStreamAudioListener::SetConnected(bool connected)
 {
 	m_connected = connected;
+	m_resetClockOrigin = true;
+}
+
+void FStreamAudioListener::OnVideoFrameSubmitted(double videoLatencySeconds)
+{
+	m_videoLatencySeconds.store(videoLatencySeconds, std::memory_order_relaxed);
+}
+
+FStreamAudioStats FStreamAudioListener::GetStats() const
+{
+	FStreamAudioStats stats;
+	stats.avOffsetMs = m_avOffsetMs.load(std::memory_order_relaxed);
+	stats.queueDepthMs = m_queueDepthMs.load(std::memory_order_relaxed);
+	stats.driftPpm = m_driftPpm.load(std::memory_order_relaxed);
+	stats.stretchedPackets = m_stretchedPackets.load(std::memory_order_relaxed);
+	stats.skippedPackets = m_skippedPackets.load(std::memory_order_relaxed);
+	stats.overflowSamples = m_carryBuffer.GetOverflowCount();
+	stats.underflowCount = m_carryBuffer.GetUnderflowCount();
+	stats.suppressedPackets = m_suppressedPackets.load(std::memory_order_relaxed);
+	return stats;
 }
 
 void FStreamAudioListener::OnNewSubmixBuffer(const USoundSubmix* owningSubmix, float* audioData, int32 numSamples,
@@ -48,55 +114,297 @@ void FStreamAudioListener::OnNewSubmixBuffer(const USoundSubmix* owningSubmix, f
 		return;
 	}
 
-	if (m_numChannels != inNumChannels)
+	UpdateDriftEstimate(audioClock);
+
+	const int32 numChannels =
+		FMath::Min(inNumChannels, FMath::Clamp(CVarStreamAudioOutputChannels.GetValueOnAnyThread(), 1, MAX_NUM_CHANNELS));
+	if (!m_downmix.IsConfiguredFor(inNumChannels, numChannels))
 	{
-		if (inNumChannels > MAX_NUM_CHANNELS)
+		if (!m_downmix.Configure(inNumChannels, numChannels))
 		{
-			UE_LOG(LogHMD, Display, TEXT("Only mono or stereo audio is supported, will not stream audio."));
+			UE_LOG(LogHMD, Display, TEXT("Can not mix down %d channel audio, will not stream audio."), inNumChannels);
 			return;
 		}
-		m_numChannels = inNumChannels;
 	}
+	m_numChannels = numChannels;
 
-	TArray<int16_t> pcmData;
-	pcmData.Reset(numSamples);
-	pcmData.AddZeroed(numSamples);
+	const float* egressData = audioData;
+	int32 egressSamples = numSamples;
+	if (inNumChannels != numChannels)
+	{
+		const int32 numFrames = numSamples / inNumChannels;
+		if (m_downmixBuffer.Num() < numFrames * numChannels)
+		{
+			m_downmixBuffer.SetNumUninitialized(numFrames * numChannels);
+		}
 
-	for (int i = 0; i < numSamples; i++)
+		m_downmix.Process(audioData, numFrames, m_downmixBuffer.GetData());
+		egressData = m_downmixBuffer.GetData();
+		egressSamples = numFrames * numChannels;
+	}
+
+	if (!m_resampler.IsConfiguredFor(inSampleRate, SAMPLE_RATE, numChannels))
+	{
+		if (inSampleRate == m_unsupportedSampleRate)
+		{
+			return;
+		}
+
+		if (!m_resampler.Configure(inSampleRate, SAMPLE_RATE, numChannels))
+		{
+			UE_LOG(LogHMD, Display, TEXT("Can not resample audio from %d Hz to %d Hz, will not stream audio."),
+				   inSampleRate, SAMPLE_RATE);
+			m_unsupportedSampleRate = inSampleRate;
+			return;
+		}
+		m_unsupportedSampleRate = 0;
+	}
+
+	if (!m_resampler.IsPassthrough())
 	{
-		int32 value = audioData[i] >= 0 ? audioData[i] * int32(MAX_int16) : audioData[i] * (int32(MAX_int16) + 1);
-		pcmData[i] = static_cast<int16_t>(FMath::Clamp(value, int32(MIN_int16), int32(MAX_int16)));
+		const int32 numFrames = egressSamples / numChannels;
+		const int32 maxSamples = m_resampler.GetMaxOutputFrames(numFrames) * numChannels;
+		if (m_resampleBuffer.Num() < maxSamples)
+		{
+			m_resampleBuffer.SetNumUninitialized(maxSamples);
+		}
+
+		egressSamples = m_resampler.Process(egressData, numFrames, m_resampleBuffer.GetData()) * numChannels;
+		egressData = m_resampleBuffer.GetData();
 	}
 
-	m_carryBuffer.Append(reinterpret_cast<const int16_t*>(pcmData.GetData()), numSamples);
+	// Convert straight into the ring, no intermediate buffer
+	m_carryBuffer.WriteWith(egressSamples, [egressData](int16_t* destination, uint32 offset, uint32 count) {
+		stream::audio::FloatToPcm16(egressData + offset, destination, count);
+	});
 	m_newDataCv.notify_all();
 }
 
+void FStreamAudioListener::UpdateDriftEstimate(double audioClock)
+{
+	const double now = FPlatformTime::Seconds();
+	if (m_resetClockOrigin.exchange(false) || audioClock < m_clockOriginAudio)
+	{
+		m_clockOriginWall = now;
+		m_clockOriginAudio = audioClock;
+		m_driftPpm = 0.0;
+		return;
+	}
+
+	// Compare the whole span since the origin, callback jitter averages out the longer the session runs
+	const double wallElapsed = now - m_clockOriginWall;
+	if (wallElapsed < DRIFT_WARMUP_SECONDS)
+	{
+		return;
+	}
+
+	const double audioElapsed = audioClock - m_clockOriginAudio;
+	const double driftPpm = (audioElapsed - wallElapsed) / wallElapsed * 1e6;
+	m_driftPpm.store(FMath::Clamp(driftPpm, -MAX_DRIFT_PPM, MAX_DRIFT_PPM), std::memory_order_relaxed);
+}
+
+int FStreamAudioListener::ComputeCorrectionFrames(int queuedFrames, int targetFrames)
+{
+	// Feed forward: a fast audio clock grows the queue, so read more frames than a packet holds
+	m_driftFrameAccumulator += m_driftPpm.load(std::memory_order_relaxed) * 1e-6 * BUFFER_SIZE;
+	int correction = static_cast<int>(m_driftFrameAccumulator);
+	m_driftFrameAccumulator -= correction;
+
+	// Feedback: pull the queue back once it leaves the tolerance band around the target
+	const int error = queuedFrames - targetFrames;
+	if (FMath::Abs(error) > LATENCY_TOLERANCE_FRAMES)
+	{
+		correction += error / 16;
+	}
+
+	return FMath::Clamp(correction, -MAX_CORRECTION_FRAMES, MAX_CORRECTION_FRAMES);
+}
+
+void FStreamAudioListener::ResamplePacket(int inputFrames, int numChannels)
+{
+	// Linear interpolation over a handful of frames per packet, both ends of the packet stay in place
+	const float step = float(inputFrames - 1) / float(BUFFER_SIZE - 1);
+	for (int frame = 0; frame < BUFFER_SIZE; frame++)
+	{
+		const float position = frame * step;
+		const int index = FMath::Min(static_cast<int>(position), inputFrames - 2);
+		const float alpha = position - index;
+		for (int channel = 0; channel < numChannels; channel++)
+		{
+			const float first = m_stretchBuffer[index * numChannels + channel];
+			const float second = m_stretchBuffer[(index + 1) * numChannels + channel];
+			m_packetBuffer[frame * numChannels + channel] = static_cast<int16_t>(FMath::RoundToInt(FMath::Lerp(first, second, alpha)));
+		}
+	}
+}
+
+bool FStreamAudioListener::ShouldPushPacket(int numChannels)
+{
+	if (CVarStreamAudioSilenceGate.GetValueOnAnyThread() == 0)
+	{
+		m_silentPackets = 0;
+		return true;
+	}
+
+	const int numSamples = BUFFER_SIZE * numChannels;
+	int32 peak = 0;
+	int64 energy = 0;
+	for (int i = 0; i < numSamples; i++)
+	{
+		const int32 sample = m_packetBuffer[i];
+		peak = FMath::Max(peak, FMath::Abs(sample));
+		energy += sample * sample;
+	}
+
+	// Opens on the peak so transients get through right away, closes on the energy so it does not chatter on a
+	// decaying signal. Levels between both thresholds keep the gate as it is.
+	const float openLevel = float(MAX_int16) * FMath::Pow(10.0f, CVarStreamAudioSilenceThreshold.GetValueOnAnyThread() / 20.0f);
+	const float closeLevel = openLevel * 0.5f;
+	if (peak > openLevel)
+	{
+		m_silentPackets = 0;
+	}
+	else if (FMath::Sqrt(float(energy) / numSamples) < closeLevel)
+	{
+		m_silentPackets = FMath::Min(m_silentPackets + 1, SILENCE_HANGOVER_PACKETS);
+	}
+
+	if (m_silentPackets < SILENCE_HANGOVER_PACKETS)
+	{
+		m_packetsSinceKeepalive = 0;
+		return true;
+	}
+
+	const int keepaliveMs = CVarStreamAudioSilenceKeepalive.GetValueOnAnyThread();
+	// Counted in packets, so neither large intervals nor long silences overflow
+	const int64 keepalivePackets = FMath::DivideAndRoundUp(int64(keepaliveMs) * SAMPLE_RATE, int64(BUFFER_SIZE) * 1000);
+	if (keepaliveMs <= 0 || ++m_packetsSinceKeepalive < keepalivePackets)
+	{
+		return false;
+	}
+
+	m_packetsSinceKeepalive = 0;
+	if (CVarStreamAudioComfortNoise.GetValueOnAnyThread() != 0)
+	{
+		// A couple of LSB of white noise, around -84 dBFS
+		for (int i = 0; i < numSamples; i++)
+		{
+			m_noiseSeed = m_noiseSeed * 1664525u + 1013904223u;
+			m_packetBuffer[i] = static_cast<int16_t>(int32((m_noiseSeed >> 16) % 5) - 2);
+		}
+	}
+	else
+	{
+		FMemory::Memzero(m_packetBuffer.data(), numSamples * sizeof(int16_t));
+	}
+	return true;
+}
+
 void FStreamAudioListener::PushCarryBuffer()
 {
+	using Clock = std::chrono::steady_clock;
+	constexpr auto packetDuration = std::chrono::microseconds(1000000LL * BUFFER_SIZE / SAMPLE_RATE);
+
+	Clock::time_point nextPush = Clock::now();
+	bool buffering = true;
+
 	while (m_isRunning)
 	{
-		if (m_carryBuffer.Num() < BUFFER_SIZE * m_numChannels)
+		const int numChannels = m_numChannels;
+		const int targetFrames =
+			FMath::Min(FMath::Max(CVarStreamAudioTargetLatency.GetValueOnAnyThread(), 0) * SAMPLE_RATE / 1000 +
+						   BUFFER_SIZE + MAX_CORRECTION_FRAMES,
+					   int(RING_BUFFER_CAPACITY) / numChannels - BUFFER_SIZE);
+
+		if (!m_connected)
 		{
+			// Do not send stale audio once a new client connects
+			m_carryBuffer.Reset();
+			buffering = true;
+			m_silentPackets = 0;
 			std::unique_lock lock(m_newDataMutex);
-			m_newDataCv.wait(lock);
+			m_newDataCv.wait_for(lock, packetDuration, [this] { return !m_isRunning || m_connected; });
 			continue;
 		}
 
-		isar::IsarAudioData audioData{
-		    .data = (void*)m_carryBuffer.GetData(),
-		    .bitsPerSample = BITS_PER_SAMPLE,
-		    .sampleRate = SAMPLE_RATE,
-		    .numberOfChannels = (size_t)m_numChannels,
-		    .samplesPerChannel = BUFFER_SIZE
-		};
-
-		auto err = m_serverApi->pushAudioData(m_streamConnection, audioData);
-		if (err != isar::IsarError::eNone) UE_LOG(LogTemp, Display, TEXT("Could not push audio data."));
-#if ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION > 3
-		m_carryBuffer.RemoveAt(0, BUFFER_SIZE * m_numChannels, EAllowShrinking::No);
-#else
-		m_carryBuffer.RemoveAt(0, BUFFER_SIZE * m_numChannels, false);
-#endif
+		if (buffering)
+		{
+			// Fill up to the latency target before pacing starts, otherwise the first packets underflow right away.
+			// The producer notifies without taking the mutex, so never wait longer than one packet to not miss a
+			// wakeup.
+			if (m_carryBuffer.Num() < uint32(targetFrames * numChannels))
+			{
+				std::unique_lock lock(m_newDataMutex);
+				m_newDataCv.wait_for(lock, packetDuration, [this, targetFrames, numChannels] {
+					return !m_isRunning || m_carryBuffer.Num() >= uint32(targetFrames * numChannels);
+				});
+				continue;
+			}
+
+			buffering = false;
+			nextPush = Clock::now();
+		}
+
+		{
+			// Pace packets on the platform clock, the producer waking us up early must not release a packet
+			std::unique_lock lock(m_newDataMutex);
+			m_newDataCv.wait_until(lock, nextPush, [this] { return !m_isRunning.load(); });
+		}
+		if (!m_isRunning)
+		{
+			break;
+		}
+
+		nextPush += packetDuration;
+		if (Clock::now() - nextPush > 4 * packetDuration)
+		{
+			// Do not burst out packets to catch up after the thread was starved
+			nextPush = Clock::now();
+		}
+
+		const int queuedFrames = m_carryBuffer.Num() / numChannels;
+		const int correction = ComputeCorrectionFrames(queuedFrames, targetFrames);
+		const int readFrames = BUFFER_SIZE + correction;
+		int16_t* readTarget = correction == 0 ? m_packetBuffer.data() : m_stretchBuffer.data();
+		if (!m_carryBuffer.Read(readTarget, readFrames * numChannels))
+		{
+			buffering = true;
+			continue;
+		}
+
+		if (correction != 0)
+		{
+			ResamplePacket(readFrames, numChannels);
+			(correction > 0 ? m_skippedPackets : m_stretchedPackets).fetch_add(1, std::memory_order_relaxed);
+		}
+
+		const bool pushPacket = ShouldPushPacket(numChannels);
+		if (pushPacket)
+		{
+			isar::IsarAudioData audioData{
+			    .data = (void*)m_packetBuffer.data(),
+			    .bitsPerSample = BITS_PER_SAMPLE,
+			    .sampleRate = SAMPLE_RATE,
+			    .numberOfChannels = (size_t)numChannels,
+			    .samplesPerChannel = BUFFER_SIZE
+			};
+
+			auto err = m_serverApi->pushAudioData(m_streamConnection, audioData);
+			if (err != isar::IsarError::eNone) UE_LOG(LogTemp, Display, TEXT("Could not push audio data."));
+		}
+		else
+		{
+			m_suppressedPackets.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		// The oldest frame of this packet spent the whole queue depth waiting to be pushed
+		const double queueDepthMs = 1000.0 * queuedFrames / SAMPLE_RATE;
+		const double avOffsetMs = queueDepthMs - 1000.0 * m_videoLatencySeconds.load(std::memory_order_relaxed);
+		m_queueDepthMs.store(queueDepthMs, std::memory_order_relaxed);
+		m_avOffsetMs.store(avOffsetMs, std::memory_order_relaxed);
+		CSV_CUSTOM_STAT(StreamAudio, QueueDepthMs, static_cast<float>(queueDepthMs), ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(StreamAudio, AvOffsetMs, static_cast<float>(avOffsetMs), ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(StreamAudio, CorrectionFrames, correction, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(StreamAudio, SuppressedPackets, int32(!pushPacket), ECsvCustomStatOp::Accumulate);
 	}
 }
\ No newline at end of file
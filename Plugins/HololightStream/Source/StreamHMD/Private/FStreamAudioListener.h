@@ -9,16 +9,39 @@
 
 #include "ISubmixBufferListener.h"
 
+#include "StreamAudioDownmix.h"
+#include "StreamAudioResampler.h"
+#include "StreamAudioRingBuffer.h"
+
+#include <array>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
 #include <atomic>
 
+struct FStreamAudioStats
+{
+	// Positive when the audio being pushed is older than the last pushed video frame
+	double avOffsetMs = 0.0;
+	double queueDepthMs = 0.0;
+	// Rate of the audio clock relative to the platform clock, positive when audio runs fast
+	double driftPpm = 0.0;
+	uint64 stretchedPackets = 0;
+	uint64 skippedPackets = 0;
+	uint64 overflowSamples = 0;
+	uint64 underflowCount = 0;
+	uint64 suppressedPackets = 0;
+};
 
 /// <summary>
 /// Implements the Unreal Engine Submix Buffer Listener interface, which can be subscribed to the engine for listening
 /// the audio generated by the game. This class is responsible of receiving the audio, queueing the audio data
-/// into a buffer and sending the data to the Server API in required sample rate.
+/// into a buffer and sending the data to the Server API in required sample rate. Multichannel submixes are mixed down
+/// to at most MAX_NUM_CHANNELS and audio mixed at any other rate is resampled to SAMPLE_RATE before it is queued.
+/// Packets are pushed on the platform clock the video frames are timed with. The drift of the audio clock against it
+/// is estimated from the submix audio clock and compensated by stretching or skipping a few frames per packet, so the
+/// queue stays around the latency target. Silent packets are not pushed, optionally a keepalive packet is sent at a
+/// low rate while the silence lasts.
 /// </summary>
 class FStreamAudioListener : public ISubmixBufferListener
 {
@@ -28,6 +51,10 @@ public:
 
 	void SetStreamApi(isar::IsarConnection connection, isar::IsarServerApi* serverApi);
 	void SetConnected(bool connected);
+	// Called after a video frame was pushed, with the time between its pose being received and the push
+	void OnVideoFrameSubmitted(double videoLatencySeconds);
+
+	FStreamAudioStats GetStats() const;
 
 	// ISubmixBufferListener interface
 	void OnNewSubmixBuffer(const USoundSubmix* owningSubmix, float* audioData, int32 numSamples,
@@ -37,17 +64,47 @@ public:
 	static constexpr int SAMPLE_RATE = 48000;
 	static constexpr int BUFFER_SIZE = 480;
 	static constexpr int BITS_PER_SAMPLE = 16;
+	// Around 340 ms of stereo audio, enough to ride out scheduling hiccups of the push thread
+	static constexpr uint32 RING_BUFFER_CAPACITY = 1 << 15;
+	// Upper bound of frames added or dropped per packet, 2.5% is not audible as a pitch change
+	static constexpr int MAX_CORRECTION_FRAMES = 12;
+	// Packets of silence after which the gate closes, keeps reverb tails and short pauses in speech intact
+	static constexpr int SILENCE_HANGOVER_PACKETS = 20;
 
 private:
-	bool m_connected;
+	std::atomic<bool> m_connected;
 	isar::IsarConnection m_streamConnection;
 	isar::IsarServerApi* m_serverApi;
 
-	int m_numChannels = 2;
+	std::atomic<int> m_numChannels = 2;
+
+	// Only touched by the audio render thread
+	stream::audio::FStreamAudioDownmix m_downmix;
+	TArray<float> m_downmixBuffer;
+	stream::audio::FStreamAudioResampler m_resampler;
+	TArray<float> m_resampleBuffer;
+	int32 m_unsupportedSampleRate = 0;
+	double m_clockOriginWall = 0.0;
+	double m_clockOriginAudio = 0.0;
+	std::atomic<bool> m_resetClockOrigin = true;
+	std::atomic<double> m_driftPpm = 0.0;
+
+	// Written by the audio render thread, read by the push thread
+	stream::audio::FStreamAudioRingBuffer m_carryBuffer;
+	// Only touched by the push thread
+	std::array<int16_t, BUFFER_SIZE * MAX_NUM_CHANNELS> m_packetBuffer;
+	std::array<int16_t, (BUFFER_SIZE + MAX_CORRECTION_FRAMES) * MAX_NUM_CHANNELS> m_stretchBuffer;
+	double m_driftFrameAccumulator = 0.0;
+	int m_silentPackets = 0;
+	int64 m_packetsSinceKeepalive = 0;
+	uint32 m_noiseSeed = 1;
 
-	// Upon trials, it is seen that TArray is safe for removing from the beginning and appending to the end on different
-	// threads without a mutex, and usage of a mutex creates issues with audio timings
-	TArray<int16_t> m_carryBuffer;
+	std::atomic<double> m_videoLatencySeconds = 0.0;
+	std::atomic<double> m_avOffsetMs = 0.0;
+	std::atomic<double> m_queueDepthMs = 0.0;
+	std::atomic<uint64> m_stretchedPackets = 0;
+	std::atomic<uint64> m_skippedPackets = 0;
+	std::atomic<uint64> m_suppressedPackets = 0;
 
 	std::thread m_pushThread;
 	std::atomic<bool> m_isRunning;
@@ -55,6 +112,10 @@ private:
 	std::condition_variable m_newDataCv;
 
 	void PushCarryBuffer();
+	void UpdateDriftEstimate(double audioClock);
+	int ComputeCorrectionFrames(int queuedFrames, int targetFrames);
+	void ResamplePacket(int inputFrames, int numChannels);
+	bool ShouldPushPacket(int numChannels);
 };
 
 #endif // HOLOLIGHT_UNREAL_FSTREAMAUDIOLISTENER_H
\ No newline at end of file
@@ -0,0 +1,44 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#include "FStreamClientClock.h"
+
+FStreamClientClock::FStreamClientClock() : m_valid(false),
+										   m_offset(0.0),
+										   m_lastPoseTimestamp(0),
+										   m_lastPullTime(0.0)
+{
+}
+
+void FStreamClientClock::Reset()
+{
+	FScopeLock lock(&m_lock);
+	m_valid = false;
+}
+
+void FStreamClientClock::OnPosePulled(int64 poseTimestamp, double pullTime)
+{
+	FScopeLock lock(&m_lock);
+	const double offset = pullTime - PoseTimestampToSeconds(poseTimestamp);
+	// The game and render thread pull concurrently, so a pose may come in just after a newer one. Only a large step
+	// back is a new client clock.
+	if (!m_valid || PoseTimestampToSeconds(m_lastPoseTimestamp - poseTimestamp) > CLOCK_RESTART_SECONDS)
+	{
+		m_valid = true;
+		m_offset = offset;
+	}
+	else
+	{
+		// A pose pulled again or late only raises the sample, the smallest one is the closest to its arrival
+		m_offset = FMath::Min(offset, m_offset + OFFSET_DECAY_PER_SECOND * FMath::Max(pullTime - m_lastPullTime, 0.0));
+	}
+	m_lastPoseTimestamp = FMath::Max(poseTimestamp, m_lastPoseTimestamp);
+	m_lastPullTime = FMath::Max(pullTime, m_lastPullTime);
+}
+
+double FStreamClientClock::ToPlatformTime(int64 poseTimestamp) const
+{
+	FScopeLock lock(&m_lock);
+	return m_valid ? PoseTimestampToSeconds(poseTimestamp) + m_offset : 0.0;
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#ifndef HOLOLIGHT_UNREAL_FSTREAMCLIENTCLOCK_H
+#define HOLOLIGHT_UNREAL_FSTREAMCLIENTCLOCK_H
+
+#include "StreamHMDCommon.h"
+
+/// <summary>
+/// Maps the pose timestamps of the client clock to platform time. The clocks are unrelated, the offset between them
+/// is the smallest difference seen between the time a pose was pulled and the time the client created it. That is the
+/// pose that arrived with the least network delay and was pulled right after, so a mapped time is when the pose
+/// arrived at the earliest. The offset may rise slowly to follow drift between the clocks, and starts over when the
+/// client clock goes backwards, e.g. after the client restarted.
+/// All times are passed in, in seconds, so recorded poses can be replayed.
+/// </summary>
+class FStreamClientClock
+{
+public:
+	FStreamClientClock();
+
+	// Any thread, the next pose starts a new mapping
+	void Reset();
+	// Any thread, called for every pulled pose, also the ones pulled again
+	void OnPosePulled(int64 poseTimestamp, double pullTime);
+	// Any thread, returns zero before the first pose
+	double ToPlatformTime(int64 poseTimestamp) const;
+
+private:
+	// Lets the offset rise by 0.2 ms per second, so a client clock running up to 200 ppm slower than ours is followed
+	static constexpr double OFFSET_DECAY_PER_SECOND = 0.0002;
+	// A pose this much older than the newest one comes from a new client clock
+	static constexpr double CLOCK_RESTART_SECONDS = 1.0;
+
+	mutable FCriticalSection m_lock;
+	bool m_valid;
+	double m_offset;
+	int64 m_lastPoseTimestamp;
+	double m_lastPullTime;
+};
+
+#endif // HOLOLIGHT_UNREAL_FSTREAMCLIENTCLOCK_H
\ No newline at end of file
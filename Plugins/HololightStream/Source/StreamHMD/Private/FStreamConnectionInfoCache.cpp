@@ -0,0 +1,78 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#include "FStreamConnectionInfoCache.h"
+
+FStreamConnectionInfoCache::FStreamConnectionInfoCache() : m_sequence(0)
+{
+	for (std::atomic<uint64>& word : m_words)
+	{
+		word.store(0, std::memory_order_relaxed);
+	}
+}
+
+isar::IsarConnectionInfo FStreamConnectionInfoCache::Refresh(const isar::IsarServerApi& serverApi,
+															 isar::IsarConnection connection)
+{
+	isar::IsarConnectionInfo info = {};
+	serverApi.getConnectionInfo(connection, &info);
+
+	FPublished published = {};
+	published.info = info;
+	published.info.remoteName = nullptr;
+	if (info.remoteName)
+	{
+		FCStringAnsi::Strncpy(published.remoteName, info.remoteName, UE_ARRAY_COUNT(published.remoteName));
+	}
+
+	uint64 words[NUM_WORDS] = {};
+	FMemory::Memcpy(words, &published, sizeof(published));
+
+	const uint32 sequence = m_sequence.load(std::memory_order_relaxed);
+	m_sequence.store(sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	for (int32 index = 0; index < NUM_WORDS; index++)
+	{
+		m_words[index].store(words[index], std::memory_order_relaxed);
+	}
+	m_sequence.store(sequence + 2, std::memory_order_release);
+	return info;
+}
+
+bool FStreamConnectionInfoCache::Get(FStreamConnectionInfoSnapshot& outInfo) const
+{
+	uint64 words[NUM_WORDS];
+	uint32 sequence;
+	for (;;)
+	{
+		sequence = m_sequence.load(std::memory_order_acquire);
+		if (sequence & 1)
+		{
+			// A refresh is writing, it only copies a few words
+			FPlatformProcess::Yield();
+			continue;
+		}
+
+		for (int32 index = 0; index < NUM_WORDS; index++)
+		{
+			words[index] = m_words[index].load(std::memory_order_relaxed);
+		}
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (m_sequence.load(std::memory_order_relaxed) == sequence)
+		{
+			break;
+		}
+	}
+
+	if (sequence == 0)
+	{
+		return false;
+	}
+	FPublished published;
+	FMemory::Memcpy(&published, words, sizeof(published));
+	static_cast<isar::IsarConnectionInfo&>(outInfo) = published.info;
+	FMemory::Memcpy(outInfo.remoteNameStorage, published.remoteName, sizeof(published.remoteName));
+	outInfo.remoteName = outInfo.remoteNameStorage;
+	return true;
+}
\ No newline at end of file
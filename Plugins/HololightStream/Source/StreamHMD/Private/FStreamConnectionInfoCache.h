@@ -0,0 +1,69 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#ifndef HOLOLIGHT_UNREAL_FSTREAMCONNECTIONINFOCACHE_H
+#define HOLOLIGHT_UNREAL_FSTREAMCONNECTIONINFOCACHE_H
+
+#include "StreamHMDCommon.h"
+
+#include <atomic>
+
+/// <summary>
+/// Connection info that keeps its own copy of the remote name. ISAR only lends out the string, the pointer may dangle
+/// once ISAR updates its copy, so remoteName points into this object instead and it can not be copied.
+/// </summary>
+struct FStreamConnectionInfoSnapshot : isar::IsarConnectionInfo
+{
+	// Longer names are truncated
+	static constexpr int32 REMOTE_NAME_CAPACITY = 256;
+
+	FStreamConnectionInfoSnapshot() : isar::IsarConnectionInfo()
+	{
+		remoteNameStorage[0] = '\0';
+		remoteName = remoteNameStorage;
+	}
+
+	FStreamConnectionInfoSnapshot(const FStreamConnectionInfoSnapshot&) = delete;
+	FStreamConnectionInfoSnapshot& operator=(const FStreamConnectionInfoSnapshot&) = delete;
+
+	ANSICHAR remoteNameStorage[REMOTE_NAME_CAPACITY];
+};
+
+/// <summary>
+/// Holds the connection info ISAR reported when the connection was established, so per frame code on any thread
+/// reads it without calling into ISAR, which may be updating its own copy while encoding. The info is published
+/// through a sequence lock: readers copy it and retry if a refresh ran meanwhile, they never block or allocate. The
+/// remote name is copied along with it. Only the connection state callback refreshes it, so there is a single writer.
+/// </summary>
+class FStreamConnectionInfoCache
+{
+public:
+	FStreamConnectionInfoCache();
+
+	FStreamConnectionInfoCache(const FStreamConnectionInfoCache&) = delete;
+	FStreamConnectionInfoCache& operator=(const FStreamConnectionInfoCache&) = delete;
+
+	// Connection state callback, queries ISAR and publishes the result. The returned remote name is the one ISAR lent
+	// out, only valid during the callback.
+	isar::IsarConnectionInfo Refresh(const isar::IsarServerApi& serverApi, isar::IsarConnection connection);
+	// Any thread, returns false until the first refresh
+	bool Get(FStreamConnectionInfoSnapshot& outInfo) const;
+
+private:
+	// What the words hold, the info without its remote name pointer followed by the name itself
+	struct FPublished
+	{
+		isar::IsarConnectionInfo info;
+		ANSICHAR remoteName[FStreamConnectionInfoSnapshot::REMOTE_NAME_CAPACITY];
+	};
+
+	static constexpr int32 NUM_WORDS = (sizeof(FPublished) + sizeof(uint64) - 1) / sizeof(uint64);
+
+	// Odd while a refresh writes the words, zero before the first one
+	std::atomic<uint32> m_sequence;
+	// The info is copied word by word with atomics, a reader racing a refresh sees a torn copy and retries
+	std::atomic<uint64> m_words[NUM_WORDS];
+};
+
+#endif // HOLOLIGHT_UNREAL_FSTREAMCONNECTIONINFOCACHE_H
\ No newline at end of file
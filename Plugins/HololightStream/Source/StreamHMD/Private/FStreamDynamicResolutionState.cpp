@@ -0,0 +1,87 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#include "FStreamDynamicResolutionState.h"
+
+#include "LegacyScreenPercentageDriver.h"
+#include "SceneView.h"
+
+FStreamDynamicResolutionState::FStreamDynamicResolutionState() : m_enabled(true),
+																 m_resolutionFraction(1.0f),
+																 m_maxResolutionFraction(1.0f)
+{
+}
+
+void FStreamDynamicResolutionState::SetResolutionFraction(float fraction, float maxFraction)
+{
+	check(IsInGameThread());
+	m_resolutionFraction = fraction;
+	m_maxResolutionFraction = FMath::Max(fraction, maxFraction);
+}
+
+bool FStreamDynamicResolutionState::IsSupported() const
+{
+	return true;
+}
+
+void FStreamDynamicResolutionState::ResetHistory()
+{
+	// The controller keeps the history, it is reset with the connection
+}
+
+void FStreamDynamicResolutionState::SetEnabled(bool enable)
+{
+	check(IsInGameThread());
+	m_enabled = enable;
+}
+
+bool FStreamDynamicResolutionState::IsEnabled() const
+{
+	return m_enabled;
+}
+
+DynamicRenderScaling::TMap<float> FStreamDynamicResolutionState::GetResolutionFractionsApproximation() const
+{
+	DynamicRenderScaling::TMap<float> resolutionFractions;
+	resolutionFractions.SetAll(1.0f);
+	resolutionFractions[GDynamicPrimaryResolutionFraction] = m_resolutionFraction;
+	return resolutionFractions;
+}
+
+DynamicRenderScaling::TMap<float> FStreamDynamicResolutionState::GetResolutionFractionsUpperBound() const
+{
+	DynamicRenderScaling::TMap<float> resolutionFractions;
+	resolutionFractions.SetAll(1.0f);
+	resolutionFractions[GDynamicPrimaryResolutionFraction] = m_maxResolutionFraction;
+	return resolutionFractions;
+}
+
+void FStreamDynamicResolutionState::SetupMainViewFamily(FSceneViewFamily& viewFamily)
+{
+	check(IsInGameThread());
+	if (!m_enabled || !viewFamily.EngineShowFlags.ScreenPercentage)
+	{
+		return;
+	}
+
+	// The same static screen percentage the viewport would set up without dynamic resolution, scaled by the stream
+	FStaticResolutionFractionHeuristic staticHeuristic(viewFamily.EngineShowFlags);
+	staticHeuristic.Settings.PullRunTimeRenderingSettings(EViewStatusForScreenPercentage::VR);
+	staticHeuristic.PullViewFamilyRenderingSettings(viewFamily);
+	const float staticFraction = staticHeuristic.ResolveResolutionFraction();
+	const float staticUpperBound = staticHeuristic.ResolveResolutionFractionUpperBound();
+
+	const float resolutionFraction = FMath::Clamp(staticFraction * m_resolutionFraction,
+												  FSceneViewScreenPercentageConfig::kMinResolutionFraction,
+												  FSceneViewScreenPercentageConfig::kMaxResolutionFraction);
+	const float upperBound = FMath::Clamp(staticUpperBound * m_maxResolutionFraction, resolutionFraction,
+										  FSceneViewScreenPercentageConfig::kMaxResolutionFraction);
+	viewFamily.SetScreenPercentageInterface(new FLegacyScreenPercentageDriver(viewFamily, resolutionFraction,
+																			  upperBound));
+}
+
+void FStreamDynamicResolutionState::ProcessEvent(EDynamicResolutionStateEvent event)
+{
+	// The controller is updated once per game frame by the HMD, which also gathers the GPU time it needs
+}
\ No newline at end of file
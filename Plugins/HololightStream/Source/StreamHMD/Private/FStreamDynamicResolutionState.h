@@ -0,0 +1,43 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#ifndef HOLOLIGHT_UNREAL_FSTREAMDYNAMICRESOLUTIONSTATE_H
+#define HOLOLIGHT_UNREAL_FSTREAMDYNAMICRESOLUTIONSTATE_H
+
+#include "CoreMinimal.h"
+#include "DynamicResolutionState.h"
+
+/// <summary>
+/// Hands the fraction picked by FStreamResolutionController to the engine's dynamic resolution, which sets up the
+/// screen percentage of the main view family only. Scene captures and other view families keep their own, and the
+/// static screen percentage (r.ScreenPercentage, vr.PixelDensity) is scaled instead of replaced.
+/// Installed through UEngine::ChangeDynamicResolutionStateAtNextFrame while vr.StreamDynamicResolution is on, the
+/// engine only uses it while r.DynamicRes.OperationMode enables dynamic resolution. Game thread only.
+/// </summary>
+class FStreamDynamicResolutionState : public IDynamicResolutionState
+{
+public:
+	FStreamDynamicResolutionState();
+
+	void SetResolutionFraction(float fraction, float maxFraction);
+
+	// IDynamicResolutionState
+	bool IsSupported() const override;
+	void ResetHistory() override;
+	void SetEnabled(bool enable) override;
+	bool IsEnabled() const override;
+	DynamicRenderScaling::TMap<float> GetResolutionFractionsApproximation() const override;
+	DynamicRenderScaling::TMap<float> GetResolutionFractionsUpperBound() const override;
+	void SetupMainViewFamily(FSceneViewFamily& viewFamily) override;
+
+protected:
+	void ProcessEvent(EDynamicResolutionStateEvent event) override;
+
+private:
+	bool m_enabled;
+	float m_resolutionFraction;
+	float m_maxResolutionFraction;
+};
+
+#endif // HOLOLIGHT_UNREAL_FSTREAMDYNAMICRESOLUTIONSTATE_H
\ No newline at end of file
@@ -0,0 +1,30 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#include "FStreamFenceTimeline.h"
+
+#include "RHICommandList.h"
+
+#if PLATFORM_WINDOWS
+#include "ID3D12DynamicRHI.h"
+#endif
+
+#include <d3d12.h>
+
+FStreamD3D12FenceTimeline::FStreamD3D12FenceTimeline(ID3D12Fence* fence)
+	: m_fence(fence)
+{
+	check(m_fence);
+}
+
+uint64 FStreamD3D12FenceTimeline::GetCompletedValue() const
+{
+	return m_fence->GetCompletedValue();
+}
+
+void FStreamD3D12FenceTimeline::EnqueueSignal(FRHICommandList& rhiCmdList, uint64 value)
+{
+	// Signals on the RHI graphics queue once everything recorded before it has been submitted and executed
+	GetID3D12DynamicRHI()->RHISignalManualFence(rhiCmdList, m_fence, value);
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#ifndef HOLOLIGHT_UNREAL_FSTREAMFENCETIMELINE_H
+#define HOLOLIGHT_UNREAL_FSTREAMFENCETIMELINE_H
+
+#include "CoreMinimal.h"
+
+#include <atomic>
+
+class FRHICommandList;
+struct ID3D12Fence;
+
+/// <summary>
+/// Monotonic GPU timeline the encoder waits on before it reads a frame. Every Signal hands out the next value and
+/// enqueues its signal behind all work recorded on the command list so far, so a value is only completed once the
+/// frame it was signaled for has finished rendering. Backends only implement how a value is signaled and read back.
+/// </summary>
+class FStreamFenceTimeline
+{
+public:
+	virtual ~FStreamFenceTimeline() = default;
+
+	// Render thread. Returns the value that completes once the work recorded before this call has executed.
+	uint64 Signal(FRHICommandList& rhiCmdList)
+	{
+		const uint64 value = m_lastSignaledValue.fetch_add(1, std::memory_order_relaxed) + 1;
+		EnqueueSignal(rhiCmdList, value);
+		return value;
+	}
+
+	uint64 GetLastSignaledValue() const { return m_lastSignaledValue.load(std::memory_order_relaxed); }
+	virtual uint64 GetCompletedValue() const = 0;
+
+protected:
+	virtual void EnqueueSignal(FRHICommandList& rhiCmdList, uint64 value) = 0;
+
+private:
+	// Fences start out completed at zero, so the first signaled value is one
+	std::atomic<uint64> m_lastSignaledValue{0};
+};
+
+/// <summary>
+/// Fence timeline on the D3D12 RHI graphics queue, which is the queue passed to ISAR on connection creation.
+/// </summary>
+class FStreamD3D12FenceTimeline : public FStreamFenceTimeline
+{
+public:
+	// The fence stays owned by the caller and has to outlive the timeline
+	explicit FStreamD3D12FenceTimeline(ID3D12Fence* fence);
+
+	uint64 GetCompletedValue() const override;
+
+protected:
+	void EnqueueSignal(FRHICommandList& rhiCmdList, uint64 value) override;
+
+private:
+	ID3D12Fence* m_fence;
+};
+
+#endif // HOLOLIGHT_UNREAL_FSTREAMFENCETIMELINE_H
\ No newline at end of file
@@ -0,0 +1,402 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#include "FStreamFocusPlaneProvider.h"
+
+#include "RHIGPUReadback.h"
+#include "RenderGraphUtils.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+
+static TAutoConsoleVariable<float> CVarStreamFocusPlaneSmoothingTime(
+	TEXT("vr.StreamFocusPlaneSmoothingTime"),
+	0.1f,
+	TEXT("Time constant in seconds the focus distance and velocity sent to the client are smoothed with.\n")
+	TEXT("0 disables smoothing."),
+	ECVF_RenderThreadSafe);
+
+static FVector ToVector(const XrVector3f& vector)
+{
+	return FVector(vector.x, vector.y, vector.z);
+}
+
+static isar::IsarVector3 ToIsarVector(const FVector& vector)
+{
+	return isar::IsarVector3{static_cast<float>(vector.X), static_cast<float>(vector.Y), static_cast<float>(vector.Z)};
+}
+
+FStreamFocusPlaneProvider::FStreamFocusPlaneProvider() : m_source(EStreamFocusPlaneSource::Automatic),
+														 m_gazeDistance(-1.0f),
+														 m_resetRequested(false),
+														 m_nextDepthReadback(0),
+														 m_depthDistance(-1.0f),
+														 m_depthTime(0.0),
+														 m_smoothedDistance(-1.0f),
+														 m_smoothedVelocity(FVector::ZeroVector),
+														 m_lastPoseTime(0.0),
+														 m_historyCount(0),
+														 m_historyHead(0)
+{
+}
+
+FStreamFocusPlaneProvider::~FStreamFocusPlaneProvider() = default;
+
+void FStreamFocusPlaneProvider::SetSource(EStreamFocusPlaneSource source)
+{
+	FScopeLock lock(&m_gameStateLock);
+	m_source = source;
+}
+
+EStreamFocusPlaneSource FStreamFocusPlaneProvider::GetSource() const
+{
+	FScopeLock lock(&m_gameStateLock);
+	return m_source;
+}
+
+void FStreamFocusPlaneProvider::SetTarget(const FVector& worldLocation)
+{
+	FScopeLock lock(&m_gameStateLock);
+	m_targetWorld = worldLocation;
+}
+
+void FStreamFocusPlaneProvider::ClearTarget()
+{
+	FScopeLock lock(&m_gameStateLock);
+	m_targetWorld.Reset();
+	m_targetTracking.Reset();
+}
+
+void FStreamFocusPlaneProvider::Update_GameThread(UWorld* world, const FTransform& trackingToWorld,
+												  const XrPosef& headPose, float worldToMeters, float farZ)
+{
+	check(IsInGameThread());
+
+	EStreamFocusPlaneSource source;
+	bool hasTarget;
+	{
+		FScopeLock lock(&m_gameStateLock);
+		source = m_source;
+		hasTarget = m_targetWorld.IsSet();
+		if (hasTarget)
+		{
+			// The target stays put in the world, so it moves in tracking space whenever the pawn does
+			const FVector targetTracking = trackingToWorld.InverseTransformPosition(m_targetWorld.GetValue());
+			m_targetTracking = ToVector(ToXrVector(targetTracking, worldToMeters));
+		}
+	}
+
+	float gazeDistance = -1.0f;
+	const bool traceGaze = source == EStreamFocusPlaneSource::Gaze ||
+		(source == EStreamFocusPlaneSource::Automatic && !hasTarget);
+	if (traceGaze && world)
+	{
+		const FTransform headWorld = ToFTransform(headPose, worldToMeters) * trackingToWorld;
+		const FVector traceStart = headWorld.GetLocation();
+		const FVector traceEnd = traceStart + headWorld.GetRotation().GetForwardVector() * farZ * worldToMeters;
+
+		FCollisionQueryParams queryParams(SCENE_QUERY_STAT(StreamFocusPlane), false);
+		// The head sits inside the pawn's collision, which would otherwise always be hit first
+		if (const APlayerController* playerController = world->GetFirstPlayerController())
+		{
+			queryParams.AddIgnoredActor(playerController->GetPawn());
+		}
+
+		FHitResult hit;
+		if (world->LineTraceSingleByChannel(hit, traceStart, traceEnd, ECC_Visibility, queryParams))
+		{
+			gazeDistance = hit.Distance / worldToMeters;
+		}
+	}
+
+	FScopeLock lock(&m_gameStateLock);
+	m_gazeDistance = gazeDistance;
+}
+
+bool FStreamFocusPlaneProvider::NeedsDepthEstimate() const
+{
+	FScopeLock lock(&m_gameStateLock);
+	switch (m_source)
+	{
+	case EStreamFocusPlaneSource::DepthHistogram:
+		return true;
+	case EStreamFocusPlaneSource::Automatic:
+		return !m_targetTracking.IsSet() && m_gazeDistance <= 0.0f;
+	default:
+		return false;
+	}
+}
+
+void FStreamFocusPlaneProvider::EnqueueDepthReadback(FRDGBuilder& graphBuilder, FRDGTexture* depthTexture,
+													 float nearZ, float farZ)
+{
+	check(IsInRenderingThread());
+
+	FDepthReadback& depthReadback = m_depthReadbacks[m_nextDepthReadback];
+	if (depthReadback.pending)
+	{
+		// The GPU is more than DEPTH_READBACK_COUNT frames behind, the estimate can wait for it
+		return;
+	}
+
+	if (!depthReadback.readback)
+	{
+		depthReadback.readback = MakeUnique<FRHIGPUTextureReadback>(TEXT("StreamFocusDepthReadback"));
+	}
+	AddEnqueueCopyPass(graphBuilder, depthReadback.readback.Get(), depthTexture);
+	depthReadback.nearZ = nearZ;
+	depthReadback.farZ = farZ;
+	depthReadback.pending = true;
+	m_nextDepthReadback = (m_nextDepthReadback + 1) % DEPTH_READBACK_COUNT;
+}
+
+void FStreamFocusPlaneProvider::ReadDepthReadbacks()
+{
+	// Oldest first, so the newest finished readback decides the estimate
+	for (int32 offset = 0; offset < DEPTH_READBACK_COUNT; offset++)
+	{
+		FDepthReadback& depthReadback = m_depthReadbacks[(m_nextDepthReadback + offset) % DEPTH_READBACK_COUNT];
+		if (!depthReadback.pending || !depthReadback.readback->IsReady())
+		{
+			continue;
+		}
+		depthReadback.pending = false;
+
+		const float nearZ = depthReadback.nearZ;
+		const float farZ = depthReadback.farZ;
+		int32 rowPitch = 0;
+		const float* pixels = static_cast<const float*>(depthReadback.readback->Lock(rowPitch));
+		if (!pixels || nearZ <= 0.0f || farZ <= nearZ)
+		{
+			if (pixels)
+			{
+				depthReadback.readback->Unlock();
+			}
+			continue;
+		}
+
+		// Bins are spaced logarithmically, a few centimeters matter up close but not at the far plane
+		float binWeights[DEPTH_HISTOGRAM_BINS] = {};
+		float binDepths[DEPTH_HISTOGRAM_BINS] = {};
+		const float logNearZ = FMath::Loge(nearZ);
+		const float logRange = FMath::Loge(farZ) - logNearZ;
+		const float center = (DEPTH_ESTIMATE_SIZE - 1) * 0.5f;
+		int32 coveredPixels = 0;
+		for (int32 y = 0; y < DEPTH_ESTIMATE_SIZE; y++)
+		{
+			for (int32 x = 0; x < DEPTH_ESTIMATE_SIZE; x++)
+			{
+				const float depth = pixels[y * rowPitch + x];
+				if (!(depth > 0.0f && depth < 1.0f))
+				{
+					// Sky and everything past the far plane
+					continue;
+				}
+
+				// Inverse of the depth encoding in StreamDepthPixelShader.usf
+				const float linearDepth = farZ * nearZ / (farZ - depth * (farZ - nearZ));
+				const int32 bin = FMath::Clamp(
+					static_cast<int32>((FMath::Loge(linearDepth) - logNearZ) / logRange * DEPTH_HISTOGRAM_BINS), 0,
+					DEPTH_HISTOGRAM_BINS - 1);
+
+				// Pixels toward the center of the view count up to twice as much, that is where the user most likely looks
+				const float dx = (x - center) / center;
+				const float dy = (y - center) / center;
+				const float weight = 1.0f - 0.5f * FMath::Min(dx * dx + dy * dy, 1.0f);
+				binWeights[bin] += weight;
+				binDepths[bin] += weight * linearDepth;
+				coveredPixels++;
+			}
+		}
+		depthReadback.readback->Unlock();
+
+		if (coveredPixels < DEPTH_MIN_COVERAGE * DEPTH_ESTIMATE_SIZE * DEPTH_ESTIMATE_SIZE)
+		{
+			m_depthDistance = -1.0f;
+			continue;
+		}
+
+		int32 peakBin = 0;
+		for (int32 bin = 1; bin < DEPTH_HISTOGRAM_BINS; bin++)
+		{
+			if (binWeights[bin] > binWeights[peakBin])
+			{
+				peakBin = bin;
+			}
+		}
+		m_depthDistance = binDepths[peakBin] / binWeights[peakBin];
+		m_depthTime = FPlatformTime::Seconds();
+	}
+}
+
+bool FStreamFocusPlaneProvider::ComputeFocusPlane_RenderThread(const XrPosef& headPose, double poseTime,
+															   isar::IsarFocusPlane& outPlane)
+{
+	check(IsInRenderingThread());
+
+	if (m_resetRequested.exchange(false) || (m_historyCount > 0 && poseTime < m_lastPoseTime))
+	{
+		// A pose older than the last one means the client restarted its clock
+		ResetRenderState();
+	}
+	ReadDepthReadbacks();
+
+	EStreamFocusPlaneSource source;
+	TOptional<FVector> target;
+	float gazeDistance;
+	{
+		FScopeLock lock(&m_gameStateLock);
+		source = m_source;
+		target = m_targetTracking;
+		gazeDistance = m_gazeDistance;
+	}
+
+	const bool useTarget = target.IsSet() &&
+		(source == EStreamFocusPlaneSource::Target || source == EStreamFocusPlaneSource::Automatic);
+	const bool useGaze = gazeDistance > 0.0f &&
+		(source == EStreamFocusPlaneSource::Gaze || source == EStreamFocusPlaneSource::Automatic);
+	const bool useDepth = m_depthDistance > 0.0f &&
+		FPlatformTime::Seconds() - m_depthTime < DEPTH_MAX_AGE_SECONDS &&
+		(source == EStreamFocusPlaneSource::DepthHistogram || source == EStreamFocusPlaneSource::Automatic);
+	if (!useTarget && !useGaze && !useDepth)
+	{
+		// The client falls back to its default plane, the next estimate should not be smoothed toward this one
+		ResetRenderState();
+		return false;
+	}
+
+	const FVector headPosition = ToVector(headPose.position);
+	const FVector forward = FQuat(headPose.orientation.x, headPose.orientation.y, headPose.orientation.z,
+								  headPose.orientation.w).RotateVector(FVector(0.0, 0.0, -1.0));
+	const double deltaTime = m_historyCount > 0 ? poseTime - m_lastPoseTime : 0.0;
+	const float alpha = m_historyCount > 0 ? GetSmoothingAlpha(deltaTime) : 1.0f;
+
+	FVector position;
+	FVector normal;
+	if (useTarget)
+	{
+		position = target.GetValue();
+		normal = (headPosition - position).GetSafeNormal(UE_SMALL_NUMBER, -forward);
+		// Keeps the distance continuous if the target is cleared and the gaze or depth takes over
+		m_smoothedDistance = FVector::Dist(headPosition, position);
+	}
+	else
+	{
+		const float distance = useGaze ? gazeDistance : m_depthDistance;
+		m_smoothedDistance = m_smoothedDistance > 0.0f
+			? FMath::Lerp(m_smoothedDistance, distance, alpha)
+			: distance;
+		// Only the distance is smoothed, the plane follows head rotation right away
+		position = headPosition + forward * m_smoothedDistance;
+		normal = -forward;
+	}
+
+	AddSample(position, poseTime);
+	m_smoothedVelocity = FMath::Lerp(m_smoothedVelocity, EstimateVelocity(poseTime), alpha);
+	m_lastPoseTime = poseTime;
+
+	outPlane.position = ToIsarVector(position);
+	outPlane.normal = ToIsarVector(normal);
+	outPlane.velocity = ToIsarVector(m_smoothedVelocity);
+	return true;
+}
+
+void FStreamFocusPlaneProvider::Reset()
+{
+	{
+		FScopeLock lock(&m_gameStateLock);
+		m_targetTracking.Reset();
+		m_gazeDistance = -1.0f;
+	}
+	m_resetRequested = true;
+}
+
+XrPosef FStreamFocusPlaneProvider::GetHeadPose(const TArray<XrView>& views)
+{
+	if (views.IsEmpty())
+	{
+		return ToXrPose(FTransform::Identity);
+	}
+
+	XrPosef headPose = views[0].pose;
+	if (views.Num() > 1)
+	{
+		headPose.position.x = (views[0].pose.position.x + views[1].pose.position.x) * 0.5f;
+		headPose.position.y = (views[0].pose.position.y + views[1].pose.position.y) * 0.5f;
+		headPose.position.z = (views[0].pose.position.z + views[1].pose.position.z) * 0.5f;
+	}
+	return headPose;
+}
+
+void FStreamFocusPlaneProvider::ResetRenderState()
+{
+	m_smoothedDistance = -1.0f;
+	m_smoothedVelocity = FVector::ZeroVector;
+	m_lastPoseTime = 0.0;
+	m_historyCount = 0;
+	m_historyHead = 0;
+}
+
+float FStreamFocusPlaneProvider::GetSmoothingAlpha(double deltaTime)
+{
+	const float smoothingTime = CVarStreamFocusPlaneSmoothingTime.GetValueOnRenderThread();
+	if (smoothingTime <= 0.0f)
+	{
+		return 1.0f;
+	}
+
+	// Frame rate independent exponential smoothing, a repeated pose does not move the plane
+	return deltaTime > 0.0 ? 1.0f - FMath::Exp(-static_cast<float>(deltaTime) / smoothingTime) : 0.0f;
+}
+
+void FStreamFocusPlaneProvider::AddSample(const FVector& position, double time)
+{
+	if (m_historyCount > 0 && m_history[(m_historyHead + VELOCITY_HISTORY_SIZE - 1) % VELOCITY_HISTORY_SIZE].time >= time)
+	{
+		// The same pose was rendered again, it adds no information about the motion
+		return;
+	}
+
+	m_history[m_historyHead] = FPlaneSample{position, time};
+	m_historyHead = (m_historyHead + 1) % VELOCITY_HISTORY_SIZE;
+	m_historyCount = FMath::Min(m_historyCount + 1, VELOCITY_HISTORY_SIZE);
+}
+
+FVector FStreamFocusPlaneProvider::EstimateVelocity(double time) const
+{
+	// Least squares slope of the recent positions over time, a single late or early pose barely moves it
+	double meanTime = 0.0;
+	FVector meanPosition = FVector::ZeroVector;
+	int32 sampleCount = 0;
+	for (int32 sampleIndex = 0; sampleIndex < m_historyCount; sampleIndex++)
+	{
+		const FPlaneSample& sample = m_history[sampleIndex];
+		if (time - sample.time <= VELOCITY_HISTORY_SECONDS)
+		{
+			meanTime += sample.time;
+			meanPosition += sample.position;
+			sampleCount++;
+		}
+	}
+	if (sampleCount < 2)
+	{
+		return FVector::ZeroVector;
+	}
+	meanTime /= sampleCount;
+	meanPosition /= sampleCount;
+
+	double timeVariance = 0.0;
+	FVector covariance = FVector::ZeroVector;
+	for (int32 sampleIndex = 0; sampleIndex < m_historyCount; sampleIndex++)
+	{
+		const FPlaneSample& sample = m_history[sampleIndex];
+		if (time - sample.time <= VELOCITY_HISTORY_SECONDS)
+		{
+			const double timeOffset = sample.time - meanTime;
+			timeVariance += timeOffset * timeOffset;
+			covariance += (sample.position - meanPosition) * timeOffset;
+		}
+	}
+	return timeVariance > UE_DOUBLE_SMALL_NUMBER ? covariance / timeVariance : FVector::ZeroVector;
+}
\ No newline at end of file
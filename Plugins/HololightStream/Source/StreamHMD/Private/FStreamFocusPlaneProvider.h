@@ -0,0 +1,116 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#ifndef HOLOLIGHT_UNREAL_FSTREAMFOCUSPLANEPROVIDER_H
+#define HOLOLIGHT_UNREAL_FSTREAMFOCUSPLANEPROVIDER_H
+
+#include "StreamHMDCommon.h"
+#include "StreamHMDBlueprintLibrary.h"
+
+#include <atomic>
+
+class FRDGBuilder;
+class FRDGTexture;
+class FRHIGPUTextureReadback;
+class UWorld;
+
+/// <summary>
+/// Estimates the plane the client stabilizes its reprojection on. The focus distance comes from a target set from
+/// Blueprints, a line trace along the gaze on the game thread, or a histogram of a small depth readback of the
+/// center of the view. The plane faces the viewer through that point and is sent in the tracking space of the pose.
+/// </summary>
+class FStreamFocusPlaneProvider
+{
+public:
+	// Size of the depth image the histogram is built from, in pixels per side
+	static constexpr int32 DEPTH_ESTIMATE_SIZE = 32;
+	// Part of the view, centered, that is read back for the depth histogram
+	static constexpr float DEPTH_ESTIMATE_REGION = 0.5f;
+
+	FStreamFocusPlaneProvider();
+	~FStreamFocusPlaneProvider();
+
+	FStreamFocusPlaneProvider(const FStreamFocusPlaneProvider&) = delete;
+	FStreamFocusPlaneProvider& operator=(const FStreamFocusPlaneProvider&) = delete;
+
+	// Game thread
+	void SetSource(EStreamFocusPlaneSource source);
+	EStreamFocusPlaneSource GetSource() const;
+	void SetTarget(const FVector& worldLocation);
+	void ClearTarget();
+	// Game thread, traces the gaze and moves the target into tracking space with this frame's tracking to world
+	void Update_GameThread(UWorld* world, const FTransform& trackingToWorld, const XrPosef& headPose,
+						   float worldToMeters, float farZ);
+
+	// Render thread, whether this frame needs a depth image for the histogram
+	bool NeedsDepthEstimate() const;
+	// Render thread, the texture is DEPTH_ESTIMATE_SIZE squared and holds the [0, 1] depth of the streamed clip planes
+	void EnqueueDepthReadback(FRDGBuilder& graphBuilder, FRDGTexture* depthTexture, float nearZ, float farZ);
+	// Render thread, returns false if no source has a focus distance for this frame. The pose time is the client time
+	// the pose was created at, in seconds, a pose that is rendered again has the same time.
+	bool ComputeFocusPlane_RenderThread(const XrPosef& headPose, double poseTime, isar::IsarFocusPlane& outPlane);
+
+	// Any thread, forgets all history so a new connection does not start from the last one's plane
+	void Reset();
+
+	// Head pose between the views, with the orientation of the first one
+	static XrPosef GetHeadPose(const TArray<XrView>& views);
+
+private:
+	static constexpr int32 DEPTH_READBACK_COUNT = 3;
+	static constexpr int32 DEPTH_HISTOGRAM_BINS = 32;
+	// Part of the read back pixels that has to hit geometry for the estimate to be used
+	static constexpr float DEPTH_MIN_COVERAGE = 0.1f;
+	static constexpr int32 VELOCITY_HISTORY_SIZE = 8;
+	// Samples older than this are not used for the velocity
+	static constexpr double VELOCITY_HISTORY_SECONDS = 0.2;
+	// Depth estimates older than this are stale, e.g. after the source switched away from the histogram for a while
+	static constexpr double DEPTH_MAX_AGE_SECONDS = 0.25;
+
+	struct FDepthReadback
+	{
+		TUniquePtr<FRHIGPUTextureReadback> readback;
+		float nearZ = 0.0f;
+		float farZ = 0.0f;
+		bool pending = false;
+	};
+
+	struct FPlaneSample
+	{
+		FVector position = FVector::ZeroVector;
+		double time = 0.0;
+	};
+
+	// Written on the game thread, read on the render thread
+	mutable FCriticalSection m_gameStateLock;
+	EStreamFocusPlaneSource m_source;
+	TOptional<FVector> m_targetWorld;
+	// Target in tracking space, meters
+	TOptional<FVector> m_targetTracking;
+	// Meters along the gaze, negative if the trace did not hit
+	float m_gazeDistance;
+
+	std::atomic<bool> m_resetRequested;
+
+	// Render thread only
+	FDepthReadback m_depthReadbacks[DEPTH_READBACK_COUNT];
+	int32 m_nextDepthReadback;
+	// Meters, negative if the last readback did not see enough geometry
+	float m_depthDistance;
+	double m_depthTime;
+	float m_smoothedDistance;
+	FVector m_smoothedVelocity;
+	double m_lastPoseTime;
+	FPlaneSample m_history[VELOCITY_HISTORY_SIZE];
+	int32 m_historyCount;
+	int32 m_historyHead;
+
+	void ReadDepthReadbacks();
+	void ResetRenderState();
+	static float GetSmoothingAlpha(double deltaTime);
+	void AddSample(const FVector& position, double time);
+	FVector EstimateVelocity(double time) const;
+};
+
+#endif // HOLOLIGHT_UNREAL_FSTREAMFOCUSPLANEPROVIDER_H
\ No newline at end of file
@@ -0,0 +1,119 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#include "FStreamFramePacer.h"
+
+CSV_DEFINE_CATEGORY(StreamPacing, true);
+
+FStreamFramePacer::FStreamFramePacer() : m_nominalPeriod(0.0),
+										 m_period(0.0),
+										 m_phase(0.0),
+										 m_arrivalJitter(0.0),
+										 m_waitTime(0.0),
+										 m_lastFrameTimestamp(0),
+										 m_receivedPoses(0),
+										 m_missedPoses(0)
+{
+}
+
+void FStreamFramePacer::Reset(double nominalPeriod)
+{
+	FScopeLock lock(&m_lock);
+	m_nominalPeriod = nominalPeriod;
+	m_period = nominalPeriod;
+	m_phase = 0.0;
+	m_arrivalJitter = 0.0;
+	m_waitTime = 0.0;
+	m_lastFrameTimestamp = 0;
+	m_receivedPoses = 0;
+	m_missedPoses = 0;
+}
+
+void FStreamFramePacer::OnPoseReceived(int64 frameTimestamp, double arrivalTime)
+{
+	FScopeLock lock(&m_lock);
+	if (m_period <= 0.0 || frameTimestamp <= m_lastFrameTimestamp)
+	{
+		// No frame rate negotiated yet, or the pose was already seen by the other thread pulling poses
+		return;
+	}
+	m_lastFrameTimestamp = frameTimestamp;
+
+	if (m_receivedPoses++ == 0)
+	{
+		m_phase = arrivalTime;
+		return;
+	}
+
+	// Poses lost on the way still advanced the client's cadence
+	const double periods = FMath::Max(1.0, FMath::RoundToDouble((arrivalTime - m_phase) / m_period));
+	m_missedPoses += static_cast<uint64>(periods) - 1;
+
+	const double predictedArrival = m_phase + periods * m_period;
+	const double error = arrivalTime - predictedArrival;
+	m_phase = predictedArrival + PHASE_GAIN * error;
+	m_period = FMath::Clamp(m_period + PERIOD_GAIN * error / periods,
+							m_nominalPeriod * (1.0 - MAX_PERIOD_DEVIATION),
+							m_nominalPeriod * (1.0 + MAX_PERIOD_DEVIATION));
+	m_arrivalJitter = FMath::Lerp(m_arrivalJitter, FMath::Abs(error), JITTER_SMOOTHING);
+}
+
+double FStreamFramePacer::GetNextFrameStartTime(double now, double startOffset) const
+{
+	FScopeLock lock(&m_lock);
+	if (m_receivedPoses < MIN_LOCKED_POSES || m_period <= 0.0)
+	{
+		return 0.0;
+	}
+
+	// The first start on the cadence that is not in the past, so a frame is never held back by more than a period
+	const double firstStart = m_phase + startOffset;
+	const double periods = FMath::Max(0.0, FMath::CeilToDouble((now - firstStart) / m_period));
+	return firstStart + periods * m_period;
+}
+
+void FStreamFramePacer::WaitForNextFrame(double startOffset, TFunctionRef<void()> pollPoses)
+{
+	SCOPED_NAMED_EVENT(StreamFramePacing, FColor::Turquoise);
+
+	const double waitStart = FPlatformTime::Seconds();
+	const double startTime = GetNextFrameStartTime(waitStart, startOffset);
+	double now = waitStart;
+	while (now < startTime)
+	{
+		pollPoses();
+		const double remaining = startTime - FPlatformTime::Seconds();
+		if (remaining > SPIN_TIME)
+		{
+			FPlatformProcess::SleepNoStats(static_cast<float>(FMath::Min(remaining - SPIN_TIME, POLL_INTERVAL)));
+		}
+		else
+		{
+			FPlatformProcess::YieldThread();
+		}
+		now = FPlatformTime::Seconds();
+	}
+
+	{
+		FScopeLock lock(&m_lock);
+		m_waitTime = now - waitStart;
+	}
+
+	const FStreamFramePacerStats stats = GetStats();
+	CSV_CUSTOM_STAT(StreamPacing, WaitMs, static_cast<float>(stats.waitMs), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(StreamPacing, CadencePeriodMs, static_cast<float>(stats.cadencePeriodMs), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(StreamPacing, ArrivalJitterMs, static_cast<float>(stats.arrivalJitterMs), ECsvCustomStatOp::Set);
+}
+
+FStreamFramePacerStats FStreamFramePacer::GetStats() const
+{
+	FScopeLock lock(&m_lock);
+	FStreamFramePacerStats stats;
+	stats.cadencePeriodMs = m_period * 1000.0;
+	stats.arrivalJitterMs = m_arrivalJitter * 1000.0;
+	stats.waitMs = m_waitTime * 1000.0;
+	stats.receivedPoses = m_receivedPoses;
+	stats.missedPoses = m_missedPoses;
+	return stats;
+}
\ No newline at end of file
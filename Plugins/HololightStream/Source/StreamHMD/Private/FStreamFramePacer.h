@@ -0,0 +1,72 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#ifndef HOLOLIGHT_UNREAL_FSTREAMFRAMEPACER_H
+#define HOLOLIGHT_UNREAL_FSTREAMFRAMEPACER_H
+
+#include "CoreMinimal.h"
+
+struct FStreamFramePacerStats
+{
+	// Period the client sends poses at, as measured from their arrival
+	double cadencePeriodMs = 0.0;
+	// Smoothed difference between pose arrivals and the cadence
+	double arrivalJitterMs = 0.0;
+	// Time the last game frame was held back to line up with the cadence
+	double waitMs = 0.0;
+	uint64 receivedPoses = 0;
+	uint64 missedPoses = 0;
+};
+
+/// <summary>
+/// Lines the start of the game frame up with the cadence the client sends poses at, which is the cadence it decodes
+/// and displays frames at. Pose arrivals are phase locked, so network jitter on a single pose does not move the
+/// schedule, while the period follows the client clock. Every game frame then starts right after a pose arrived,
+/// instead of running on a fixed frame rate that drifts against the client and leaves poses waiting for a frame.
+/// All times are passed in, in seconds, so pose traces can be replayed against the pacer.
+/// </summary>
+class FStreamFramePacer
+{
+public:
+	FStreamFramePacer();
+
+	// Game thread, starts over with the frame rate of a new connection
+	void Reset(double nominalPeriod);
+	// Any thread, called for every pulled pose with the time the client created it at, mapped to platform time. Poses
+	// pulled again or after a newer one are ignored.
+	void OnPoseReceived(int64 frameTimestamp, double arrivalTime);
+	// Returns the time the next game frame should start at, zero until the cadence is known
+	double GetNextFrameStartTime(double now, double startOffset) const;
+	// Game thread, holds the game frame back until GetNextFrameStartTime. Calls pollPoses every POLL_INTERVAL while
+	// waiting, so the poses pulled there are seen right after they arrived.
+	void WaitForNextFrame(double startOffset, TFunctionRef<void()> pollPoses);
+
+	FStreamFramePacerStats GetStats() const;
+
+private:
+	// How far a single arrival pulls the phase and the period toward it
+	static constexpr double PHASE_GAIN = 0.1;
+	static constexpr double PERIOD_GAIN = 0.01;
+	// The measured period may only deviate this much from the negotiated frame rate
+	static constexpr double MAX_PERIOD_DEVIATION = 0.25;
+	static constexpr double JITTER_SMOOTHING = 0.05;
+	// Arrivals needed before frames are paced
+	static constexpr uint64 MIN_LOCKED_POSES = 8;
+	// Time before the start time that is spun instead of slept, sleeping is not precise enough
+	static constexpr double SPIN_TIME = 0.001;
+	static constexpr double POLL_INTERVAL = 0.0005;
+
+	mutable FCriticalSection m_lock;
+	double m_nominalPeriod;
+	double m_period;
+	// Arrival time of the last pose as predicted by the cadence
+	double m_phase;
+	double m_arrivalJitter;
+	double m_waitTime;
+	int64 m_lastFrameTimestamp;
+	uint64 m_receivedPoses;
+	uint64 m_missedPoses;
+};
+
+#endif // HOLOLIGHT_UNREAL_FSTREAMFRAMEPACER_H
\ No newline at end of file
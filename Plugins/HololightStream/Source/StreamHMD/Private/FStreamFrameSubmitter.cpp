@@ -0,0 +1,159 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#include "FStreamFrameSubmitter.h"
+
+#include "ProfilingDebugging/CsvProfiler.h"
+
+CSV_DEFINE_CATEGORY(StreamVideo, true);
+
+static TAutoConsoleVariable<int32> CVarStreamFrameSubmitQueueSize(
+	TEXT("vr.StreamFrameSubmitQueueSize"),
+	1,
+	TEXT("Number of rendered frames that may wait for the Stream submit thread. Older frames are dropped when it is full."),
+	ECVF_RenderThreadSafe);
+
+FStreamFrameSubmitter::FStreamFrameSubmitter(FPushFunction pushFunction, FCompleteFunction completeFunction)
+	: m_pushFunction(MoveTemp(pushFunction)),
+	  m_completeFunction(MoveTemp(completeFunction)),
+	  m_isRunning(true),
+	  m_isPushing(false),
+	  m_submittedFrames(0),
+	  m_droppedFrames(0),
+	  m_failedFrames(0),
+	  m_submitLatencyMs(0.0),
+	  m_maxSubmitLatencyMs(0.0)
+{
+	m_submitThread = std::thread(&FStreamFrameSubmitter::SubmitFrames, this);
+}
+
+FStreamFrameSubmitter::~FStreamFrameSubmitter()
+{
+	if (m_submitThread.joinable())
+	{
+		m_isRunning = false;
+		m_queueCv.notify_all();
+		m_submitThread.join();
+	}
+
+	// Frames nobody pushed anymore still have to give their swapchain images back
+	for (FStreamFrameSubmission& submission : m_queue)
+	{
+		Drop(submission);
+	}
+}
+
+void FStreamFrameSubmitter::Enqueue(FStreamFrameSubmission&& submission)
+{
+	const size_t capacity = FMath::Max(CVarStreamFrameSubmitQueueSize.GetValueOnAnyThread(), 1);
+	submission.enqueueTime = FPlatformTime::Seconds();
+
+	TArray<FStreamFrameSubmission, TInlineAllocator<2>> dropped;
+	int32 queueDepth = 0;
+	{
+		std::lock_guard<std::mutex> lock(m_queueMutex);
+		while (m_queue.size() >= capacity)
+		{
+			dropped.Add(MoveTemp(m_queue.front()));
+			m_queue.pop_front();
+		}
+		m_queue.push_back(MoveTemp(submission));
+		queueDepth = static_cast<int32>(m_queue.size());
+	}
+	m_queueCv.notify_one();
+
+	// Outside the lock, the completion may take the swapchain image lock
+	for (FStreamFrameSubmission& oldest : dropped)
+	{
+		Drop(oldest);
+	}
+
+	CSV_CUSTOM_STAT(StreamVideo, SubmitQueueDepth, queueDepth, ECsvCustomStatOp::Set);
+}
+
+void FStreamFrameSubmitter::Flush()
+{
+	std::deque<FStreamFrameSubmission> dropped;
+	{
+		std::unique_lock<std::mutex> lock(m_queueMutex);
+		dropped.swap(m_queue);
+		m_idleCv.wait(lock, [this] { return !m_isPushing; });
+	}
+
+	for (FStreamFrameSubmission& submission : dropped)
+	{
+		Drop(submission);
+	}
+}
+
+FStreamFrameSubmitterStats FStreamFrameSubmitter::GetStats() const
+{
+	FStreamFrameSubmitterStats stats;
+	{
+		std::lock_guard<std::mutex> lock(m_queueMutex);
+		stats.queueDepth = static_cast<int32>(m_queue.size());
+	}
+	stats.submittedFrames = m_submittedFrames.load(std::memory_order_relaxed);
+	stats.droppedFrames = m_droppedFrames.load(std::memory_order_relaxed);
+	stats.failedFrames = m_failedFrames.load(std::memory_order_relaxed);
+	stats.submitLatencyMs = m_submitLatencyMs.load(std::memory_order_relaxed);
+	stats.maxSubmitLatencyMs = m_maxSubmitLatencyMs.load(std::memory_order_relaxed);
+	return stats;
+}
+
+void FStreamFrameSubmitter::SubmitFrames()
+{
+	while (m_isRunning)
+	{
+		FStreamFrameSubmission submission;
+		{
+			std::unique_lock<std::mutex> lock(m_queueMutex);
+			m_queueCv.wait(lock, [this] { return !m_queue.empty() || !m_isRunning; });
+			if (!m_isRunning)
+			{
+				break;
+			}
+			submission = MoveTemp(m_queue.front());
+			m_queue.pop_front();
+			m_isPushing = true;
+		}
+
+		bool pushed = false;
+		{
+			SCOPED_NAMED_EVENT(StreamPushFrame, FColor::Red);
+			pushed = m_pushFunction(submission);
+		}
+
+		if (pushed)
+		{
+			const double latencyMs = (FPlatformTime::Seconds() - submission.enqueueTime) * 1000.0;
+			const double smoothedMs = m_submittedFrames.load(std::memory_order_relaxed) == 0
+				? latencyMs
+				: FMath::Lerp(m_submitLatencyMs.load(std::memory_order_relaxed), latencyMs, LATENCY_SMOOTHING);
+			m_submitLatencyMs.store(smoothedMs, std::memory_order_relaxed);
+			m_maxSubmitLatencyMs.store(FMath::Max(m_maxSubmitLatencyMs.load(std::memory_order_relaxed), latencyMs),
+									   std::memory_order_relaxed);
+			m_submittedFrames.fetch_add(1, std::memory_order_relaxed);
+			CSV_CUSTOM_STAT(StreamVideo, SubmitLatencyMs, latencyMs, ECsvCustomStatOp::Set);
+		}
+		else
+		{
+			m_failedFrames.fetch_add(1, std::memory_order_relaxed);
+		}
+		m_completeFunction(submission, pushed);
+
+		{
+			std::lock_guard<std::mutex> lock(m_queueMutex);
+			m_isPushing = false;
+		}
+		m_idleCv.notify_all();
+	}
+}
+
+void FStreamFrameSubmitter::Drop(FStreamFrameSubmission& submission)
+{
+	m_droppedFrames.fetch_add(1, std::memory_order_relaxed);
+	CSV_CUSTOM_STAT(StreamVideo, DroppedFrames, 1, ECsvCustomStatOp::Accumulate);
+	m_completeFunction(submission, false);
+}
\ No newline at end of file
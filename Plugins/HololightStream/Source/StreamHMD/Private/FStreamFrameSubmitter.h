@@ -0,0 +1,94 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#ifndef HOLOLIGHT_UNREAL_FSTREAMFRAMESUBMITTER_H
+#define HOLOLIGHT_UNREAL_FSTREAMFRAMESUBMITTER_H
+
+#include "StreamHMDCommon.h"
+
+#include "XRSwapChain.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+struct FStreamFrameSubmission
+{
+	isar::IsarGraphicsApiFrame frame;
+	// Keeps the swapchain alive until the frame is pushed or dropped
+	FXRSwapChainPtr swapchain;
+	int32 imageIndex = INDEX_NONE;
+	// Only set if depth is streamed
+	FXRSwapChainPtr depthSwapchain;
+	int32 depthImageIndex = INDEX_NONE;
+	uint64 serial = 0;
+	double poseReceivedTime = 0.0;
+	double enqueueTime = 0.0;
+	uint64 timelineFrame = 0;
+};
+
+struct FStreamFrameSubmitterStats
+{
+	int32 queueDepth = 0;
+	uint64 submittedFrames = 0;
+	uint64 droppedFrames = 0;
+	uint64 failedFrames = 0;
+	// Time from a frame being queued on the RHI thread until pushFrame returned for it
+	double submitLatencyMs = 0.0;
+	double maxSubmitLatencyMs = 0.0;
+};
+
+/// <summary>
+/// Pushes frames to ISAR on a dedicated thread, so a stall in the encoder's submit path does not stall the RHI thread.
+/// The queue is bounded, when the encoder falls behind the oldest queued frame is dropped in favour of the newest.
+/// Pushing and the handling of finished frames are passed in as functions, the submitter itself does not talk to ISAR.
+/// </summary>
+class FStreamFrameSubmitter
+{
+public:
+	// Returns whether the frame was accepted
+	using FPushFunction = TFunction<bool(const FStreamFrameSubmission& submission)>;
+	// Called once for every queued frame, pushed is false if it was dropped or pushFrame failed
+	using FCompleteFunction = TFunction<void(const FStreamFrameSubmission& submission, bool pushed)>;
+
+	FStreamFrameSubmitter(FPushFunction pushFunction, FCompleteFunction completeFunction);
+	~FStreamFrameSubmitter();
+
+	FStreamFrameSubmitter(const FStreamFrameSubmitter&) = delete;
+	FStreamFrameSubmitter& operator=(const FStreamFrameSubmitter&) = delete;
+
+	void Enqueue(FStreamFrameSubmission&& submission);
+	// Drops all queued frames and waits for a push in progress to return
+	void Flush();
+
+	FStreamFrameSubmitterStats GetStats() const;
+
+private:
+	// Weight of the newest sample in the smoothed submit latency
+	static constexpr double LATENCY_SMOOTHING = 0.1;
+
+	FPushFunction m_pushFunction;
+	FCompleteFunction m_completeFunction;
+
+	std::thread m_submitThread;
+	std::atomic<bool> m_isRunning;
+	mutable std::mutex m_queueMutex;
+	std::condition_variable m_queueCv;
+	std::condition_variable m_idleCv;
+	std::deque<FStreamFrameSubmission> m_queue;
+	bool m_isPushing;
+
+	std::atomic<uint64> m_submittedFrames;
+	std::atomic<uint64> m_droppedFrames;
+	std::atomic<uint64> m_failedFrames;
+	std::atomic<double> m_submitLatencyMs;
+	std::atomic<double> m_maxSubmitLatencyMs;
+
+	void SubmitFrames();
+	void Drop(FStreamFrameSubmission& submission);
+};
+
+#endif // HOLOLIGHT_UNREAL_FSTREAMFRAMESUBMITTER_H
\ No newline at end of file
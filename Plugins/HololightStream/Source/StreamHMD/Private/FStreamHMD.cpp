@@ -29,6 +29,11 @@
 //JSON
 #include "Serialization/JsonSerializer.h"
 #include "PostProcess/PostProcessHMD.h"
+#include "PostProcess/PostProcessMaterialInputs.h"
+#include "PixelShaderUtils.h"
+#include "DynamicResolutionProxy.h"
+#include "SceneRenderTargetParameters.h"
+#include "SceneTexturesConfig.h"
 #include "GameFramework/WorldSettings.h"
 
 #if PLATFORM_WINDOWS
@@ -41,6 +46,9 @@
 
 #define LOCTEXT_NAMESPACE "FStreamHMD"
 
+/// <summary>
+/// Writes a source alpha of one, which the correction blend state turns into 1 - a of the render target.
+/// </summary>
 class FStreamCorrectionPS : public FGlobalShader
 {
 	DECLARE_SHADER_TYPE(FStreamCorrectionPS, Global);
@@ -55,34 +63,114 @@ public:
 	FStreamCorrectionPS(const ShaderMetaType::CompiledShaderInitializerType& initializer) :
 		FGlobalShader(initializer)
 	{
-		m_SceneTexture.Bind(initializer.ParameterMap, TEXT("SceneTexture"));
-		m_SceneSampler.Bind(initializer.ParameterMap, TEXT("SceneSampler"));
 	}
 
 	FStreamCorrectionPS() = default;
 
-	void SetParameters(FRHIBatchedShaderParameters& batchedParameters, FRHITexture* sceneTextureRHI)
-	{
-		SetTextureParameter(batchedParameters,
-							m_SceneTexture,
-							m_SceneSampler,
-							TStaticSamplerState<SF_Point>::GetRHI(),
-		                    sceneTextureRHI);
-	}
-
 	static const TCHAR* GetFunctionName()
 	{
 		return TEXT("StreamCorrectionPS");
 	}
-
-private:
-	LAYOUT_FIELD(FShaderResourceParameter, m_SceneTexture);
-	LAYOUT_FIELD(FShaderResourceParameter, m_SceneSampler);
 };
 
 IMPLEMENT_SHADER_TYPE(, FStreamCorrectionPS, TEXT("/Plugin/HololightStream/StreamCorrectionPixelShader.usf"),
 						TEXT("StreamCorrectionPS"), SF_Pixel);
 
+/// <summary>
+/// Converts the scene depth of a view into the [0, 1] depth range of the clip planes streamed with the frame.
+/// </summary>
+class FStreamDepthPS : public FGlobalShader
+{
+	DECLARE_GLOBAL_SHADER(FStreamDepthPS);
+	SHADER_USE_PARAMETER_STRUCT(FStreamDepthPS, FGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, SceneDepthTexture)
+		SHADER_PARAMETER(FVector4f, InvDeviceZToWorldZTransform)
+		SHADER_PARAMETER(FVector2f, InputRectMin)
+		SHADER_PARAMETER(FVector2f, OutputRectMin)
+		SHADER_PARAMETER(FVector2f, InputScale)
+		SHADER_PARAMETER(float, WorldToMeters)
+		SHADER_PARAMETER(float, NearZ)
+		SHADER_PARAMETER(float, FarZ)
+		RENDER_TARGET_BINDING_SLOTS()
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& parameters)
+	{
+		return true;
+	}
+};
+
+IMPLEMENT_GLOBAL_SHADER(FStreamDepthPS, "/Plugin/HololightStream/StreamDepthPixelShader.usf", "StreamDepthPS", SF_Pixel);
+
+DECLARE_GPU_STAT_NAMED(StreamHMDCorrection, TEXT("Stream HMD Correction"));
+DECLARE_GPU_STAT_NAMED(StreamHMDDepth, TEXT("Stream HMD Depth"));
+DECLARE_GPU_STAT_NAMED(StreamHMDFocusDepth, TEXT("Stream HMD Focus Depth"));
+
+static TAutoConsoleVariable<int32> CVarStreamFramePacing(
+	TEXT("vr.StreamFramePacing"),
+	1,
+	TEXT("Whether game frames start on the cadence the client sends poses at, instead of a fixed frame rate."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarStreamFramePacingOffset(
+	TEXT("vr.StreamFramePacingOffsetMs"),
+	0.0f,
+	TEXT("Time after a pose is expected that the game frame starts at, in milliseconds."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarStreamPosePrediction(
+	TEXT("vr.StreamPosePredictionMs"),
+	10.0f,
+	TEXT("Time past the render thread pose pull that the rendered pose is predicted to, in milliseconds.\n")
+	TEXT("The default covers rendering and submitting a frame after the late latch at 90 Hz.\n")
+	TEXT("0 renders every frame with the newest pose the client sent."),
+	ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32> CVarStreamAsyncFrameSubmit(
+	TEXT("vr.StreamAsyncFrameSubmit"),
+	1,
+	TEXT("Whether frames are pushed to the encoder on a dedicated thread instead of the RHI thread. D3D12 only."),
+	ECVF_RenderThreadSafe);
+
+static const FStreamLatencyTimeline* GetActiveLatencyTimeline()
+{
+	if (GEngine && GEngine->XRSystem.IsValid() && GEngine->XRSystem->GetSystemName() == STREAM_HMD_SYSTEM_NAME)
+	{
+		return &static_cast<FStreamHMD*>(GEngine->XRSystem.Get())->GetLatencyTimeline();
+	}
+	return nullptr;
+}
+
+static FAutoConsoleCommand CCmdStreamLatencyTimelineDump(
+	TEXT("vr.StreamLatencyTimeline.Dump"),
+	TEXT("Logs the pipeline stage times of the last streamed frames, keyed by their pose timestamp.\n")
+	TEXT("Optional argument: number of frames, 16 by default."),
+	FConsoleCommandWithArgsDelegate::CreateStatic([](const TArray<FString>& args)
+	{
+		if (const FStreamLatencyTimeline* timeline = GetActiveLatencyTimeline())
+		{
+			timeline->LogRecords(args.IsEmpty() ? 16 : FCString::Atoi(*args[0]));
+		}
+	}));
+
+static FAutoConsoleCommand CCmdStreamLatencyTimelineDumpCsv(
+	TEXT("vr.StreamLatencyTimeline.DumpCsv"),
+	TEXT("Writes the pipeline stage times of all recorded frames to a CSV file in Saved/Profiling/StreamLatency.\n")
+	TEXT("Optional argument: file name."),
+	FConsoleCommandWithArgsDelegate::CreateStatic([](const TArray<FString>& args)
+	{
+		if (const FStreamLatencyTimeline* timeline = GetActiveLatencyTimeline())
+		{
+			const FString filePath = timeline->WriteCsv(args.IsEmpty() ? FString() : args[0]);
+			if (!filePath.IsEmpty())
+			{
+				UE_LOG(LogHMD, Display, TEXT("Stream latency timeline written to %s"), *filePath);
+			}
+		}
+	}));
+
 /** Helper function for acquiring the appropriate FSceneViewport */
 FSceneViewport* FindSceneViewport()
 {
@@ -144,6 +232,9 @@ enum FStreamHMD::ETextureCopyModifier : uint8
 FStreamHMD::~FStreamHMD()
 {
 	UE_LOG(LogHMD, Display, TEXT("Destroy StreamHMD context"));
+	SetDynamicResolutionInstalled(false);
+	// Joins the submit thread before the connection it pushes to goes away
+	m_frameSubmitter.Reset();
 	if(m_connectionCreated)
 	{
 		if (m_microphoneCaptureStream) // Microphone Capture Stream is not guaranteed to be available
@@ -177,6 +268,7 @@ FStreamHMD::FStreamHMD(const FAutoRegister& autoRegister, TRefCountPtr<FStreamRe
 	m_stereoEnabled(false),
 	m_nViews(2),
 	m_audioListener(MakeShared<FStreamAudioListener>()),
+	m_focusPlaneProvider(MakeUnique<FStreamFocusPlaneProvider>()),
 	m_connectionCreated(false)
 {
 	const ERHIInterfaceType rhiType = GDynamicRHI ? RHIGetInterfaceType() : ERHIInterfaceType::Hidden;
@@ -215,6 +307,18 @@ FStreamHMD::FStreamHMD(const FAutoRegister& autoRegister, TRefCountPtr<FStreamRe
 			UE_LOG(LogHMD, Error, TEXT("Failed to create Fence"));
 			return;
 		}
+		m_frameFenceTimeline = MakeUnique<FStreamD3D12FenceTimeline>(m_pD3D12Fence);
+		// D3D11 has no fence the encoder could wait on and its immediate context is not free threaded, so frames are
+		// only pushed off the RHI thread on D3D12
+		m_frameSubmitter = MakeUnique<FStreamFrameSubmitter>(
+			[this](const FStreamFrameSubmission& submission)
+			{
+				return PushFrame(submission.frame, submission.timelineFrame);
+			},
+			[this](const FStreamFrameSubmission& submission, bool pushed)
+			{
+				OnFrameSubmissionComplete(submission, pushed);
+			});
 	}
 	else
 	{
@@ -250,7 +354,8 @@ FName FStreamHMD::GetHMDName() const
 		return GetSystemName();
 	}
 
-	return FName(m_connectionInfo.remoteName);
+	FStreamConnectionInfoSnapshot connectionInfo;
+	return GetConnectionInfoSnapshot(connectionInfo) ? FName(connectionInfo.remoteName) : GetSystemName();
 }
 
 bool FStreamHMD::ReconfigureForShaderPlatform(EShaderPlatform newShaderPlatform)
@@ -284,6 +389,12 @@ void FStreamHMD::BeginRenderViewFamily(FSceneViewFamily& inViewFamily)
 	{
 		SpectatorScreenController->BeginRenderViewFamily();
 	}
+
+	ENQUEUE_RENDER_COMMAND(UpdateGameFrameStartTime)(
+		[this, GameFrameStartTime = m_pipelinedFrameStateGame.gameFrameStartTime](FRHICommandListImmediate&)
+		{
+			m_pipelinedFrameStateRendering.gameFrameStartTime = GameFrameStartTime;
+		});
 }
 
 void FStreamHMD::PreRenderView_RenderThread(FRDGBuilder& graphBuilder, FSceneView& inView)
@@ -704,7 +815,14 @@ void FStreamHMD::OnEndPlay(FWorldContext& inWorldContext)
 		UE_LOG(LogHMD, Error, TEXT("Error in Close Connection, Status: %d"), err);
 	}
 	std::this_thread::sleep_for(std::chrono::milliseconds(1));
-	err = m_serverApi.destroyConnection(&m_streamConnection);
+	if (m_frameSubmitter)
+	{
+		m_frameSubmitter->Flush();
+	}
+	{
+		FWriteScopeLock lock(m_frameHandleMutex);
+		err = m_serverApi.destroyConnection(&m_streamConnection);
+	}
 	if (err != IsarError::eNone || m_streamConnection)
 	{
 		// Write error to output
@@ -920,6 +1038,7 @@ bool FStreamHMD::EnableStereo(bool iStereo)
 
 		FApp::SetUseVRFocus(true);
 		FApp::SetHasVRFocus(true);
+		// Until a client is connected and the frame rate is negotiated
 		constexpr float targetFrameRate = 90.0f;
 		GEngine->FixedFrameRate = targetFrameRate;
 		GEngine->bUseFixedFrameRate = true;
@@ -983,9 +1102,19 @@ bool FStreamHMD::OnStartGameFrame(FWorldContext& worldContext)
 		m_worldToMeters = pWorldSettings->WorldToMeters;
 	}
 
+	// Before the pose is pulled, so the frame starts with the one that just arrived
+	UpdateFramePacing();
+	m_pipelinedFrameStateGame.gameFrameStartTime = FPlatformTime::Seconds();
 	RefreshTrackingToWorldTransform(worldContext);
 	FCoreDelegates::VRHeadsetReconnected.Broadcast();
 	UpdateDeviceLocations();
+	UpdateResolutionFraction();
+	if (m_connected)
+	{
+		m_focusPlaneProvider->Update_GameThread(worldContext.World(), GetTrackingToWorldTransform(),
+												FStreamFocusPlaneProvider::GetHeadPose(m_pipelinedFrameStateGame.views),
+												m_worldToMeters, DEPTH_FAR_PLANE / m_worldToMeters);
+	}
 	return true;
 }
 
@@ -1265,16 +1394,18 @@ bool FStreamHMD::AllocateRenderTargetTextures(uint32 sizeX, uint32 sizeY, uint8
 	FClearValueBinding valueBindings = FClearValueBinding::Transparent;
 	UE_LOG(LogHMD, Verbose, TEXT("AllocateRenderTargetTextures"));
 	int numViews = 2;
-	if (m_connected)
+	FStreamConnectionInfoSnapshot connectionInfo;
+	const bool connected = GetConnectionInfoSnapshot(connectionInfo) && m_connected;
+	if (connected)
 	{
-		m_serverApi.getConnectionInfo(m_streamConnection, &m_connectionInfo);
-		sizeX = m_connectionInfo.renderConfig.width * m_connectionInfo.renderConfig.numViews;
-		sizeY = m_connectionInfo.renderConfig.height;
-		numViews = m_connectionInfo.renderConfig.numViews;
+		sizeX = connectionInfo.renderConfig.width * connectionInfo.renderConfig.numViews;
+		sizeY = connectionInfo.renderConfig.height;
+		numViews = connectionInfo.renderConfig.numViews;
 		UE_LOG(LogHMD, Log, TEXT("AllocateRenderTargetTextures  width: %d, height: %d"), sizeX, sizeY);
 	}
 
 	m_streamSwapchain.Reset();
+	m_depthSwapchain.Reset();
 
 	{
 		uint8 unusedActualFormat = 0;
@@ -1294,7 +1425,29 @@ bool FStreamHMD::AllocateRenderTargetTextures(uint32 sizeX, uint32 sizeY, uint8
 		}
 	}
 
-	outTargetableTextures = m_streamSwapchain->GetSwapChain();
+	if (connected && connectionInfo.renderConfig.depthEnabled)
+	{
+		uint8 unusedActualFormat = 0;
+		m_depthSwapchain = m_renderBridge->CreateSwapchain(PF_R32_FLOAT,
+														   unusedActualFormat,
+														   sizeX,
+														   sizeY,
+														   1,
+														   1,
+														   1,
+														   TexCreate_RenderTargetable | TexCreate_ShaderResource,
+														   FClearValueBinding::Black);
+		if (!m_depthSwapchain)
+		{
+			// Color still streams without depth, the client only loses reprojection
+			UE_LOG(LogHMD, Error, TEXT("Error: Failed to create depth SwapChain with width %d height %d"), sizeX,
+				   sizeY);
+		}
+	}
+
+	// The engine always renders into the aliased texture, which points at the image acquired for the current frame
+	outTargetableTextures.Reset();
+	outTargetableTextures.Add(m_streamSwapchain->GetTextureRef());
 	outShaderResourceTextures = outTargetableTextures;
 
 	m_width = sizeX;
@@ -1370,10 +1523,20 @@ int32 FStreamHMD::GetDesiredNumberOfViews(bool stereoRequested) const
 	return 2;
 }
 
-void FStreamHMD::OnBeginRendering_RHIThread(const FPipelinedFrameState& inFrameState, FXRSwapChainPtr swapchainPtr)
+void FStreamHMD::OnBeginRendering_RHIThread(const FPipelinedFrameState& inFrameState, FXRSwapChainPtr swapchainPtr,
+										   FXRSwapChainPtr depthSwapchainPtr)
 {
 	ensure(IsInRenderingThread() || IsInRHIThread());
 	m_pipelinedFrameStateRHI = inFrameState;
+
+	if (swapchainPtr)
+	{
+		static_cast<FStreamXRSwapchain*>(swapchainPtr.Get())->IncrementSwapChainIndex_RHIThread();
+	}
+	if (depthSwapchainPtr)
+	{
+		static_cast<FStreamXRSwapchain*>(depthSwapchainPtr.Get())->IncrementSwapChainIndex_RHIThread();
+	}
 }
 
 void FStreamHMD::OnBeginRendering_RenderThread(FRHICommandListImmediate& rhiCmdList, FSceneViewFamily& viewFamily)
@@ -1386,25 +1549,36 @@ void FStreamHMD::OnBeginRendering_RenderThread(FRHICommandListImmediate& rhiCmdL
 	}
 
 	// Create the SwapChain here
+	m_pipelinedFrameStateRendering.timelineFrame = 0;
 	if (m_connected)
 	{
+		const double renderBeginTime = FPlatformTime::Seconds();
 		UpdateDeviceLocations();
+		FPipelinedFrameState& pipelineState = m_pipelinedFrameStateRendering;
+		pipelineState.timelineFrame = m_latencyTimeline.BeginFrame(pipelineState.poseTimestamp,
+																	pipelineState.frameTimestamp);
+		m_latencyTimeline.MarkStage(pipelineState.timelineFrame, EStreamLatencyStage::GameFrameStart,
+									pipelineState.gameFrameStartTime);
+		m_latencyTimeline.MarkStage(pipelineState.timelineFrame, EStreamLatencyStage::RenderBegin, renderBeginTime);
+		m_latencyTimeline.MarkStage(pipelineState.timelineFrame, EStreamLatencyStage::PosePull,
+									pipelineState.poseReceivedTime);
+		pipelineState.hasFocusPlane = m_focusPlaneProvider->ComputeFocusPlane_RenderThread(
+			FStreamFocusPlaneProvider::GetHeadPose(pipelineState.views),
+			PoseTimestampToSeconds(pipelineState.poseTimestamp), pipelineState.focusPlane);
 	}
 
 	rhiCmdList.EnqueueLambda(
-		[this, FrameState = m_pipelinedFrameStateRendering](FRHICommandListImmediate& inRHICmdList)
+		[this, FrameState = m_pipelinedFrameStateRendering, ColorSwapchain = m_streamSwapchain,
+			DepthSwapchain = m_depthSwapchain](FRHICommandListImmediate& inRHICmdList)
 		{
-			OnBeginRendering_RHIThread(FrameState, m_streamSwapchain);
+			OnBeginRendering_RHIThread(FrameState, ColorSwapchain, DepthSwapchain);
 		});
 }
 
 int32 FStreamHMD::AcquireColorTexture()
 {
 	check(IsInGameThread());
-	if (const FXRSwapChainPtr& swapchain = m_streamSwapchain)
-	{
-		return swapchain->GetSwapChainIndex_RHIThread();
-	}
+	// Only the aliased texture is handed to the engine, the swapchain image behind it is selected on the RHI thread
 	return 0;
 }
 
@@ -1429,17 +1603,15 @@ void FStreamHMD::PostRenderViewFamily_RenderThread(FRDGBuilder& graphBuilder, FS
 			projection.subImage = colorImage;
 		}
 
-		AddPass(graphBuilder, RDG_EVENT_NAME("StreamHMDCorrection"), [this](FRHICommandListImmediate& rhiCmdList)
+		RDG_GPU_STAT_SCOPE(graphBuilder, StreamHMDCorrection);
+		AddPass(graphBuilder, RDG_EVENT_NAME("StreamHMDCorrection"),
+				[this, TimelineFrame = m_pipelinedFrameStateRendering.timelineFrame](FRHICommandListImmediate& rhiCmdList)
 		{
 			auto* texture = m_streamSwapchain->GetTexture2D();
 			const uint32 width = texture->GetSizeX();
 			const uint32 height = texture->GetSizeY();
 			const FIntPoint targetSize(width, height);
 
-			FTextureRHIRef stagingTexture = m_stagingBufferPool.CreateStagingBuffer_RenderThread(
-				rhiCmdList, width, height, texture->GetFormat());
-			TransitionAndCopyTexture(rhiCmdList, texture, stagingTexture, {});
-
 			rhiCmdList.Transition(FRHITransitionInfo(texture, ERHIAccess::Unknown, ERHIAccess::RTV));
 
 			FRHITexture* colorRT = texture->GetTexture2DArray()
@@ -1449,41 +1621,32 @@ void FStreamHMD::PostRenderViewFamily_RenderThread(FRDGBuilder& graphBuilder, FS
 
 			rhiCmdList.BeginRenderPass(renderPassInfo, TEXT("StreamHMDCorrection"));
 			{
-				DrawClearQuadAlpha(rhiCmdList, 0.0f);
-
 				rhiCmdList.SetViewport(0, 0, 0, width, height, 1.0f);
 
 				FGraphicsPipelineStateInitializer graphicsPSOInit;
 				rhiCmdList.ApplyCachedRenderTargets(graphicsPSOInit);
 
-				graphicsPSOInit.BlendState = TStaticBlendState<CW_RGBA>::GetRHI();
+				// Only alpha is written: a = 1 * (1 - a_dst) + a_dst * 0. Color keeps what the scene rendered, so the
+				// whole correction is a single full screen pass over the swapchain without a staging copy or clear.
+				graphicsPSOInit.BlendState = TStaticBlendState<CW_ALPHA,
+															   BO_Add, BF_Zero, BF_One,
+															   BO_Add, BF_InverseDestAlpha, BF_Zero>::GetRHI();
 
 				graphicsPSOInit.RasterizerState = TStaticRasterizerState<>::GetRHI();
 				graphicsPSOInit.DepthStencilState = TStaticDepthStencilState<false, CF_Always>::GetRHI();
 				graphicsPSOInit.PrimitiveType = PT_TriangleList;
 
-				FGlobalShaderMap* pShaderMap = GetGlobalShaderMap(GetConfiguredShaderPlatform());;
+				FGlobalShaderMap* pShaderMap = GetGlobalShaderMap(GetConfiguredShaderPlatform());
 
 				TShaderMapRef<FScreenVS> mapVertexShader(pShaderMap);
-
-				TShaderRef<FGlobalShader> pixelShader;
-				TShaderRef<FStreamCorrectionPS> streamCorrectionPS;
-
-				TShaderMapRef<FStreamCorrectionPS> streamCorrectionPSRef(pShaderMap);
-
-				streamCorrectionPS = streamCorrectionPSRef;
-				pixelShader = streamCorrectionPSRef;
+				TShaderMapRef<FStreamCorrectionPS> streamCorrectionPS(pShaderMap);
 
 				graphicsPSOInit.BoundShaderState.VertexDeclarationRHI = GFilterVertexDeclaration.VertexDeclarationRHI;
 				graphicsPSOInit.BoundShaderState.VertexShaderRHI = mapVertexShader.GetVertexShader();
-				graphicsPSOInit.BoundShaderState.PixelShaderRHI = pixelShader.GetPixelShader();
+				graphicsPSOInit.BoundShaderState.PixelShaderRHI = streamCorrectionPS.GetPixelShader();
 
 				SetGraphicsPipelineState(rhiCmdList, graphicsPSOInit, 0);
 
-				rhiCmdList.Transition(FRHITransitionInfo(stagingTexture, ERHIAccess::Unknown, ERHIAccess::SRVMask));
-
-				SetShaderParametersLegacyPS(rhiCmdList, streamCorrectionPS, stagingTexture);
-
 				m_rendererModule->DrawRectangle(
 					rhiCmdList,
 					0, 0,
@@ -1499,8 +1662,21 @@ void FStreamHMD::PostRenderViewFamily_RenderThread(FRDGBuilder& graphBuilder, FS
 			rhiCmdList.EndRenderPass();
 
 			rhiCmdList.Transition(FRHITransitionInfo(texture, ERHIAccess::RTV, ERHIAccess::Present));
+			rhiCmdList.EnqueueLambda([this, TimelineFrame](FRHICommandListImmediate&)
+			{
+				m_latencyTimeline.MarkStage(TimelineFrame, EStreamLatencyStage::CorrectionPass,
+											FPlatformTime::Seconds());
+			});
 
-			m_stagingBufferPool.ReleaseStagingBufferForUnmap_AnyThread(stagingTexture);
+			if (m_frameFenceTimeline)
+			{
+				// Completes once the corrected frame is on the GPU, handed to the RHI thread in submission order
+				const uint64 frameFenceValue = m_frameFenceTimeline->Signal(rhiCmdList);
+				rhiCmdList.EnqueueLambda([this, frameFenceValue](FRHICommandListImmediate&)
+				{
+					m_frameFenceValueRHI = frameFenceValue;
+				});
+			}
 		});
 	}
 }
@@ -1509,6 +1685,101 @@ void FStreamHMD::PostRenderView_RenderThread(FRDGBuilder& graphBuilder, FSceneVi
 {
 }
 
+#if ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 5
+void FStreamHMD::SubscribeToPostProcessingPass(EPostProcessingPass pass, const FSceneView& view,
+											   FAfterPassCallbackDelegateArray& inOutPassCallbacks, bool isPassEnabled)
+#else
+void FStreamHMD::SubscribeToPostProcessingPass(EPostProcessingPass pass,
+											   FAfterPassCallbackDelegateArray& inOutPassCallbacks, bool isPassEnabled)
+#endif
+{
+	// Motion blur is the first pass views can hook into, the scene depth is complete by then. The callback runs even
+	// if motion blur itself is disabled.
+	if (pass == EPostProcessingPass::MotionBlur && m_connected)
+	{
+		inOutPassCallbacks.Add(
+			FAfterPassCallbackDelegate::CreateRaw(this, &FStreamHMD::StreamSceneDepth_RenderThread));
+	}
+}
+
+FScreenPassTexture FStreamHMD::StreamSceneDepth_RenderThread(FRDGBuilder& graphBuilder, const FSceneView& view,
+															 const FPostProcessMaterialInputs& inputs)
+{
+	const TRDGUniformBufferRef<FSceneTextureUniformParameters> sceneTextures = inputs.SceneTextures.SceneTextures;
+	if (!m_connected || !sceneTextures)
+	{
+		return inputs.ReturnUntouchedSceneColorForPostProcessing(graphBuilder);
+	}
+	FRDGTextureRef sceneDepth = sceneTextures->GetParameters()->SceneDepthTexture;
+
+	const FXRSwapChainPtr depthSwapchain = m_depthSwapchain;
+	if (depthSwapchain)
+	{
+		RDG_GPU_STAT_SCOPE(graphBuilder, StreamHMDDepth);
+
+		FRDGTextureRef streamDepth = RegisterExternalTexture(graphBuilder, depthSwapchain->GetTexture2D(),
+															 TEXT("StreamDepth"));
+		// Scene textures are rendered at screen percentage, the streamed images at the unscaled view size. The other
+		// view's half of the image is rendered by its own pass.
+		AddDepthPass(graphBuilder, view, sceneDepth, view.ViewRect, streamDepth, view.UnscaledViewRect,
+					 ERenderTargetLoadAction::ELoad);
+
+		// Same state the color image is handed to the encoder in
+		graphBuilder.SetTextureAccessFinal(streamDepth, ERHIAccess::Present);
+	}
+
+	// One eye is enough to estimate the focus distance, both look at the same point
+	if (IStereoRendering::IsAPrimaryView(view) && m_focusPlaneProvider->NeedsDepthEstimate())
+	{
+		RDG_GPU_STAT_SCOPE(graphBuilder, StreamHMDFocusDepth);
+
+		const int32 estimateSize = FStreamFocusPlaneProvider::DEPTH_ESTIMATE_SIZE;
+		FRDGTextureRef focusDepth = graphBuilder.CreateTexture(
+			FRDGTextureDesc::Create2D(FIntPoint(estimateSize, estimateSize), PF_R32_FLOAT, FClearValueBinding::None,
+									  TexCreate_RenderTargetable | TexCreate_ShaderResource),
+			TEXT("StreamFocusDepth"));
+
+		const FIntPoint regionSize = FIntPoint(
+			FMath::Max(1, FMath::RoundToInt(view.ViewRect.Width() * FStreamFocusPlaneProvider::DEPTH_ESTIMATE_REGION)),
+			FMath::Max(1, FMath::RoundToInt(view.ViewRect.Height() * FStreamFocusPlaneProvider::DEPTH_ESTIMATE_REGION)));
+		const FIntPoint regionMin = view.ViewRect.Min + (view.ViewRect.Size() - regionSize) / 2;
+		AddDepthPass(graphBuilder, view, sceneDepth, FIntRect(regionMin, regionMin + regionSize), focusDepth,
+					 FIntRect(0, 0, estimateSize, estimateSize), ERenderTargetLoadAction::ENoAction);
+
+		float nearZ = 0.0f;
+		float farZ = 0.0f;
+		GetDepthRange(nearZ, farZ);
+		m_focusPlaneProvider->EnqueueDepthReadback(graphBuilder, focusDepth, nearZ, farZ);
+	}
+
+	return inputs.ReturnUntouchedSceneColorForPostProcessing(graphBuilder);
+}
+
+void FStreamHMD::AddDepthPass(FRDGBuilder& graphBuilder, const FSceneView& view, FRDGTextureRef sceneDepth,
+							  const FIntRect& inputRect, FRDGTextureRef outputTexture, const FIntRect& outputRect,
+							  ERenderTargetLoadAction loadAction) const
+{
+	float nearZ = 0.0f;
+	float farZ = 0.0f;
+	GetDepthRange(nearZ, farZ);
+
+	FStreamDepthPS::FParameters* parameters = graphBuilder.AllocParameters<FStreamDepthPS::FParameters>();
+	parameters->SceneDepthTexture = sceneDepth;
+	parameters->InvDeviceZToWorldZTransform = FVector4f(view.InvDeviceZToWorldZTransform);
+	parameters->InputRectMin = FVector2f(inputRect.Min);
+	parameters->OutputRectMin = FVector2f(outputRect.Min);
+	parameters->InputScale = FVector2f(inputRect.Size()) / FVector2f(outputRect.Size());
+	parameters->WorldToMeters = GetWorldToMetersScale();
+	parameters->NearZ = nearZ;
+	parameters->FarZ = farZ;
+	parameters->RenderTargets[0] = FRenderTargetBinding(outputTexture, loadAction);
+
+	FGlobalShaderMap* pShaderMap = GetGlobalShaderMap(GetConfiguredShaderPlatform());
+	TShaderMapRef<FStreamDepthPS> pixelShader(pShaderMap);
+	FPixelShaderUtils::AddFullscreenPass(graphBuilder, pShaderMap, RDG_EVENT_NAME("StreamHMDDepth"), pixelShader,
+										 parameters, outputRect);
+}
+
 inline IsarPose GetHeadToRightEyeTransform(const IsarXrPose& pose)
 {
 	using namespace Windows::Foundation::Numerics;
@@ -1624,26 +1895,44 @@ bool FStreamHMD::GetPlayAreaRect(FTransform& outTransform, FVector2D& outExtent)
 void FStreamHMD::OnFinishRendering_RHIThread()
 {
 	ensure(IsInRenderingThread() || IsInRHIThread());
-	if (!m_renderBridge || !m_streamSwapchain || m_needsReallocation)
+	if (!m_renderBridge || !m_streamSwapchain)
 	{
 		return;
 	}
 
+	FStreamXRSwapchain* swapchain = static_cast<FStreamXRSwapchain*>(m_streamSwapchain.Get());
+	const FXRSwapChainPtr depthSwapchainPtr = m_depthSwapchain;
+	FStreamXRSwapchain* depthSwapchain = static_cast<FStreamXRSwapchain*>(depthSwapchainPtr.Get());
+	// A frame rendered into the spare image because the encoder held every other one is dropped
+	const bool imageDiscarded = swapchain->IsCurrentImageDiscarded_RHIThread() ||
+		(depthSwapchain && depthSwapchain->IsCurrentImageDiscarded_RHIThread());
+	if (m_needsReallocation || imageDiscarded)
+	{
+		swapchain->ReleaseCurrentImage_RHIThread(nullptr);
+		if (depthSwapchain)
+		{
+			depthSwapchain->ReleaseCurrentImage_RHIThread(nullptr);
+		}
+		return;
+	}
+
+	bool frameSubmitted = false;
 	if (m_connected && m_streamConnection)
 	{
 		const FRHITexture* pRenderedTexture = m_streamSwapchain->GetTexture2D();
-		const float nearZ = GNearClippingPlane_RenderThread / GetWorldToMetersScale();
-		const float farZ = 5000.0f / GetWorldToMetersScale();
+		const FRHITexture* pDepthTexture = depthSwapchain ? depthSwapchain->GetTexture2D() : nullptr;
+		float nearZ = 0.0f;
+		float farZ = 0.0f;
+		GetDepthRange(nearZ, farZ);
 		const FPipelinedFrameState& pipelineState = m_pipelinedFrameStateRHI;
 		IsarFrameInfo frameInfo;
-		frameInfo.hasFocusPlane = 0;
 		frameInfo.zFar = farZ;
 		frameInfo.zNear = nearZ;
 		frameInfo.textureFormat = IsarTextureFormat_RGBA32;
-		frameInfo.hasFocusPlane = 0;
+		frameInfo.hasFocusPlane = pipelineState.hasFocusPlane ? 1 : 0;
+		frameInfo.focusPlane = pipelineState.focusPlane;
 
-		m_serverApi.getConnectionInfo(m_streamConnection, &m_connectionInfo);
-		if (m_connectionInfo.renderConfig.numViews == 1 && !pipelineState.views.IsEmpty())
+		if (GetNumViews() == 1 && !pipelineState.views.IsEmpty())
 		{
 			frameInfo.pose.poseLeft.orientation.x = pipelineState.views[0].pose.orientation.x;
 			frameInfo.pose.poseLeft.orientation.y = pipelineState.views[0].pose.orientation.y;
@@ -1698,30 +1987,134 @@ void FStreamHMD::OnFinishRendering_RHIThread()
 		{
 			frame.graphicsApiType = IsarGraphicsApiType_D3D11;
 			frame.d3d11.frame = reinterpret_cast<ID3D11Texture2D*>(pRenderedTexture->GetNativeResource());
-			frame.d3d11.depthFrame = nullptr;
+			frame.d3d11.depthFrame = pDepthTexture
+				? reinterpret_cast<ID3D11Texture2D*>(pDepthTexture->GetNativeResource())
+				: nullptr;
 		}
 		else
 		{
 			frame.graphicsApiType = IsarGraphicsApiType_D3D12;
 			frame.d3d12.frame = reinterpret_cast<ID3D12Resource*>(pRenderedTexture->GetNativeResource());
-			frame.d3d12.depthFrame = nullptr;
-			frame.d3d12.frameFenceValue = m_pD3D12Fence->GetCompletedValue();
+			frame.d3d12.depthFrame = pDepthTexture
+				? reinterpret_cast<ID3D12Resource*>(pDepthTexture->GetNativeResource())
+				: nullptr;
+			frame.d3d12.frameFenceValue = m_frameFenceValueRHI;
 			frame.d3d12.subresourceIndex = 0;
 		}
 
-		if (m_connected && m_streamConnection)
+		if (m_frameSubmitter && CVarStreamAsyncFrameSubmit.GetValueOnAnyThread() != 0)
 		{
-			FReadScopeLock lock(m_frameHandleMutex);
-			auto err = m_serverApi.pushFrame(m_streamConnection, frame);
-			if (err != IsarError::eNone)
+			FStreamFrameSubmission submission;
+			submission.frame = frame;
+			submission.swapchain = m_streamSwapchain;
+			submission.imageIndex = swapchain->GetSwapChainIndex_RHIThread();
+			submission.serial = ++m_submittedFrameCount;
+			submission.poseReceivedTime = pipelineState.poseReceivedTime;
+			submission.timelineFrame = pipelineState.timelineFrame;
+			// From here on the submit thread releases the images, once the frame was pushed or dropped
+			swapchain->SubmitCurrentImage_RHIThread(submission.serial);
+			if (depthSwapchain)
 			{
-				// write error to output or so (if there is one)
-				UE_LOG(LogHMD, Error, TEXT("Error in PushFrame "));
+				submission.depthSwapchain = depthSwapchainPtr;
+				submission.depthImageIndex = depthSwapchain->GetSwapChainIndex_RHIThread();
+				depthSwapchain->SubmitCurrentImage_RHIThread(submission.serial);
 			}
+			m_frameSubmitter->Enqueue(MoveTemp(submission));
+			return;
 		}
+
+		if (PushFrame(frame, pipelineState.timelineFrame))
+		{
+			frameSubmitted = true;
+			OnFramePushed(pipelineState.poseReceivedTime);
+		}
+	}
+
+	const uint64 frameSerial = frameSubmitted ? ++m_submittedFrameCount : 0;
+	for (FStreamXRSwapchain* frameSwapchain : {swapchain, depthSwapchain})
+	{
+		if (!frameSwapchain)
+		{
+			continue;
+		}
+
+		if (!frameSubmitted)
+		{
+			frameSwapchain->ReleaseCurrentImage_RHIThread(nullptr);
+			continue;
+		}
+
+		frameSwapchain->SubmitCurrentImage_RHIThread(frameSerial);
+		if (frameSerial > ENCODER_FRAMES_IN_FLIGHT)
+		{
+			frameSwapchain->ReleaseCompletedImages(frameSerial - ENCODER_FRAMES_IN_FLIGHT);
+		}
+	}
+}
+
+bool FStreamHMD::PushFrame(const IsarGraphicsApiFrame& frame, uint64 timelineFrame)
+{
+	FReadScopeLock lock(m_frameHandleMutex);
+	if (!m_connected || !m_streamConnection)
+	{
+		return false;
+	}
+
+	m_latencyTimeline.MarkStage(timelineFrame, EStreamLatencyStage::PushBegin, FPlatformTime::Seconds());
+	auto err = m_serverApi.pushFrame(m_streamConnection, frame);
+	if (err != IsarError::eNone)
+	{
+		// write error to output or so (if there is one)
+		UE_LOG(LogHMD, Error, TEXT("Error in PushFrame "));
+		return false;
+	}
+	m_latencyTimeline.OnFramePushed(timelineFrame, FPlatformTime::Seconds());
+	return true;
+}
+
+void FStreamHMD::OnFramePushed(double poseReceivedTime)
+{
+	if (m_audioEnabled && poseReceivedTime > 0.0)
+	{
+		m_audioListener->OnVideoFrameSubmitted(FPlatformTime::Seconds() - poseReceivedTime);
+	}
+}
+
+void FStreamHMD::OnFrameSubmissionComplete(const FStreamFrameSubmission& submission, bool pushed)
+{
+	const TPair<FStreamXRSwapchain*, int32> frameImages[] = {
+		{static_cast<FStreamXRSwapchain*>(submission.swapchain.Get()), submission.imageIndex},
+		{static_cast<FStreamXRSwapchain*>(submission.depthSwapchain.Get()), submission.depthImageIndex}
+	};
+	for (const TPair<FStreamXRSwapchain*, int32>& frameImage : frameImages)
+	{
+		if (!frameImage.Key)
+		{
+			continue;
+		}
+
+		if (!pushed)
+		{
+			frameImage.Key->ReleaseSubmittedImage(frameImage.Value, submission.serial);
+		}
+		else if (submission.serial > ENCODER_FRAMES_IN_FLIGHT)
+		{
+			frameImage.Key->ReleaseCompletedImages(submission.serial - ENCODER_FRAMES_IN_FLIGHT);
+		}
+	}
+
+	if (pushed)
+	{
+		OnFramePushed(submission.poseReceivedTime);
 	}
 }
 
+void FStreamHMD::GetDepthRange(float& outNearZ, float& outFarZ) const
+{
+	outNearZ = GNearClippingPlane_RenderThread / GetWorldToMetersScale();
+	outFarZ = DEPTH_FAR_PLANE / GetWorldToMetersScale();
+}
+
 bool FStreamHMD::OnEndGameFrame(FWorldContext& worldContext)
 {
 	return true;
@@ -1733,11 +2126,11 @@ void FStreamHMD::EnumerateViews(FPipelinedFrameState& pipelineState)
 	uint32 viewConfigCount = 2;
 	uint32_t configWidth = 2064; // Recommended default;
 	uint32_t configHeight = 2208; // Recommended default;
-	if (m_streamConnection && m_connected)
+	FStreamConnectionInfoSnapshot connectionInfo;
+	if (GetConnectionInfoSnapshot(connectionInfo) && m_streamConnection && m_connected)
 	{
-		m_serverApi.getConnectionInfo(m_streamConnection, &m_connectionInfo);
-		configWidth = m_connectionInfo.renderConfig.width;
-		configHeight = m_connectionInfo.renderConfig.height;
+		configWidth = connectionInfo.renderConfig.width;
+		configHeight = connectionInfo.renderConfig.height;
 		pipelineState.viewConfigs.SetNum(viewConfigCount);
 		pipelineState.viewConfigs[0].recommendedImageRectHeight = configHeight;
 		pipelineState.viewConfigs[0].recommendedImageRectWidth = configWidth;
@@ -2062,9 +2455,8 @@ bool FStreamHMD::StartAudio()
 
 	if (audioDevice->SampleRate != FStreamAudioListener::SAMPLE_RATE)
 	{
-		UE_LOG(LogHMD, Display, TEXT("Sample rate for Stream must be %d, can not start audio stream."),
-			   FStreamAudioListener::SAMPLE_RATE);
-		return false;
+		UE_LOG(LogHMD, Display, TEXT("Audio device runs at %d Hz, Stream audio will be resampled to %d Hz."),
+			   (int32)audioDevice->SampleRate, FStreamAudioListener::SAMPLE_RATE);
 	}
 #if ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION > 3
 	audioDevice->RegisterSubmixBufferListener(m_audioListener->AsShared(), audioDevice->GetMainSubmixObject());
@@ -2124,28 +2516,22 @@ void FStreamHMD::OnConnectionStateChanged(IsarConnectionState newState)
 {
 	FString typeString;
 	FString codecString;
+	IsarConnectionInfo connectionInfo = {};
 	switch (newState)
 	{
 		case IsarConnectionState_CONNECTED:
-			m_serverApi.getConnectionInfo(m_streamConnection, &m_connectionInfo);
-			if (m_connectionInfo.renderConfig.depthEnabled)
-			{
-				UE_LOG(LogHMD, Warning, TEXT("Depth not supported ....Resetting the connection"));
-				if (!RestartConnection())
-				{
-					UE_LOG(LogHMD, Log, TEXT("Error: Failed to Reset Connection "));
-				}
-				return;
-			}
+			connectionInfo = m_connectionInfo.Refresh(m_serverApi, m_streamConnection);
 			m_connected = true;
+			m_focusPlaneProvider->Reset();
+			m_clientClock.Reset();
+			m_poseHistory.Reset();
 			
-			if (m_width != (m_connectionInfo.renderConfig.width * m_connectionInfo.renderConfig.numViews) ||
-				m_height != m_connectionInfo.renderConfig.height ||
-				m_nViews != m_connectionInfo.renderConfig.numViews || 
+			if (m_width != (connectionInfo.renderConfig.width * connectionInfo.renderConfig.numViews) ||
+				m_height != connectionInfo.renderConfig.height ||
+				m_nViews != connectionInfo.renderConfig.numViews || 
 				!m_needsReallocation )
 			{
 				UE_LOG(LogHMD, Log, TEXT("Reset Config Views"));
-				GEngine->FixedFrameRate = m_connectionInfo.renderConfig.framerate;
 				m_needsReallocation = true;
 				m_pipelinedLayerStateRendering.colorImages.Empty();
 				
@@ -2165,7 +2551,7 @@ void FStreamHMD::OnConnectionStateChanged(IsarConnectionState newState)
 			}
 			UE_LOG(LogHMD, Display, TEXT("Stream Connection State: CONNECTED"));
 
-			switch (m_connectionInfo.remoteDeviceType)
+			switch (connectionInfo.remoteDeviceType)
 			{
 				case IsarDeviceType_AR: typeString = "AR";
 					break;
@@ -2179,7 +2565,7 @@ void FStreamHMD::OnConnectionStateChanged(IsarConnectionState newState)
 					break;
 			}
 
-			switch (m_connectionInfo.codecInUse)
+			switch (connectionInfo.codecInUse)
 			{
 				case IsarCodecType_H264: codecString = "H.264";
 					break;
@@ -2207,18 +2593,18 @@ void FStreamHMD::OnConnectionStateChanged(IsarConnectionState newState)
 					   "Number of Views: %d\n"
 					   "Frame Rate: %d FPS\n"
 					   "Depth Buffer Enabled: %s"),
-				   *FString(m_connectionInfo.remoteName),
-				   ISAR_GET_VERSION_MAJOR(m_connectionInfo.remoteVersion),
-				   ISAR_GET_VERSION_MINOR(m_connectionInfo.remoteVersion),
-				   ISAR_GET_VERSION_PATCH(m_connectionInfo.remoteVersion),
+				   *FString(connectionInfo.remoteName),
+				   ISAR_GET_VERSION_MAJOR(connectionInfo.remoteVersion),
+				   ISAR_GET_VERSION_MINOR(connectionInfo.remoteVersion),
+				   ISAR_GET_VERSION_PATCH(connectionInfo.remoteVersion),
 				   *typeString,
 				   *codecString,
-				   m_connectionInfo.renderConfig.encoderBitrateKbps,
-				   m_connectionInfo.renderConfig.width,
-				   m_connectionInfo.renderConfig.height,
-				   m_connectionInfo.renderConfig.numViews,
-				   m_connectionInfo.renderConfig.framerate,
-				   m_connectionInfo.renderConfig.depthEnabled ? *FString("True") : *FString("False"));
+				   connectionInfo.renderConfig.encoderBitrateKbps,
+				   connectionInfo.renderConfig.width,
+				   connectionInfo.renderConfig.height,
+				   connectionInfo.renderConfig.numViews,
+				   connectionInfo.renderConfig.framerate,
+				   connectionInfo.renderConfig.depthEnabled ? *FString("True") : *FString("False"));
 
 			if (m_shouldEnableAudio)
 			{
@@ -2230,6 +2616,46 @@ void FStreamHMD::OnConnectionStateChanged(IsarConnectionState newState)
 			break;
 		case IsarConnectionState_DISCONNECTED: m_connected = false;
 			UE_LOG(LogHMD, Display, TEXT("Stream Connection State: DISCONNECTED"));
+			if (m_frameSubmitter)
+			{
+				const FStreamFrameSubmitterStats submitStats = m_frameSubmitter->GetStats();
+				UE_LOG(LogHMD, Display, TEXT("Frame Submission Statistics:\n"
+						   "Submitted Frames: %llu\n"
+						   "Dropped Frames: %llu\n"
+						   "Failed Frames: %llu\n"
+						   "Submit Latency: %.2f ms (max %.2f ms)"),
+					   submitStats.submittedFrames,
+					   submitStats.droppedFrames,
+					   submitStats.failedFrames,
+					   submitStats.submitLatencyMs,
+					   submitStats.maxSubmitLatencyMs);
+			}
+			if (const FXRSwapChainPtr swapchain = m_streamSwapchain)
+			{
+				UE_LOG(LogHMD, Display, TEXT("Frames dropped while the encoder held every swapchain image: %llu"),
+					   static_cast<FStreamXRSwapchain*>(swapchain.Get())->GetDroppedImageCount());
+			}
+			if (m_audioEnabled)
+			{
+				const FStreamAudioStats audioStats = m_audioListener->GetStats();
+				UE_LOG(LogHMD, Display, TEXT("Audio Stream Statistics:\n"
+						   "A/V Offset: %.1f ms\n"
+						   "Queue Depth: %.1f ms\n"
+						   "Clock Drift: %.1f ppm\n"
+						   "Stretched Packets: %llu\n"
+						   "Skipped Packets: %llu\n"
+						   "Overflow Samples: %llu\n"
+						   "Underflows: %llu\n"
+						   "Suppressed Silent Packets: %llu"),
+					   audioStats.avOffsetMs,
+					   audioStats.queueDepthMs,
+					   audioStats.driftPpm,
+					   audioStats.stretchedPackets,
+					   audioStats.skippedPackets,
+					   audioStats.overflowSamples,
+					   audioStats.underflowCount,
+					   audioStats.suppressedPackets);
+			}
 			break;
 		case IsarConnectionState_CLOSING: m_connected = false;
 			UE_LOG(LogHMD, Display, TEXT("Stream Connection State: CLOSING"));
@@ -2257,27 +2683,6 @@ void FStreamHMD::OnConnectionStateChanged(IsarConnectionState newState)
 }
 
 
-bool FStreamHMD::RestartConnection() const
-{
-	bool connectStatus = true;
-	UE_LOG(LogHMD, Log, TEXT("Close Connection"));
-	auto err = m_serverApi.closeConnection(m_streamConnection);
-	if (err != IsarError::eNone)
-	{
-		// Write error to output
-		UE_LOG(LogHMD, Error, TEXT("Error in Close Connection, Status: %d"), err);
-		connectStatus = false;
-	}
-	UE_LOG(LogHMD, Log, TEXT("Open Connection"));
-	err = m_serverApi.openConnection(m_streamConnection);
-	if (err != IsarError::eNone || !m_streamConnection)
-	{
-		// Write error to output
-		UE_LOG(LogHMD, Error, TEXT("Error in Open Connection, Status: %d "), err);
-		connectStatus = false;
-	}
-	return connectStatus;
-}
 void FStreamHMD::UpdateDeviceLocations()
 {
 	if (!m_connected)
@@ -2286,17 +2691,29 @@ void FStreamHMD::UpdateDeviceLocations()
 	}
 
 	FPipelinedFrameState& pipelineState = GetPipelinedFrameStateForThread();
-	m_serverApi.getConnectionInfo(m_streamConnection, &m_connectionInfo);
 
 	IsarXrPose inputPose;
 	auto err = m_serverApi.pullViewPose(m_streamConnection, &inputPose);
 	if (err == IsarError::eNone && !pipelineState.views.IsEmpty())
 	{
+		const double pullTime = FPlatformTime::Seconds();
+		OnViewPosePulled(inputPose, pullTime);
+
+		// The render thread pull is the late latch of the frame: the engine's late update reads the pose through
+		// GetCurrentPose right after it and only then builds the view uniform buffers. The RHI thread copy of this
+		// state is what is sent with the frame, so the encoder gets exactly the rendered pose.
+		const float predictionMs = CVarStreamPosePrediction.GetValueOnAnyThread();
+		if (IsInRenderingThread() && predictionMs > 0.0f)
+		{
+			m_poseHistory.SamplePose(pullTime + predictionMs / 1000.0, inputPose);
+		}
+
 		pipelineState.poseTimestamp = inputPose.poseTimestamp;
 		pipelineState.frameTimestamp = inputPose.frameTimestamp;
+		pipelineState.poseReceivedTime = pullTime;
 
 		IsarVector3 position = inputPose.poseLeft.position;
-		if (m_connectionInfo.renderConfig.numViews == 1 && !pipelineState.views.IsEmpty())
+		if (GetNumViews() == 1 && !pipelineState.views.IsEmpty())
 		{
 			pipelineState.views[0].pose.position.x = position.x;
 			pipelineState.views[0].pose.position.y = position.y;
@@ -2391,77 +2808,160 @@ void FStreamHMD::UnregisterConnectionStateHandler(TScriptInterface<IStreamConnec
 
 bool FStreamHMD::GetConnectionInfo(FStreamConnectionInfo& ConnectionInfo)
 {
-	if (!m_connected)
+	FStreamConnectionInfoSnapshot connectionInfo;
+	if (!GetConnectionInfoSnapshot(connectionInfo) || !m_connected)
 	{
 		return false;
 	}
 
-	m_serverApi.getConnectionInfo(m_streamConnection, &m_connectionInfo);
-
-	ConnectionInfo.RemoteName = FString(m_connectionInfo.remoteName);
+	ConnectionInfo.RemoteName = FString(connectionInfo.remoteName);
 	ConnectionInfo.RemoteVersion = FString::Printf(
-	    TEXT("%d.%d.%d"), ISAR_GET_VERSION_MAJOR(m_connectionInfo.remoteVersion),
-	    ISAR_GET_VERSION_MINOR(m_connectionInfo.remoteVersion), ISAR_GET_VERSION_PATCH(m_connectionInfo.remoteVersion));
+	    TEXT("%d.%d.%d"), ISAR_GET_VERSION_MAJOR(connectionInfo.remoteVersion),
+	    ISAR_GET_VERSION_MINOR(connectionInfo.remoteVersion), ISAR_GET_VERSION_PATCH(connectionInfo.remoteVersion));
 
 	ConnectionInfo.RenderConfig = FStreamRenderConfig
 	{
-		.Width = (int32)m_connectionInfo.renderConfig.width,
-	    .Height = (int32)m_connectionInfo.renderConfig.height,
-	    .NumViews = (int32)m_connectionInfo.renderConfig.numViews,
-	    .EncoderBitrateKbps = m_connectionInfo.renderConfig.encoderBitrateKbps,
-	    .Framerate = (int32)m_connectionInfo.renderConfig.framerate,
-	    .bDepthEnabled = m_connectionInfo.renderConfig.depthEnabled == 1,
-	    .bPosePredictionEnabled = m_connectionInfo.renderConfig.posePredictionEnabled == 1
+		.Width = (int32)connectionInfo.renderConfig.width,
+	    .Height = (int32)connectionInfo.renderConfig.height,
+	    .NumViews = (int32)connectionInfo.renderConfig.numViews,
+	    .EncoderBitrateKbps = connectionInfo.renderConfig.encoderBitrateKbps,
+	    .Framerate = (int32)connectionInfo.renderConfig.framerate,
+	    .bDepthEnabled = connectionInfo.renderConfig.depthEnabled == 1,
+	    .bPosePredictionEnabled = connectionInfo.renderConfig.posePredictionEnabled == 1
 	};
 
-	ConnectionInfo.RemoteDeviceType = (EStreamDeviceType)m_connectionInfo.remoteDeviceType;
-	ConnectionInfo.CodecInUse = (EStreamCodecType)m_connectionInfo.codecInUse;
+	ConnectionInfo.RemoteDeviceType = (EStreamDeviceType)connectionInfo.remoteDeviceType;
+	ConnectionInfo.CodecInUse = (EStreamCodecType)connectionInfo.codecInUse;
 
 	return true;
 }
 
-FTextureRHIRef FStagingBufferPool::CreateStagingBuffer_RenderThread(FRHICommandListImmediate& rhiCmdList, int32 width,
-																	int32 height, EPixelFormat format)
+uint32 FStreamHMD::GetNumViews() const
 {
-	auto stagingBufferPredicate =
-		[width, height, format](const FTextureRHIRef& texture2DrhiRef)
-	{
-		return texture2DrhiRef->GetSizeX() == width && texture2DrhiRef->GetSizeY() == height && texture2DrhiRef->
-			GetFormat() == format;
-	};
+	FStreamConnectionInfoSnapshot connectionInfo;
+	return GetConnectionInfoSnapshot(connectionInfo) ? connectionInfo.renderConfig.numViews : 2;
+}
+
+void FStreamHMD::UpdateResolutionFraction()
+{
+	check(IsInGameThread());
 
-	TArray<FTextureRHIRef> localPool;
+	const FStreamResolutionSettings settings = FStreamResolutionSettings::FromConsoleVariables();
+	FStreamConnectionInfoSnapshot connectionInfo;
+	const bool dynamicResolutionEnabled = GetConnectionInfoSnapshot(connectionInfo) && settings.enabled && m_connected;
+	SetDynamicResolutionInstalled(dynamicResolutionEnabled);
+	if (!dynamicResolutionEnabled)
 	{
-		FScopeLock lock(&m_poolLock);
-		localPool = MoveTemp(m_pool);
+		// The next connection starts at full resolution
+		m_resolutionController.Reset();
+		return;
 	}
 
-	// Find any pooled staging buffer with suitable properties.
-	int32 index = localPool.IndexOfByPredicate(stagingBufferPredicate);
+	const IsarRenderConfig& renderConfig = connectionInfo.renderConfig;
+	FStreamResolutionSample sample;
+	sample.gpuFrameTimeMs = FPlatformTime::ToMilliseconds(RHIGetGPUFrameCycles());
+	sample.framerate = static_cast<int32>(renderConfig.framerate);
+	sample.targetFrameTimeMs = sample.framerate > 0 ? 1000.0 / sample.framerate : 0.0;
+	sample.encodeQueueDepth = m_frameSubmitter ? m_frameSubmitter->GetStats().queueDepth : 0;
+	sample.bitrateKbps = renderConfig.encoderBitrateKbps;
+	sample.fullResolutionPixels = static_cast<int64>(renderConfig.width) * renderConfig.height * renderConfig.numViews;
+	m_dynamicResolutionState->SetResolutionFraction(m_resolutionController.Update(sample, settings),
+													settings.maxFraction);
+}
+
+void FStreamHMD::SetDynamicResolutionInstalled(bool install)
+{
+	if (install == m_dynamicResolutionInstalled || !GEngine)
+	{
+		return;
+	}
+	m_dynamicResolutionInstalled = install;
 
-	if (index != -1)
+	if (!install)
 	{
-		FTextureRHIRef stagingBuffer = MoveTemp(localPool[index]);
-		localPool.RemoveAtSwap(index);
-		return stagingBuffer;
+		GEngine->ChangeDynamicResolutionStateAtNextFrame(FDynamicResolutionHeuristicProxy::CreateDefaultState());
+		return;
 	}
 
-	FRHITextureCreateDesc desc =
-		FRHITextureCreateDesc::Create2D(TEXT("FStagingBufferPool_StagingBuffer"), width, height, format);
+	if (!m_dynamicResolutionState)
+	{
+		m_dynamicResolutionState = MakeShared<FStreamDynamicResolutionState>();
+	}
+	// The scene is rendered at the fraction picked by the controller and upscaled to the full view rect, so the
+	// swapchain keeps the size the client asked for
+	GEngine->ChangeDynamicResolutionStateAtNextFrame(m_dynamicResolutionState);
 
-	return RHICreateTexture(desc);
+	static const IConsoleVariable* CVarDynamicResolutionOperationMode =
+		IConsoleManager::Get().FindConsoleVariable(TEXT("r.DynamicRes.OperationMode"));
+	if (CVarDynamicResolutionOperationMode && CVarDynamicResolutionOperationMode->GetInt() == 0)
+	{
+		UE_LOG(LogHMD, Warning, TEXT("vr.StreamDynamicResolution has no effect while r.DynamicRes.OperationMode is 0"));
+	}
 }
 
-void FStagingBufferPool::ReleaseStagingBufferForUnmap_AnyThread(FTextureRHIRef& texture2DRHIRef)
+void FStreamHMD::UpdateFramePacing()
 {
-	FScopeLock lock(&m_poolLock);
-	m_pool.Emplace(MoveTemp(texture2DRHIRef));
+	check(IsInGameThread());
+
+	FStreamConnectionInfoSnapshot connectionInfo;
+	const uint32 framerate = GetConnectionInfoSnapshot(connectionInfo) && m_connected
+		? connectionInfo.renderConfig.framerate
+		: 0;
+	const bool pacingEnabled = CVarStreamFramePacing.GetValueOnGameThread() != 0 && framerate > 0;
+	const uint32 pacedFramerate = pacingEnabled ? framerate : 0;
+	if (pacedFramerate != m_pacedFramerate)
+	{
+		if (m_pacedFramerate > 0)
+		{
+			const FStreamFramePacerStats pacerStats = m_framePacer.GetStats();
+			UE_LOG(LogHMD, Display, TEXT("Frame Pacing Statistics:\n"
+					   "Cadence: %.2f ms\n"
+					   "Pose Arrival Jitter: %.2f ms\n"
+					   "Received Poses: %llu\n"
+					   "Missed Poses: %llu"),
+				   pacerStats.cadencePeriodMs,
+				   pacerStats.arrivalJitterMs,
+				   pacerStats.receivedPoses,
+				   pacerStats.missedPoses);
+		}
+
+		m_pacedFramerate = pacedFramerate;
+		m_framePacer.Reset(pacingEnabled ? 1.0 / framerate : 0.0);
+		// The pacer holds frames back itself, a fixed frame rate would sleep on top of it and drift against the client
+		GEngine->bUseFixedFrameRate = !pacingEnabled;
+		if (framerate > 0)
+		{
+			GEngine->FixedFrameRate = framerate;
+		}
+		if (pacingEnabled)
+		{
+			UE_LOG(LogHMD, Log, TEXT("Pacing frames to the client pose cadence at %u FPS"), framerate);
+		}
+	}
+
+	if (pacingEnabled)
+	{
+		// Poses are pulled while the frame is held back, so the pacer sees them right after they arrived
+		m_framePacer.WaitForNextFrame(CVarStreamFramePacingOffset.GetValueOnGameThread() / 1000.0,
+									  [this]()
+									  {
+										  IsarXrPose pose;
+										  if (m_connected &&
+											  m_serverApi.pullViewPose(m_streamConnection, &pose) == IsarError::eNone)
+										  {
+											  OnViewPosePulled(pose, FPlatformTime::Seconds());
+										  }
+									  });
+	}
 }
 
-FStagingBufferPool::~FStagingBufferPool()
+void FStreamHMD::OnViewPosePulled(const IsarXrPose& pose, double pullTime)
 {
-	FScopeLock lock(&m_poolLock);
-	m_pool.Empty();
+	m_clientClock.OnPosePulled(pose.poseTimestamp, pullTime);
+	// The time the client created the pose at keeps its cadence, unlike the time it happened to be pulled at
+	const double poseTime = m_clientClock.ToPlatformTime(pose.poseTimestamp);
+	m_framePacer.OnPoseReceived(pose.frameTimestamp, poseTime);
+	m_poseHistory.AddPose(pose, poseTime);
 }
 
 #undef LOCTEXT_NAMESPACE
\ No newline at end of file
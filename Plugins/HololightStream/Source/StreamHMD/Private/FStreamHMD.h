@@ -16,6 +16,16 @@
 #include "IStreamHMD.h"
 #include "FStreamRenderBridge.h"
 #include "FStreamAudioListener.h"
+#include "FStreamConnectionInfoCache.h"
+#include "FStreamClientClock.h"
+#include "FStreamDynamicResolutionState.h"
+#include "FStreamFenceTimeline.h"
+#include "FStreamFrameSubmitter.h"
+#include "FStreamFocusPlaneProvider.h"
+#include "FStreamResolutionController.h"
+#include "FStreamFramePacer.h"
+#include "FStreamLatencyTimeline.h"
+#include "FStreamPoseHistory.h"
 #include "StreamHMDBlueprintLibrary.h"
 #include "StreamConnectionStateHandler.h"
 
@@ -51,19 +61,6 @@ const FName STREAM_HMD_SYSTEM_NAME("StreamHMD");
 
 using namespace isar;
 
-class FStagingBufferPool
-{
-public:
-	FTextureRHIRef CreateStagingBuffer_RenderThread(FRHICommandListImmediate& rhiCmdList, int32 width, int32 height,
-													EPixelFormat format);
-	void ReleaseStagingBufferForUnmap_AnyThread(FTextureRHIRef& texture2DRHIRef);
-	~FStagingBufferPool();
-
-private:
-	FCriticalSection m_poolLock;
-	TArray<FTextureRHIRef> m_pool;
-};
-
 class STREAMHMD_API FStreamHMD : public IStreamHMD
 								 , public FHMDSceneViewExtension
 								 , public FXRRenderTargetManager
@@ -77,6 +74,15 @@ public:
 		float pixelDensity = 1.0f;
 		int64_t poseTimestamp = 0;
 		int64_t frameTimestamp = 0;
+		// Platform time the pose was pulled at, used to measure the video pipeline latency
+		double poseReceivedTime = 0.0;
+		// Set on the game thread and handed to the render thread with the view family
+		double gameFrameStartTime = 0.0;
+		// Latency timeline record of the frame, zero if the frame is not streamed
+		uint64 timelineFrame = 0;
+		// Estimated on the render thread for the pose of this frame
+		bool hasFocusPlane = false;
+		isar::IsarFocusPlane focusPlane = {};
 	};
 
 	struct FPipelinedLayerState
@@ -123,13 +129,21 @@ public:
 	void OnBeginRendering_RenderThread(FRHICommandListImmediate& rhiCmdList, FSceneViewFamily& viewFamily) override;
 	void PostRenderViewFamily_RenderThread(FRDGBuilder& graphBuilder, FSceneViewFamily& inViewFamily) override;
 	void PostRenderView_RenderThread(FRDGBuilder& graphBuilder, FSceneView& inView) override;
+#if ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 5
+	void SubscribeToPostProcessingPass(EPostProcessingPass pass, const FSceneView& view,
+									   FAfterPassCallbackDelegateArray& inOutPassCallbacks, bool isPassEnabled) override;
+#else
+	void SubscribeToPostProcessingPass(EPostProcessingPass pass, FAfterPassCallbackDelegateArray& inOutPassCallbacks,
+									   bool isPassEnabled) override;
+#endif
 
 	/** Constructor */
 	FStreamHMD(const FAutoRegister&, TRefCountPtr<FStreamRenderBridge>& inRenderBridge);
 	/** Destructor */
 	~FStreamHMD() ;
 
-	void OnBeginRendering_RHIThread(const FPipelinedFrameState& inFrameState, FXRSwapChainPtr swapchainPtr);
+	void OnBeginRendering_RHIThread(const FPipelinedFrameState& inFrameState, FXRSwapChainPtr swapchainPtr,
+									FXRSwapChainPtr depthSwapchainPtr);
 	void OnFinishRendering_RHIThread();
 
 	/** IXRTrackingSystem */
@@ -235,9 +249,18 @@ public:
 	void RegisterConnectionStateHandler(TScriptInterface<IStreamConnectionStateHandler> connectionStateHandler);
 	void UnregisterConnectionStateHandler(TScriptInterface<IStreamConnectionStateHandler> connectionStateHandler);
 	bool GetConnectionInfo(FStreamConnectionInfo& ConnectionInfo);
+	void SetFocusPlaneSource(EStreamFocusPlaneSource source) { m_focusPlaneProvider->SetSource(source); }
+	EStreamFocusPlaneSource GetFocusPlaneSource() const { return m_focusPlaneProvider->GetSource(); }
+	void SetFocusPlaneTarget(const FVector& worldLocation) { m_focusPlaneProvider->SetTarget(worldLocation); }
+	void ClearFocusPlaneTarget() { m_focusPlaneProvider->ClearTarget(); }
+	const FStreamLatencyTimeline& GetLatencyTimeline() const { return m_latencyTimeline; }
 
 private:
-	FStagingBufferPool m_stagingBufferPool;
+#if WITH_DEV_AUTOMATION_TESTS
+	// Swaps in a mock server API to count what the per frame paths query
+	friend class FStreamConnectionInfoCacheNoQueryPerFrameTest;
+#endif
+
 	FQuat m_baseOrientation;
 	FVector m_basePosition;
 	float m_worldToMeters = 100.0f;
@@ -246,6 +269,11 @@ private:
 	IRendererModule* m_rendererModule;
 	ID3D12CommandQueue* m_pD3D12CommandQueue;
 	ID3D12Fence* m_pD3D12Fence;
+	// Signaled after the correction pass of every frame, ISAR waits on it before encoding (D3D12 only)
+	TUniquePtr<FStreamFenceTimeline> m_frameFenceTimeline;
+	// Fence value of the frame the RHI thread is about to push, only touched on the RHI thread
+	uint64 m_frameFenceValueRHI = 0;
+	TUniquePtr<FStreamFrameSubmitter> m_frameSubmitter;
 	ID3D12Device* m_pD3D12Device;
 	ID3D11Device* m_pD3D11Device;
 	FRWLock m_frameHandleMutex;
@@ -259,15 +287,40 @@ private:
 	int m_deviceType;
 	bool m_stereoEnabled;
 	FXRSwapChainPtr m_streamSwapchain;
+	// Linear depth for client side reprojection, only allocated while the client asks for depth
+	FXRSwapChainPtr m_depthSwapchain;
+	// Far clip plane in world units, the streamed depth and the focus plane gaze trace end here
+	static constexpr float DEPTH_FAR_PLANE = 5000.0f;
+	// ISAR keeps reading the last pushed frame until the next one is pushed
+	static constexpr uint64 ENCODER_FRAMES_IN_FLIGHT = 1;
+	// Completion value of the last frame handed to the encoder, only touched on the RHI thread
+	uint64 m_submittedFrameCount = 0;
 	int m_width;
 	int m_height;
 	int m_nViews;
 	FPipelinedLayerState m_pipelinedLayerStateRendering;
 	EShaderPlatform m_configuredShaderPlatform = EShaderPlatform::SP_NumPlatforms;
 	bool m_connected = false;
-	isar::IsarConnectionInfo m_connectionInfo;
+	// Refreshed once on CONNECTED, per frame code only reads the cached copy
+	FStreamConnectionInfoCache m_connectionInfo;
 	IStreamExtension* m_inputModule;
 	TSharedPtr<FStreamAudioListener, ESPMode::ThreadSafe> m_audioListener;
+	TUniquePtr<FStreamFocusPlaneProvider> m_focusPlaneProvider;
+	// Game thread only, scales the view rects inside the render target instead of reallocating it
+	FStreamResolutionController m_resolutionController;
+	// Engine dynamic resolution state the controller's fraction is applied through, installed while it is enabled
+	TSharedPtr<FStreamDynamicResolutionState> m_dynamicResolutionState;
+	bool m_dynamicResolutionInstalled = false;
+	// Maps the timestamps of pulled poses to platform time
+	FStreamClientClock m_clientClock;
+	// Fed from the poses pulled with pullViewPose, waited on at the start of every game frame
+	FStreamFramePacer m_framePacer;
+	// Fed from pullViewPose, sampled when the render thread latches the frame pose
+	FStreamPoseHistory m_poseHistory;
+	// Frame rate the pacer runs at, zero while frames are not paced. Game thread only.
+	uint32 m_pacedFramerate = 0;
+	// Stage times of the last streamed frames, written from every thread the frame passes
+	FStreamLatencyTimeline m_latencyTimeline;
 	IStreamExtension* m_microphoneCaptureStream = nullptr;
 	FString m_streamIp;
 	FString m_streamURL;
@@ -289,7 +342,6 @@ private:
 	std::function<DeviceInfo(EControllerHand)> m_getDeviceInfoCallback;
 
 	bool InitConnectionConfig(std::vector<IsarIceServerConfig>& serverConfigArray);
-	bool RestartConnection() const;
 	IsarError CreateConnection(const std::string& applicationName,
 							   const IsarGraphicsApiConfig& gfxConfig,
 							   const RemotingConfig remotingConfig,
@@ -298,6 +350,34 @@ private:
 							   IsarPortRange portRange,
 							   IsarConnection* connection);
 	void OnConnectionStateChanged(IsarConnectionState newState);
+	// Any thread, returns false until the first connection
+	bool GetConnectionInfoSnapshot(FStreamConnectionInfoSnapshot& outInfo) const
+	{
+		return m_connectionInfo.Get(outInfo);
+	}
+	// Any thread, number of views of the current connection's render config
+	uint32 GetNumViews() const;
+	void UpdateResolutionFraction();
+	// Game thread, swaps the stream's dynamic resolution state in or restores the engine's default one
+	void SetDynamicResolutionInstalled(bool install);
+	// Game thread, follows the negotiated frame rate and holds the frame back to the client's pose cadence
+	void UpdateFramePacing();
+	// Any thread, feeds a pose returned by pullViewPose to the client clock, the frame pacer and the pose history
+	void OnViewPosePulled(const IsarXrPose& pose, double pullTime);
+	// Any thread, returns whether ISAR accepted the frame
+	bool PushFrame(const IsarGraphicsApiFrame& frame, uint64 timelineFrame);
+	void OnFramePushed(double poseReceivedTime);
+	// Clip planes in meters sent with every frame, the streamed depth is encoded for the same range
+	void GetDepthRange(float& outNearZ, float& outFarZ) const;
+	// Post processing callback, streams the scene depth and samples it for the focus plane. Scene color is untouched.
+	FScreenPassTexture StreamSceneDepth_RenderThread(FRDGBuilder& graphBuilder, const FSceneView& view,
+													 const FPostProcessMaterialInputs& inputs);
+	// Renders the scene depth of a view into the [0, 1] depth of the streamed clip planes
+	void AddDepthPass(FRDGBuilder& graphBuilder, const FSceneView& view, FRDGTextureRef sceneDepth,
+					  const FIntRect& inputRect, FRDGTextureRef outputTexture, const FIntRect& outputRect,
+					  ERenderTargetLoadAction loadAction) const;
+	// Submit thread, hands the swapchain image of a pushed or dropped frame back
+	void OnFrameSubmissionComplete(const FStreamFrameSubmission& submission, bool pushed);
 	void UpdateDeviceLocations();
 	void GetPositionRotation(const XrVector3f& position, const XrQuaternionf& orientation, FVector& outPosition,
 							 FQuat& outOrientation);
@@ -16,7 +16,15 @@
 static TAutoConsoleVariable<int32> CVarStreamSwapchainRetryCount(
 	TEXT("vr.StreamSwapchainRetryCount"),
 	9,
-	TEXT("Number of times the Stream plugin will attempt to wait for the next swapchain image."),
+	TEXT("Number of times the Stream plugin will attempt to wait for the next swapchain image.\n")
+	TEXT("Each attempt waits up to 1 ms for the encoder to release an image, after that the frame is dropped."),
+	ECVF_RenderThreadSafe);
+
+static TAutoConsoleVariable<int32> CVarStreamSwapchainLength(
+	TEXT("vr.StreamSwapchainLength"),
+	3,
+	TEXT("Number of images in the Stream swapchain, so the engine can render while earlier frames are encoded.\n")
+	TEXT("Takes effect the next time the swapchain is created. Clamped to 2-8, since the encoder keeps the last frame."),
 	ECVF_RenderThreadSafe);
 
 FStreamXRSwapchain::FStreamXRSwapchain(TArray<FTextureRHIRef>&& inRHITextureSwapChain,
@@ -24,25 +32,87 @@ FStreamXRSwapchain::FStreamXRSwapchain(TArray<FTextureRHIRef>&& inRHITextureSwap
 									   XrSwapchain inHandle) : FXRSwapChain(MoveTemp(inRHITextureSwapChain),
 																			inRHITexture),
 															   m_handle(inHandle),
+															   m_imageQueue(GetSwapChainLength() - NUM_SPARE_IMAGES),
 															   m_imageAcquired(false),
-															   m_imageReady(false)
+															   m_imageReady(false),
+															   m_imageDiscarded(false),
+															   m_droppedImages(0)
 {
 }
 
 void FStreamXRSwapchain::IncrementSwapChainIndex_RHIThread()
 {
 	bool wasAcquired = false;
-	m_imageAcquired.compare_exchange_strong(wasAcquired, true);
+	if (!m_imageAcquired.compare_exchange_strong(wasAcquired, true))
+	{
+		// The last image was neither submitted nor released, keep rendering into it
+		return;
+	}
+
 	SCOPED_NAMED_EVENT(AcquireImage, FColor::Red);
-	uint32_t swapChainIndex = 0;
-	RHITexture = RHITextureSwapChain[swapChainIndex];
+	// The submit thread releases an image once the next frame was pushed, which is usually shortly away
+	const int32 retryCount = FMath::Max(CVarStreamSwapchainRetryCount.GetValueOnAnyThread(), 0);
+	int32 swapChainIndex = m_imageQueue.AcquireWait(retryCount * ACQUIRE_RETRY_SECONDS);
+	m_imageDiscarded = swapChainIndex == INDEX_NONE;
+	if (m_imageDiscarded)
+	{
+		// The encoder may still read every submitted image, render into the spare one and drop the frame
+		swapChainIndex = m_imageQueue.Num();
+		m_droppedImages.fetch_add(1, std::memory_order_relaxed);
+		UE_LOG(LogHMD, Verbose, TEXT("FStreamSwapchain: all %d images are in use by the encoder, dropping the frame"),
+			   m_imageQueue.Num());
+	}
+
 	SwapChainIndex_RHIThread = swapChainIndex;
+	GDynamicRHI->RHIAliasTextureResources(RHITexture, RHITextureSwapChain[swapChainIndex]);
+	m_imageReady = true;
 	UE_LOG(LogHMD, VeryVerbose,
 		   TEXT(
 			   "FStreamSwapchain::IncrementSwapChainIndex_RHIThread() Acquired image %d in swapchain %p metal texture: 0x%x"
 		   ), swapChainIndex, reinterpret_cast<const void*>(m_handle), RHITexture.GetReference()->GetNativeResource());
 }
 
+void FStreamXRSwapchain::ReleaseCurrentImage_RHIThread(IRHICommandContext* rhiCmdContext)
+{
+	bool wasAcquired = true;
+	if (m_imageAcquired.compare_exchange_strong(wasAcquired, false))
+	{
+		m_imageReady = false;
+		if (!m_imageDiscarded)
+		{
+			m_imageQueue.Release(SwapChainIndex_RHIThread);
+		}
+	}
+}
+
+void FStreamXRSwapchain::SubmitCurrentImage_RHIThread(uint64 completionValue)
+{
+	bool wasAcquired = true;
+	if (m_imageAcquired.compare_exchange_strong(wasAcquired, false))
+	{
+		m_imageReady = false;
+		if (ensure(!m_imageDiscarded))
+		{
+			m_imageQueue.Submit(SwapChainIndex_RHIThread, completionValue);
+		}
+	}
+}
+
+void FStreamXRSwapchain::ReleaseCompletedImages(uint64 completedValue)
+{
+	m_imageQueue.ReleaseCompleted(completedValue);
+}
+
+void FStreamXRSwapchain::ReleaseSubmittedImage(int32 index, uint64 completionValue)
+{
+	m_imageQueue.ReleaseSubmitted(index, completionValue);
+}
+
+int32 FStreamXRSwapchain::GetDesiredSwapchainLength()
+{
+	return FMath::Clamp(CVarStreamSwapchainLength.GetValueOnAnyThread(), 2, 8);
+}
+
 uint8 FStreamXRSwapchain::GetNearestSupportedSwapchainFormat(uint8 requestedFormat,
 															 TFunction<uint32(uint8)> toPlatformFormat /*= nullptr*/)
 {
@@ -50,6 +120,17 @@ uint8 FStreamXRSwapchain::GetNearestSupportedSwapchainFormat(uint8 requestedForm
 	return (toPlatformFormat(PF_R8G8B8A8) == requestedFormat) ? requestedFormat : PF_Unknown;
 }
 
+// Depth is streamed as a single channel float image, every other request gets the R8 G8 B8 A8 color format
+static EPixelFormat GetStreamSwapchainPixelFormat(uint8 requestedFormat)
+{
+	return requestedFormat == PF_R32_FLOAT ? PF_R32_FLOAT : PF_R8G8B8A8;
+}
+
+static DXGI_FORMAT GetStreamSwapchainDXGIFormat(EPixelFormat pixelFormat)
+{
+	return pixelFormat == PF_R32_FLOAT ? DXGI_FORMAT_R32_FLOAT : DXGI_FORMAT_R8G8B8A8_UNORM;
+}
+
 FXRSwapChainPtr CreateSwapchain_D3D11(uint8 format, uint8& outActualFormat, uint32 sizeX, uint32 sizeY,
 									  uint32 arraySize, uint32 numMips, uint32 numSamples,
 									  ETextureCreateFlags createFlags, const FClearValueBinding& clearValueBinding,
@@ -60,31 +141,40 @@ FXRSwapChainPtr CreateSwapchain_D3D11(uint8 format, uint8& outActualFormat, uint
 		return GetID3D11DynamicRHI()->RHIGetSwapChainFormat(static_cast<EPixelFormat>(inFormat));
 	};
 
+	const EPixelFormat pixelFormat = GetStreamSwapchainPixelFormat(format);
 	outActualFormat = format;
 	XrSwapchain swapchain = 0;
 	ID3D11DynamicRHI* d3d11RHI = GetID3D11DynamicRHI();
-	ID3D11Texture2D* pTexture = nullptr;
 	TArray<FTextureRHIRef> textureChain;
 	D3D11_TEXTURE2D_DESC textureDesc = {};
 	textureDesc.Width = sizeX; // 2880 936 HoloLens 1 resolution, for HoloLens 2, it is 1440 936 // 4800 2400
 	textureDesc.Height = sizeY; // HoloLens 1 aspect ratio
 	textureDesc.MipLevels = 1;
 	textureDesc.ArraySize = 1;
-	textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	textureDesc.Format = GetStreamSwapchainDXGIFormat(pixelFormat);
 	textureDesc.SampleDesc.Count = 1;
 	textureDesc.Usage = D3D11_USAGE_DEFAULT;
 	textureDesc.BindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
 
-	HRESULT hr = d3d11RHI->RHIGetDevice()->CreateTexture2D(&textureDesc, nullptr, &pTexture);
-	if (hr != S_OK || !pTexture)
+	const int32 swapchainLength =
+		FStreamXRSwapchain::GetDesiredSwapchainLength() + FStreamXRSwapchain::NUM_SPARE_IMAGES;
+	for (int32 imageIndex = 0; imageIndex < swapchainLength; imageIndex++)
 	{
-		UE_LOG(LogTemp, Log, TEXT("Error:Failed to create texture for swapchain "));
-		return FXRSwapChainPtr();
+		ID3D11Texture2D* pTexture = nullptr;
+		HRESULT hr = d3d11RHI->RHIGetDevice()->CreateTexture2D(&textureDesc, nullptr, &pTexture);
+		if (hr != S_OK || !pTexture)
+		{
+			UE_LOG(LogTemp, Log, TEXT("Error:Failed to create texture for swapchain "));
+			return FXRSwapChainPtr();
+		}
+		textureChain.Add(d3d11RHI->RHICreateTexture2DFromResource(pixelFormat, createFlags, clearValueBinding,
+																  pTexture));
+		// The RHI texture holds its own reference
+		pTexture->Release();
 	}
-	textureChain.Add(
-		d3d11RHI->RHICreateTexture2DFromResource(EPixelFormat::PF_R8G8B8A8, createFlags, clearValueBinding, pTexture));
 
-	return CreateXRSwapChain<FStreamXRSwapchain>(MoveTemp(textureChain), (FTextureRHIRef&)textureChain[0], swapchain);
+	FTextureRHIRef aliasedTexture = GDynamicRHI->RHICreateAliasedTexture(textureChain[0]);
+	return CreateXRSwapChain<FStreamXRSwapchain>(MoveTemp(textureChain), aliasedTexture, swapchain);
 	// For now no depth texture
 }
 
@@ -99,14 +189,15 @@ FXRSwapChainPtr CreateSwapchain_D3D12(uint8 format, uint8& outActualFormat, uint
 		return GetID3D12DynamicRHI()->RHIGetSwapChainFormat(static_cast<EPixelFormat>(inFormat));
 	};
 
-	outActualFormat = DXGI_FORMAT_R8G8B8A8_UNORM;
+	const EPixelFormat pixelFormat = GetStreamSwapchainPixelFormat(format);
+	outActualFormat = GetStreamSwapchainDXGIFormat(pixelFormat);
 	XrSwapchain swapchain = 0;
 	ID3D12DynamicRHI* d3d12RHI = GetID3D12DynamicRHI();
 	TArray<FTextureRHIRef> textureChain;
 	D3D12_HEAP_PROPERTIES heapProps = {};
 	heapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
 	D3D12_CLEAR_VALUE clearValue = {};
-	clearValue.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	clearValue.Format = GetStreamSwapchainDXGIFormat(pixelFormat);
 	clearValue.Color[0] = 1.0f;
 	clearValue.Color[1] = 0.0f;
 	clearValue.Color[2] = 0.0f;
@@ -115,9 +206,8 @@ FXRSwapChainPtr CreateSwapchain_D3D12(uint8 format, uint8& outActualFormat, uint
 	// Create a texture
 	// Get the texture from Client
 	D3D12_RESOURCE_DESC textureDesc = {};
-	ID3D12Resource* pTexture = nullptr;
 	textureDesc.MipLevels = 1;
-	textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	textureDesc.Format = GetStreamSwapchainDXGIFormat(pixelFormat);
 	textureDesc.Alignment = 0;
 	textureDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
 	textureDesc.Width = sizeX;
@@ -127,24 +217,32 @@ FXRSwapChainPtr CreateSwapchain_D3D12(uint8 format, uint8& outActualFormat, uint
 	textureDesc.SampleDesc.Count = 1;
 	textureDesc.SampleDesc.Quality = 0;
 	textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
-	const D3D12_RESOURCE_ALLOCATION_INFO allocationInfo = GetID3D12DynamicRHI()->RHIGetDevice(0)->
-		GetResourceAllocationInfo(0, 1, &textureDesc);
 	ID3D12Device* pID3D12Device = GetID3D12DynamicRHI()->RHIGetDevice(0);
-	HRESULT hr = pID3D12Device->CreateCommittedResource(
-		&heapProps,
-		D3D12_HEAP_FLAG_NONE,
-		&textureDesc,
-		D3D12_RESOURCE_STATE_COPY_DEST,
-		nullptr,
-		IID_PPV_ARGS(&pTexture));
-
-	if (FAILED(hr) || S_FALSE == hr)
+
+	const int32 swapchainLength =
+		FStreamXRSwapchain::GetDesiredSwapchainLength() + FStreamXRSwapchain::NUM_SPARE_IMAGES;
+	for (int32 imageIndex = 0; imageIndex < swapchainLength; imageIndex++)
 	{
-		// Handle the error (e.g., log it or throw an exception)
-		pTexture = nullptr;
-		return FXRSwapChainPtr();
+		ID3D12Resource* pTexture = nullptr;
+		HRESULT hr = pID3D12Device->CreateCommittedResource(
+			&heapProps,
+			D3D12_HEAP_FLAG_NONE,
+			&textureDesc,
+			D3D12_RESOURCE_STATE_COPY_DEST,
+			nullptr,
+			IID_PPV_ARGS(&pTexture));
+
+		if (FAILED(hr) || S_FALSE == hr)
+		{
+			// Handle the error (e.g., log it or throw an exception)
+			return FXRSwapChainPtr();
+		}
+		textureChain.Add(static_cast<FTextureRHIRef>((d3d12RHI->RHICreateTexture2DFromResource(
+			pixelFormat, createFlags, clearValueBinding, pTexture))));
+		// The RHI texture holds its own reference
+		pTexture->Release();
 	}
-	textureChain.Add(static_cast<FTextureRHIRef>((d3d12RHI->RHICreateTexture2DFromResource(EPixelFormat::PF_R8G8B8A8,
-		createFlags, clearValueBinding, pTexture))));
-	return CreateXRSwapChain<FStreamXRSwapchain>(MoveTemp(textureChain), (FTextureRHIRef&)textureChain[0], swapchain);
+
+	FTextureRHIRef aliasedTexture = GDynamicRHI->RHICreateAliasedTexture(textureChain[0]);
+	return CreateXRSwapChain<FStreamXRSwapchain>(MoveTemp(textureChain), aliasedTexture, swapchain);
 }
\ No newline at end of file
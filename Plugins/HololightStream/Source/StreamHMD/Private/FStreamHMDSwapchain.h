@@ -9,6 +9,14 @@
 
 #include "XRSwapChain.h"
 
+#include "FStreamSwapchainImageQueue.h"
+
+/// <summary>
+/// Ring of textures the engine renders into while ISAR encodes earlier frames. RHITexture is an alias of the image
+/// acquired for the current frame, the image queue decides which one that is and when the encoder gives it back.
+/// The last texture is a spare that never reaches the encoder. When the encoder still holds every other image after a
+/// bounded wait, the frame is rendered into the spare and dropped instead of overwriting an image being encoded.
+/// </summary>
 class FStreamXRSwapchain : public FXRSwapChain
 {
 public:
@@ -17,16 +25,37 @@ public:
 	~FStreamXRSwapchain() override = default;
 
 	void IncrementSwapChainIndex_RHIThread() override final;
+	// Gives the current image back without it being encoded, e.g. when the frame was not pushed
+	void ReleaseCurrentImage_RHIThread(IRHICommandContext* rhiCmdContext) override final;
+	// Hands the current image to the encoder, it is not acquired again before completionValue is released
+	void SubmitCurrentImage_RHIThread(uint64 completionValue);
+	void ReleaseCompletedImages(uint64 completedValue);
+	// Gives back an image that was submitted but never reached the encoder
+	void ReleaseSubmittedImage(int32 index, uint64 completionValue);
+	// True if the current frame is rendered into the spare image and must not be submitted
+	bool IsCurrentImageDiscarded_RHIThread() const { return m_imageDiscarded; }
 	XrSwapchain GetHandle() { return m_handle; }
+	// Number of frames dropped because the encoder held every image
+	uint64 GetDroppedImageCount() const { return m_droppedImages.load(std::memory_order_relaxed); }
 	static uint8 GetNearestSupportedSwapchainFormat(uint8 requestedFormat,
 													TFunction<uint32(uint8)> toPlatformFormat = nullptr);
+	// Number of images the encoder can hold, the swapchain is created with one spare texture on top
+	static int32 GetDesiredSwapchainLength();
+
+	static constexpr int32 NUM_SPARE_IMAGES = 1;
 
 protected:
+	static constexpr double ACQUIRE_RETRY_SECONDS = 0.001;
+
 	XrSwapchain m_handle;
+	FStreamSwapchainImageQueue m_imageQueue;
 	/** Whether the image associated with the swapchain has been acquired. */
 	std::atomic<bool> m_imageAcquired;
 	/** Whether the image associated with the swapchain is ready for being written to. */
 	std::atomic<bool> m_imageReady;
+	/** Whether the current frame renders into the spare image. */
+	bool m_imageDiscarded;
+	std::atomic<uint64> m_droppedImages;
 };
 
 FXRSwapChainPtr CreateSwapchain_D3D11(uint8 format, uint8& outActualFormat, uint32 sizeX, uint32 sizeY,
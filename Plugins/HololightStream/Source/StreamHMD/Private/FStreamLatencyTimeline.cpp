@@ -0,0 +1,254 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#include "FStreamLatencyTimeline.h"
+
+#include "HeadMountedDisplayTypes.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "ProfilingDebugging/CountersTrace.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "Trace/Trace.inl"
+
+CSV_DEFINE_CATEGORY(StreamLatency, true);
+
+// Enable with -trace=StreamLatency, every finished frame is logged with all its stage times
+UE_TRACE_CHANNEL_DEFINE(StreamLatencyChannel);
+
+UE_TRACE_EVENT_BEGIN(StreamLatency, FrameTimeline)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(int64, PoseTimestamp)
+	UE_TRACE_EVENT_FIELD(int64, FrameTimestamp)
+	UE_TRACE_EVENT_FIELD(double[], StageTimes)
+UE_TRACE_EVENT_END()
+
+TRACE_DECLARE_FLOAT_COUNTER(StreamLatencyGameToRender, TEXT("Stream/Latency/GameToRenderMs"));
+TRACE_DECLARE_FLOAT_COUNTER(StreamLatencyPoseToCorrection, TEXT("Stream/Latency/PoseToCorrectionMs"));
+TRACE_DECLARE_FLOAT_COUNTER(StreamLatencyCorrectionToPush, TEXT("Stream/Latency/CorrectionToPushMs"));
+TRACE_DECLARE_FLOAT_COUNTER(StreamLatencyPush, TEXT("Stream/Latency/PushMs"));
+TRACE_DECLARE_FLOAT_COUNTER(StreamLatencyEncoderHold, TEXT("Stream/Latency/EncoderHoldMs"));
+TRACE_DECLARE_FLOAT_COUNTER(StreamLatencyPoseToEncoder, TEXT("Stream/Latency/PoseToEncoderMs"));
+
+double FStreamLatencyRecord::GetIntervalMs(EStreamLatencyStage from, EStreamLatencyStage to) const
+{
+	const double fromTime = GetStageTime(from);
+	const double toTime = GetStageTime(to);
+	return fromTime > 0.0 && toTime > 0.0 ? (toTime - fromTime) * 1000.0 : 0.0;
+}
+
+FStreamLatencyTimeline::FStreamLatencyTimeline() : m_nextFrame(0),
+												   m_lastPushedFrame(0)
+{
+}
+
+uint64 FStreamLatencyTimeline::BeginFrame(int64 poseTimestamp, int64 frameTimestamp)
+{
+	const uint64 frame = m_nextFrame.fetch_add(1, std::memory_order_relaxed) + 1;
+	FSlot& slot = m_slots[frame % CAPACITY];
+
+	// Readers skip the slot until the new frame is published, so they never mix two frames
+	slot.frame.store(0, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	slot.poseTimestamp.store(poseTimestamp, std::memory_order_relaxed);
+	slot.frameTimestamp.store(frameTimestamp, std::memory_order_relaxed);
+	for (std::atomic<double>& stageTime : slot.stageTimes)
+	{
+		stageTime.store(0.0, std::memory_order_relaxed);
+	}
+	slot.frame.store(frame, std::memory_order_release);
+	return frame;
+}
+
+void FStreamLatencyTimeline::MarkStage(uint64 frame, EStreamLatencyStage stage, double time)
+{
+	if (frame == 0 || stage >= EStreamLatencyStage::Count)
+	{
+		return;
+	}
+
+	FSlot& slot = m_slots[frame % CAPACITY];
+	if (slot.frame.load(std::memory_order_acquire) == frame)
+	{
+		slot.stageTimes[static_cast<int32>(stage)].store(time, std::memory_order_relaxed);
+	}
+}
+
+void FStreamLatencyTimeline::OnFramePushed(uint64 frame, double time)
+{
+	if (frame == 0)
+	{
+		return;
+	}
+
+	MarkStage(frame, EStreamLatencyStage::PushEnd, time);
+	const uint64 encodedFrame = m_lastPushedFrame.exchange(frame, std::memory_order_acq_rel);
+	if (encodedFrame == 0 || encodedFrame >= frame)
+	{
+		return;
+	}
+
+	MarkStage(encodedFrame, EStreamLatencyStage::EncoderRelease, time);
+	FStreamLatencyRecord record;
+	if (ReadRecord(encodedFrame, record))
+	{
+		PublishRecord(record);
+	}
+}
+
+void FStreamLatencyTimeline::GetRecords(TArray<FStreamLatencyRecord>& outRecords, int32 maxRecords) const
+{
+	outRecords.Reset();
+	const uint64 newestFrame = m_nextFrame.load(std::memory_order_acquire);
+	const uint64 count = FMath::Min<uint64>(FMath::Clamp(maxRecords, 0, CAPACITY), newestFrame);
+	outRecords.Reserve(static_cast<int32>(count));
+	for (uint64 frame = newestFrame - count + 1; frame <= newestFrame; frame++)
+	{
+		FStreamLatencyRecord record;
+		if (ReadRecord(frame, record))
+		{
+			outRecords.Add(record);
+		}
+	}
+}
+
+void FStreamLatencyTimeline::LogRecords(int32 maxRecords) const
+{
+	TArray<FStreamLatencyRecord> records;
+	GetRecords(records, maxRecords);
+	UE_LOG(LogHMD, Display, TEXT("Stream latency timeline, %d frames, ms since the game frame start:"), records.Num());
+	for (const FStreamLatencyRecord& record : records)
+	{
+		FString stages;
+		const double startTime = record.GetStageTime(EStreamLatencyStage::GameFrameStart);
+		for (int32 stageIndex = 0; stageIndex < STAGE_COUNT; stageIndex++)
+		{
+			const double stageTime = record.stageTimes[stageIndex];
+			if (stageTime > 0.0 && startTime > 0.0)
+			{
+				stages += FString::Printf(TEXT(" %s=%.2f"), GetStageName(static_cast<EStreamLatencyStage>(stageIndex)),
+										  (stageTime - startTime) * 1000.0);
+			}
+		}
+		UE_LOG(LogHMD, Display, TEXT("  Pose %lld Frame %lld:%s"), record.poseTimestamp, record.frameTimestamp,
+			   *stages);
+	}
+}
+
+FString FStreamLatencyTimeline::WriteCsv(const FString& fileName) const
+{
+	TArray<FStreamLatencyRecord> records;
+	GetRecords(records);
+
+	FString csv = TEXT("PoseTimestamp,FrameTimestamp");
+	for (int32 stageIndex = 0; stageIndex < STAGE_COUNT; stageIndex++)
+	{
+		csv += FString::Printf(TEXT(",%sMs"), GetStageName(static_cast<EStreamLatencyStage>(stageIndex)));
+	}
+	csv += LINE_TERMINATOR;
+
+	for (const FStreamLatencyRecord& record : records)
+	{
+		csv += FString::Printf(TEXT("%lld,%lld"), record.poseTimestamp, record.frameTimestamp);
+		const double startTime = record.GetStageTime(EStreamLatencyStage::GameFrameStart);
+		for (int32 stageIndex = 0; stageIndex < STAGE_COUNT; stageIndex++)
+		{
+			const double stageTime = record.stageTimes[stageIndex];
+			// Stages a frame did not reach are left empty
+			csv += stageTime > 0.0 && startTime > 0.0
+				? FString::Printf(TEXT(",%.3f"), (stageTime - startTime) * 1000.0)
+				: FString(TEXT(","));
+		}
+		csv += LINE_TERMINATOR;
+	}
+
+	const FString filePath = FPaths::Combine(FPaths::ProfilingDir(), TEXT("StreamLatency"),
+											 fileName.IsEmpty()
+												 ? FString::Printf(TEXT("StreamLatency-%s.csv"),
+																   *FDateTime::Now().ToString())
+												 : fileName);
+	if (!FFileHelper::SaveStringToFile(csv, *filePath))
+	{
+		UE_LOG(LogHMD, Error, TEXT("Failed to write the Stream latency timeline to %s"), *filePath);
+		return FString();
+	}
+	return filePath;
+}
+
+const TCHAR* FStreamLatencyTimeline::GetStageName(EStreamLatencyStage stage)
+{
+	switch (stage)
+	{
+	case EStreamLatencyStage::GameFrameStart:
+		return TEXT("GameFrameStart");
+	case EStreamLatencyStage::RenderBegin:
+		return TEXT("RenderBegin");
+	case EStreamLatencyStage::PosePull:
+		return TEXT("PosePull");
+	case EStreamLatencyStage::CorrectionPass:
+		return TEXT("CorrectionPass");
+	case EStreamLatencyStage::PushBegin:
+		return TEXT("PushBegin");
+	case EStreamLatencyStage::PushEnd:
+		return TEXT("PushEnd");
+	case EStreamLatencyStage::EncoderRelease:
+		return TEXT("EncoderRelease");
+	default:
+		return TEXT("Unknown");
+	}
+}
+
+bool FStreamLatencyTimeline::ReadRecord(uint64 frame, FStreamLatencyRecord& outRecord) const
+{
+	const FSlot& slot = m_slots[frame % CAPACITY];
+	if (slot.frame.load(std::memory_order_acquire) != frame)
+	{
+		return false;
+	}
+
+	outRecord.poseTimestamp = slot.poseTimestamp.load(std::memory_order_relaxed);
+	outRecord.frameTimestamp = slot.frameTimestamp.load(std::memory_order_relaxed);
+	for (int32 stageIndex = 0; stageIndex < STAGE_COUNT; stageIndex++)
+	{
+		outRecord.stageTimes[stageIndex] = slot.stageTimes[stageIndex].load(std::memory_order_relaxed);
+	}
+
+	// The slot may have been rewritten for a newer frame while it was copied
+	std::atomic_thread_fence(std::memory_order_acquire);
+	return slot.frame.load(std::memory_order_relaxed) == frame;
+}
+
+void FStreamLatencyTimeline::PublishRecord(const FStreamLatencyRecord& record) const
+{
+	const double gameToRenderMs = record.GetIntervalMs(EStreamLatencyStage::GameFrameStart,
+													   EStreamLatencyStage::RenderBegin);
+	const double poseToCorrectionMs = record.GetIntervalMs(EStreamLatencyStage::PosePull,
+														   EStreamLatencyStage::CorrectionPass);
+	const double correctionToPushMs = record.GetIntervalMs(EStreamLatencyStage::CorrectionPass,
+														   EStreamLatencyStage::PushBegin);
+	const double pushMs = record.GetIntervalMs(EStreamLatencyStage::PushBegin, EStreamLatencyStage::PushEnd);
+	const double encoderHoldMs = record.GetIntervalMs(EStreamLatencyStage::PushEnd,
+													  EStreamLatencyStage::EncoderRelease);
+	const double poseToEncoderMs = record.GetIntervalMs(EStreamLatencyStage::PosePull,
+														EStreamLatencyStage::EncoderRelease);
+
+	CSV_CUSTOM_STAT(StreamLatency, GameToRenderMs, gameToRenderMs, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(StreamLatency, PoseToCorrectionMs, poseToCorrectionMs, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(StreamLatency, CorrectionToPushMs, correctionToPushMs, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(StreamLatency, PushMs, pushMs, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(StreamLatency, EncoderHoldMs, encoderHoldMs, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(StreamLatency, PoseToEncoderMs, poseToEncoderMs, ECsvCustomStatOp::Set);
+
+	TRACE_COUNTER_SET(StreamLatencyGameToRender, gameToRenderMs);
+	TRACE_COUNTER_SET(StreamLatencyPoseToCorrection, poseToCorrectionMs);
+	TRACE_COUNTER_SET(StreamLatencyCorrectionToPush, correctionToPushMs);
+	TRACE_COUNTER_SET(StreamLatencyPush, pushMs);
+	TRACE_COUNTER_SET(StreamLatencyEncoderHold, encoderHoldMs);
+	TRACE_COUNTER_SET(StreamLatencyPoseToEncoder, poseToEncoderMs);
+
+	UE_TRACE_LOG(StreamLatency, FrameTimeline, StreamLatencyChannel)
+		<< FrameTimeline.Cycle(FPlatformTime::Cycles64())
+		<< FrameTimeline.PoseTimestamp(record.poseTimestamp)
+		<< FrameTimeline.FrameTimestamp(record.frameTimestamp)
+		<< FrameTimeline.StageTimes(record.stageTimes, STAGE_COUNT);
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#ifndef HOLOLIGHT_UNREAL_FSTREAMLATENCYTIMELINE_H
+#define HOLOLIGHT_UNREAL_FSTREAMLATENCYTIMELINE_H
+
+#include "CoreMinimal.h"
+
+#include <atomic>
+
+// In the order a frame passes them
+enum class EStreamLatencyStage : uint8
+{
+	// Start of the game frame that simulated the frame
+	GameFrameStart,
+	RenderBegin,
+	// The render thread pulled the pose the frame is rendered with
+	PosePull,
+	// The correction pass, the last pass before the frame is pushed, was handed to the RHI thread
+	CorrectionPass,
+	PushBegin,
+	PushEnd,
+	// ISAR has no per frame encoder callback. It keeps reading a frame until the next one was pushed, so the frame
+	// is counted as encoded once pushFrame returned for the next frame.
+	EncoderRelease,
+	Count
+};
+
+struct FStreamLatencyRecord
+{
+	int64 poseTimestamp = 0;
+	int64 frameTimestamp = 0;
+	// Platform time in seconds, zero if the frame did not reach the stage, e.g. because it was dropped
+	double stageTimes[static_cast<int32>(EStreamLatencyStage::Count)] = {};
+
+	double GetStageTime(EStreamLatencyStage stage) const { return stageTimes[static_cast<int32>(stage)]; }
+	// Zero unless the frame reached both stages
+	double GetIntervalMs(EStreamLatencyStage from, EStreamLatencyStage to) const;
+};
+
+/// <summary>
+/// Records when every streamed frame passed each stage of the pipeline, from the game frame to the encoder, so motion
+/// to photon latency can be attributed to a stage in a running session. Frames are kept in a fixed ring that the
+/// game, render, RHI and submit threads write to without locking. A frame is found through the handle BeginFrame
+/// returns and not through its poseTimestamp, which repeats when no new pose arrived between two frames.
+/// Finished frames are published as CSV stats and Unreal Insights counters, and to the StreamLatency trace channel.
+/// </summary>
+class FStreamLatencyTimeline
+{
+public:
+	FStreamLatencyTimeline();
+
+	FStreamLatencyTimeline(const FStreamLatencyTimeline&) = delete;
+	FStreamLatencyTimeline& operator=(const FStreamLatencyTimeline&) = delete;
+
+	// Render thread, starts the record of the frame rendered with this pose and returns its handle
+	uint64 BeginFrame(int64 poseTimestamp, int64 frameTimestamp);
+	// Any thread, ignored if the handle is zero or its record was already overwritten
+	void MarkStage(uint64 frame, EStreamLatencyStage stage, double time);
+	// Any thread, marks the end of the push and the encoder release of the frame pushed before it
+	void OnFramePushed(uint64 frame, double time);
+
+	// Any thread, copies the newest records, oldest first
+	void GetRecords(TArray<FStreamLatencyRecord>& outRecords, int32 maxRecords = CAPACITY) const;
+	void LogRecords(int32 maxRecords) const;
+	// Writes all records with their stage times relative to the game frame start, returns the file name
+	FString WriteCsv(const FString& fileName) const;
+
+	static const TCHAR* GetStageName(EStreamLatencyStage stage);
+
+private:
+	static constexpr int32 CAPACITY = 256;
+	static constexpr int32 STAGE_COUNT = static_cast<int32>(EStreamLatencyStage::Count);
+
+	struct FSlot
+	{
+		// Handle of the frame the slot holds, zero while it is being rewritten
+		std::atomic<uint64> frame{0};
+		std::atomic<int64> poseTimestamp{0};
+		std::atomic<int64> frameTimestamp{0};
+		std::atomic<double> stageTimes[STAGE_COUNT];
+	};
+
+	FSlot m_slots[CAPACITY];
+	std::atomic<uint64> m_nextFrame;
+	std::atomic<uint64> m_lastPushedFrame;
+
+	bool ReadRecord(uint64 frame, FStreamLatencyRecord& outRecord) const;
+	void PublishRecord(const FStreamLatencyRecord& record) const;
+};
+
+#endif // HOLOLIGHT_UNREAL_FSTREAMLATENCYTIMELINE_H
\ No newline at end of file
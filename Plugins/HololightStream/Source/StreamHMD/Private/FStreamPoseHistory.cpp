@@ -0,0 +1,133 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#include "FStreamPoseHistory.h"
+
+// Keeps the client's coordinate system, unlike ToFQuat, the pose is interpolated and sent back as it is
+static FQuat ToQuat(const isar::IsarQuaternion& orientation)
+{
+	return FQuat(orientation.x, orientation.y, orientation.z, orientation.w);
+}
+
+static isar::IsarPose InterpolateIsarPose(const isar::IsarPose& from, const isar::IsarPose& to, double alpha)
+{
+	isar::IsarPose pose;
+	pose.position.x = static_cast<float>(FMath::Lerp<double>(from.position.x, to.position.x, alpha));
+	pose.position.y = static_cast<float>(FMath::Lerp<double>(from.position.y, to.position.y, alpha));
+	pose.position.z = static_cast<float>(FMath::Lerp<double>(from.position.z, to.position.z, alpha));
+
+	// Slerp takes the shortest arc and keeps rotating along it for alpha above one
+	FQuat orientation = FQuat::Slerp(ToQuat(from.orientation), ToQuat(to.orientation), alpha);
+	orientation.Normalize();
+	pose.orientation.x = static_cast<float>(orientation.X);
+	pose.orientation.y = static_cast<float>(orientation.Y);
+	pose.orientation.z = static_cast<float>(orientation.Z);
+	pose.orientation.w = static_cast<float>(orientation.W);
+	return pose;
+}
+
+FStreamPoseHistory::FStreamPoseHistory() : m_head(0),
+										   m_count(0)
+{
+}
+
+void FStreamPoseHistory::Reset()
+{
+	FScopeLock lock(&m_lock);
+	m_head = 0;
+	m_count = 0;
+}
+
+void FStreamPoseHistory::AddPose(const isar::IsarXrPose& pose, double poseTime)
+{
+	FScopeLock lock(&m_lock);
+	if (m_count > 0)
+	{
+		const FStreamPoseSample& latest = GetSample(m_count - 1);
+		// The mapping of a restarted client clock starts at the current time, so its poses are still newer
+		if (pose.poseTimestamp == latest.pose.poseTimestamp || poseTime <= latest.time)
+		{
+			// Pulled again, or pulled by the other thread after a newer pose
+			return;
+		}
+	}
+
+	m_samples[m_head] = {poseTime, pose};
+	m_head = (m_head + 1) % CAPACITY;
+	m_count = FMath::Min(m_count + 1, CAPACITY);
+}
+
+bool FStreamPoseHistory::GetLatestPose(FStreamPoseSample& outSample) const
+{
+	FScopeLock lock(&m_lock);
+	if (m_count == 0)
+	{
+		return false;
+	}
+
+	outSample = GetSample(m_count - 1);
+	return true;
+}
+
+bool FStreamPoseHistory::SamplePose(double targetTime, isar::IsarXrPose& outPose) const
+{
+	FScopeLock lock(&m_lock);
+	if (m_count == 0)
+	{
+		return false;
+	}
+
+	const FStreamPoseSample& latest = GetSample(m_count - 1);
+	if (m_count == 1 || targetTime <= GetSample(0).time)
+	{
+		outPose = m_count == 1 ? latest.pose : GetSample(0).pose;
+		return true;
+	}
+
+	if (targetTime >= latest.time)
+	{
+		const FStreamPoseSample& previous = GetSample(m_count - 2);
+		const double interval = latest.time - previous.time;
+		const double maxAlpha = interval > 0.0 ? 1.0 + MAX_EXTRAPOLATION / interval : 1.0;
+		outPose = InterpolatePose(previous, latest, targetTime, maxAlpha);
+		return true;
+	}
+
+	// Newest first, the target is usually close to the newest pose
+	for (int32 index = m_count - 1; index > 0; index--)
+	{
+		const FStreamPoseSample& from = GetSample(index - 1);
+		if (from.time <= targetTime)
+		{
+			outPose = InterpolatePose(from, GetSample(index), targetTime);
+			return true;
+		}
+	}
+
+	outPose = GetSample(0).pose;
+	return true;
+}
+
+int32 FStreamPoseHistory::Num() const
+{
+	FScopeLock lock(&m_lock);
+	return m_count;
+}
+
+isar::IsarXrPose FStreamPoseHistory::InterpolatePose(const FStreamPoseSample& from, const FStreamPoseSample& to,
+													 double targetTime, double maxAlpha)
+{
+	const double interval = to.time - from.time;
+	const double alpha = interval > 0.0 ? FMath::Clamp((targetTime - from.time) / interval, 0.0, maxAlpha) : 1.0;
+
+	isar::IsarXrPose pose = to.pose;
+	pose.poseLeft = InterpolateIsarPose(from.pose.poseLeft, to.pose.poseLeft, alpha);
+	pose.poseRight = InterpolateIsarPose(from.pose.poseRight, to.pose.poseRight, alpha);
+	return pose;
+}
+
+const FStreamPoseSample& FStreamPoseHistory::GetSample(int32 index) const
+{
+	return m_samples[(m_head - m_count + index + CAPACITY) % CAPACITY];
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#ifndef HOLOLIGHT_UNREAL_FSTREAMPOSEHISTORY_H
+#define HOLOLIGHT_UNREAL_FSTREAMPOSEHISTORY_H
+
+#include "StreamHMDCommon.h"
+
+struct FStreamPoseSample
+{
+	// Platform time in seconds the client created the pose at, as mapped by FStreamClientClock
+	double time = 0.0;
+	isar::IsarXrPose pose = {};
+};
+
+/// <summary>
+/// Keeps the last poses the client sent with the time the client created them at, so the pose a frame is rendered
+/// with can be sampled for any point in time instead of only taking the newest one. Keyed by the client's time, the
+/// poses keep their spacing whatever the network delay and whenever they were pulled. Poses in between two are
+/// interpolated, poses after the newest one are extrapolated from the last two for a limited time.
+/// The timestamps of a sampled pose are those of the newest pose it was made from, which is the pose the client
+/// reprojects the frame against. All times are passed in, in seconds, so recorded poses can be replayed.
+/// </summary>
+class FStreamPoseHistory
+{
+public:
+	FStreamPoseHistory();
+
+	// Any thread, drops all poses of the previous connection
+	void Reset();
+	// Any thread, poseTime is the pose timestamp mapped to platform time. A pose that is already in the history or
+	// older than the newest one is ignored.
+	void AddPose(const isar::IsarXrPose& pose, double poseTime);
+	// Any thread, returns false while the history is empty
+	bool GetLatestPose(FStreamPoseSample& outSample) const;
+	bool SamplePose(double targetTime, isar::IsarXrPose& outPose) const;
+	int32 Num() const;
+
+	// Interpolates between two samples, alpha is clamped to [0, maxAlpha] so a pose is only extrapolated that far
+	static isar::IsarXrPose InterpolatePose(const FStreamPoseSample& from, const FStreamPoseSample& to,
+											double targetTime, double maxAlpha = 1.0);
+
+private:
+	static constexpr int32 CAPACITY = 64;
+	// Longest time a pose is extrapolated past the newest one, further predictions overshoot on head turns
+	static constexpr double MAX_EXTRAPOLATION = 0.05;
+
+	mutable FCriticalSection m_lock;
+	FStreamPoseSample m_samples[CAPACITY];
+	// Index the next pose is written to
+	int32 m_head;
+	int32 m_count;
+
+	// Oldest first, only called with the lock held
+	const FStreamPoseSample& GetSample(int32 index) const;
+};
+
+#endif // HOLOLIGHT_UNREAL_FSTREAMPOSEHISTORY_H
\ No newline at end of file
@@ -0,0 +1,139 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#include "FStreamResolutionController.h"
+
+CSV_DEFINE_CATEGORY(StreamResolution, true);
+
+static TAutoConsoleVariable<int32> CVarStreamDynamicResolution(
+	TEXT("vr.StreamDynamicResolution"),
+	0,
+	TEXT("Whether the render resolution follows the GPU frame time, the encode queue and the stream bitrate.\n")
+	TEXT("Applied through the engine dynamic resolution, which r.DynamicRes.OperationMode has to enable."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarStreamDynamicResolutionMinFraction(
+	TEXT("vr.StreamDynamicResolution.MinFraction"),
+	0.5f,
+	TEXT("Lowest fraction of the streamed resolution the scene is rendered at."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarStreamDynamicResolutionMaxFraction(
+	TEXT("vr.StreamDynamicResolution.MaxFraction"),
+	1.0f,
+	TEXT("Highest fraction of the streamed resolution the scene is rendered at, at most 1."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarStreamDynamicResolutionTargetGPUUtilization(
+	TEXT("vr.StreamDynamicResolution.TargetGPUUtilization"),
+	0.85f,
+	TEXT("Part of the client frame time the GPU should be busy for."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarStreamDynamicResolutionMinBitsPerPixel(
+	TEXT("vr.StreamDynamicResolution.MinBitsPerPixel"),
+	0.02f,
+	TEXT("Encoded bits every streamed pixel should at least get, the resolution is lowered if the bitrate is short of it.\n")
+	TEXT("0 ignores the bitrate."),
+	ECVF_Default);
+
+FStreamResolutionSettings FStreamResolutionSettings::FromConsoleVariables()
+{
+	FStreamResolutionSettings settings;
+	settings.enabled = CVarStreamDynamicResolution.GetValueOnGameThread() != 0;
+	settings.minFraction = CVarStreamDynamicResolutionMinFraction.GetValueOnGameThread();
+	settings.maxFraction = CVarStreamDynamicResolutionMaxFraction.GetValueOnGameThread();
+	settings.targetGPUUtilization = CVarStreamDynamicResolutionTargetGPUUtilization.GetValueOnGameThread();
+	settings.minBitsPerPixel = CVarStreamDynamicResolutionMinBitsPerPixel.GetValueOnGameThread();
+	return settings;
+}
+
+FStreamResolutionController::FStreamResolutionController() : m_resolutionFraction(1.0f),
+															 m_smoothedGPUTimeMs(0.0),
+															 m_smoothedQueueDepth(0.0),
+															 m_framesSinceChange(0)
+{
+}
+
+float FStreamResolutionController::Update(const FStreamResolutionSample& sample,
+										  const FStreamResolutionSettings& settings)
+{
+	const float maxFraction = FMath::Clamp(settings.maxFraction, 0.1f, 1.0f);
+	const float minFraction = FMath::Clamp(settings.minFraction, 0.1f, maxFraction);
+	m_framesSinceChange++;
+
+	if (sample.gpuFrameTimeMs > 0.0)
+	{
+		m_smoothedGPUTimeMs = m_smoothedGPUTimeMs > 0.0
+			? FMath::Lerp(m_smoothedGPUTimeMs, sample.gpuFrameTimeMs, GPU_TIME_SMOOTHING)
+			: sample.gpuFrameTimeMs;
+	}
+	m_smoothedQueueDepth = FMath::Lerp(m_smoothedQueueDepth, static_cast<double>(sample.encodeQueueDepth),
+									   QUEUE_DEPTH_SMOOTHING);
+	const bool encoderBehind = m_smoothedQueueDepth > ENCODE_QUEUE_PRESSURE;
+
+	float desiredFraction = m_resolutionFraction;
+	const double gpuBudgetMs = sample.targetFrameTimeMs * settings.targetGPUUtilization;
+	if (gpuBudgetMs > 0.0 && m_smoothedGPUTimeMs > 0.0)
+	{
+		// The GPU cost scales with the pixel count, which is the square of the fraction
+		const double gpuLoad = m_smoothedGPUTimeMs / gpuBudgetMs;
+		const float loadFraction = m_resolutionFraction * static_cast<float>(FMath::Sqrt(1.0 / gpuLoad));
+		if (gpuLoad > 1.0 + settings.hysteresis)
+		{
+			desiredFraction = loadFraction;
+		}
+		else if (gpuLoad < 1.0 - settings.hysteresis && !encoderBehind &&
+			m_framesSinceChange >= settings.increaseCooldownFrames)
+		{
+			desiredFraction = FMath::Min(loadFraction, m_resolutionFraction + MAX_FRACTION_INCREASE);
+		}
+	}
+
+	if (encoderBehind)
+	{
+		// Frames pile up in front of the encoder, it cannot keep up with the pixels it is given
+		desiredFraction = FMath::Min(desiredFraction, m_resolutionFraction - MIN_FRACTION_STEP);
+	}
+
+	desiredFraction = FMath::Clamp(FMath::Min(desiredFraction, GetBitrateLimit(sample, settings)), minFraction,
+								   maxFraction);
+
+	// Small changes are skipped, unless they reach a limit the fraction would otherwise never settle on. The
+	// tolerance keeps a step of exactly MIN_FRACTION_STEP from being lost to float rounding.
+	const bool reachesLimit = desiredFraction == minFraction || desiredFraction == maxFraction;
+	if (FMath::Abs(desiredFraction - m_resolutionFraction) >= MIN_FRACTION_STEP - UE_KINDA_SMALL_NUMBER ||
+		(reachesLimit && desiredFraction != m_resolutionFraction))
+	{
+		m_resolutionFraction = desiredFraction;
+		m_framesSinceChange = 0;
+	}
+
+	CSV_CUSTOM_STAT(StreamResolution, ResolutionFraction, m_resolutionFraction, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(StreamResolution, SmoothedGPUTimeMs, static_cast<float>(m_smoothedGPUTimeMs),
+					ECsvCustomStatOp::Set);
+	return m_resolutionFraction;
+}
+
+void FStreamResolutionController::Reset()
+{
+	m_resolutionFraction = 1.0f;
+	m_smoothedGPUTimeMs = 0.0;
+	m_smoothedQueueDepth = 0.0;
+	m_framesSinceChange = 0;
+}
+
+float FStreamResolutionController::GetBitrateLimit(const FStreamResolutionSample& sample,
+												   const FStreamResolutionSettings& settings) const
+{
+	if (settings.minBitsPerPixel <= 0.0f || sample.bitrateKbps <= 0 || sample.framerate <= 0 ||
+		sample.fullResolutionPixels <= 0)
+	{
+		return 1.0f;
+	}
+
+	const double bitsPerFrame = sample.bitrateKbps * 1000.0 / sample.framerate;
+	const double affordablePixels = bitsPerFrame / settings.minBitsPerPixel;
+	return static_cast<float>(FMath::Sqrt(affordablePixels / sample.fullResolutionPixels));
+}
\ No newline at end of file
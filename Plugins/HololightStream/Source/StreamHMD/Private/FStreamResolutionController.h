@@ -0,0 +1,77 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#ifndef HOLOLIGHT_UNREAL_FSTREAMRESOLUTIONCONTROLLER_H
+#define HOLOLIGHT_UNREAL_FSTREAMRESOLUTIONCONTROLLER_H
+
+#include "CoreMinimal.h"
+
+struct FStreamResolutionSettings
+{
+	bool enabled = true;
+	float minFraction = 0.5f;
+	float maxFraction = 1.0f;
+	// Part of the frame time the GPU should be busy for, the rest is headroom for spikes
+	float targetGPUUtilization = 0.85f;
+	// Relative band around the GPU budget in which the resolution is left alone
+	float hysteresis = 0.1f;
+	// Encoded bits the stream should at least have per pixel, below that a smaller image encodes with less artifacts
+	float minBitsPerPixel = 0.02f;
+	// Frames to wait after a change before the resolution is raised again
+	int32 increaseCooldownFrames = 30;
+
+	// Game thread, reads the vr.StreamDynamicResolution console variables
+	static FStreamResolutionSettings FromConsoleVariables();
+};
+
+struct FStreamResolutionSample
+{
+	double gpuFrameTimeMs = 0.0;
+	double targetFrameTimeMs = 0.0;
+	// Frames waiting to be pushed to the encoder
+	int32 encodeQueueDepth = 0;
+	int32 bitrateKbps = 0;
+	int32 framerate = 0;
+	// Pixels of all views at a resolution fraction of one
+	int64 fullResolutionPixels = 0;
+};
+
+/// <summary>
+/// Picks the fraction of the streamed resolution the scene is rendered at, so the GPU keeps up with the client frame
+/// rate and the encoder is not given more pixels than its bitrate can carry. Only the view rect is scaled, the upscaler
+/// still outputs the full size image, so the render target and the swapchain never have to be reallocated. The
+/// controller only does the math on the samples it is given and is driven once per game frame.
+/// </summary>
+class FStreamResolutionController
+{
+public:
+	FStreamResolutionController();
+
+	// Returns the resolution fraction for the next frame
+	float Update(const FStreamResolutionSample& sample, const FStreamResolutionSettings& settings);
+	float GetResolutionFraction() const { return m_resolutionFraction; }
+	// Starts over at the maximum fraction, e.g. for a new connection
+	void Reset();
+
+private:
+	// Weight of the newest sample in the smoothed GPU time
+	static constexpr double GPU_TIME_SMOOTHING = 0.1;
+	// Smallest change that is applied, smaller ones are not worth a different resolution
+	static constexpr float MIN_FRACTION_STEP = 0.02f;
+	// Largest raise per update, lowering is not limited so a GPU spike is handled within a few frames
+	static constexpr float MAX_FRACTION_INCREASE = 0.05f;
+	// Weight of the newest sample in the smoothed encode queue depth
+	static constexpr double QUEUE_DEPTH_SMOOTHING = 0.2;
+	// Smoothed queue depth above which the encoder is considered behind, a single waiting frame is normal
+	static constexpr double ENCODE_QUEUE_PRESSURE = 0.5;
+
+	float m_resolutionFraction;
+	double m_smoothedGPUTimeMs;
+	double m_smoothedQueueDepth;
+	int32 m_framesSinceChange;
+
+	float GetBitrateLimit(const FStreamResolutionSample& sample, const FStreamResolutionSettings& settings) const;
+};
+
+#endif // HOLOLIGHT_UNREAL_FSTREAMRESOLUTIONCONTROLLER_H
\ No newline at end of file
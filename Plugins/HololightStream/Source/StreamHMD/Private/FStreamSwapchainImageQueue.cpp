@@ -0,0 +1,155 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#include "FStreamSwapchainImageQueue.h"
+
+FStreamSwapchainImageQueue::FStreamSwapchainImageQueue(int32 numImages)
+	: m_releaseSerial(0)
+{
+	check(numImages > 0);
+	m_images.SetNum(numImages);
+	for (FImage& image : m_images)
+	{
+		image.releaseSerial = m_releaseSerial++;
+	}
+}
+
+int32 FStreamSwapchainImageQueue::Acquire()
+{
+	std::scoped_lock lock(m_lock);
+	return AcquireLocked();
+}
+
+int32 FStreamSwapchainImageQueue::AcquireWait(double timeoutSeconds)
+{
+	std::unique_lock lock(m_lock);
+
+	int32 acquired = AcquireLocked();
+	if (acquired == INDEX_NONE && timeoutSeconds > 0.0)
+	{
+		m_releasedCv.wait_for(lock, std::chrono::duration<double>(timeoutSeconds),
+							  [this, &acquired]
+							  {
+								  acquired = AcquireLocked();
+								  return acquired != INDEX_NONE;
+							  });
+	}
+	return acquired;
+}
+
+void FStreamSwapchainImageQueue::Submit(int32 index, uint64 completionValue)
+{
+	std::scoped_lock lock(m_lock);
+	check(m_images.IsValidIndex(index));
+
+	FImage& image = m_images[index];
+	if (!ensure(image.state == EImageState::Acquired))
+	{
+		return;
+	}
+	image.state = EImageState::Submitted;
+	image.completionValue = completionValue;
+}
+
+void FStreamSwapchainImageQueue::Release(int32 index)
+{
+	std::scoped_lock lock(m_lock);
+	check(m_images.IsValidIndex(index));
+
+	FImage& image = m_images[index];
+	if (image.state != EImageState::Free)
+	{
+		ReleaseLocked(image);
+	}
+}
+
+bool FStreamSwapchainImageQueue::ReleaseSubmitted(int32 index, uint64 completionValue)
+{
+	std::scoped_lock lock(m_lock);
+	check(m_images.IsValidIndex(index));
+
+	FImage& image = m_images[index];
+	if (image.state != EImageState::Submitted || image.completionValue != completionValue)
+	{
+		return false;
+	}
+	ReleaseLocked(image);
+	return true;
+}
+
+int32 FStreamSwapchainImageQueue::ReleaseCompleted(uint64 completedValue)
+{
+	std::scoped_lock lock(m_lock);
+
+	int32 released = 0;
+	for (FImage& image : m_images)
+	{
+		if (image.state == EImageState::Submitted && image.completionValue <= completedValue)
+		{
+			ReleaseLocked(image);
+			released++;
+		}
+	}
+	return released;
+}
+
+void FStreamSwapchainImageQueue::ReleaseAll()
+{
+	std::scoped_lock lock(m_lock);
+
+	for (FImage& image : m_images)
+	{
+		if (image.state != EImageState::Free)
+		{
+			ReleaseLocked(image);
+		}
+	}
+}
+
+int32 FStreamSwapchainImageQueue::NumFree() const
+{
+	std::scoped_lock lock(m_lock);
+
+	int32 numFree = 0;
+	for (const FImage& image : m_images)
+	{
+		numFree += image.state == EImageState::Free ? 1 : 0;
+	}
+	return numFree;
+}
+
+FStreamSwapchainImageQueue::EImageState FStreamSwapchainImageQueue::GetState(int32 index) const
+{
+	std::scoped_lock lock(m_lock);
+	check(m_images.IsValidIndex(index));
+	return m_images[index].state;
+}
+
+int32 FStreamSwapchainImageQueue::AcquireLocked()
+{
+	int32 acquired = INDEX_NONE;
+	for (int32 index = 0; index < m_images.Num(); index++)
+	{
+		const FImage& image = m_images[index];
+		if (image.state == EImageState::Free &&
+			(acquired == INDEX_NONE || image.releaseSerial < m_images[acquired].releaseSerial))
+		{
+			acquired = index;
+		}
+	}
+
+	if (acquired != INDEX_NONE)
+	{
+		m_images[acquired].state = EImageState::Acquired;
+	}
+	return acquired;
+}
+
+void FStreamSwapchainImageQueue::ReleaseLocked(FImage& image)
+{
+	image.state = EImageState::Free;
+	image.completionValue = 0;
+	image.releaseSerial = m_releaseSerial++;
+	m_releasedCv.notify_all();
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#ifndef HOLOLIGHT_UNREAL_FSTREAMSWAPCHAINIMAGEQUEUE_H
+#define HOLOLIGHT_UNREAL_FSTREAMSWAPCHAINIMAGEQUEUE_H
+
+#include "CoreMinimal.h"
+
+#include <condition_variable>
+#include <mutex>
+
+/// <summary>
+/// Tracks which images of a swapchain are free, being rendered to or still used by the encoder. It does not know about
+/// any graphics API, the swapchain drives it with image indices and the completion values it submits frames with.
+/// Images move Free -> Acquired -> Submitted -> Free. Submitted images can be released in any order, either one by one
+/// or by a completion value, and the least recently released image is always handed out first. A submitted image is
+/// never handed out again before it was released, since the encoder may still read it.
+/// </summary>
+class FStreamSwapchainImageQueue
+{
+public:
+	enum class EImageState : uint8
+	{
+		Free,
+		Acquired,
+		Submitted
+	};
+
+	explicit FStreamSwapchainImageQueue(int32 numImages);
+
+	FStreamSwapchainImageQueue(const FStreamSwapchainImageQueue&) = delete;
+	FStreamSwapchainImageQueue& operator=(const FStreamSwapchainImageQueue&) = delete;
+
+	// Returns the free image that was released the longest time ago, or INDEX_NONE if no image is free
+	int32 Acquire();
+	// Waits up to timeoutSeconds for an image to be released when none is free, returns INDEX_NONE if none was
+	int32 AcquireWait(double timeoutSeconds);
+	// Hands an acquired image to the encoder, it stays in use until its completion value is released
+	void Submit(int32 index, uint64 completionValue);
+	// Frees an acquired or submitted image
+	void Release(int32 index);
+	// Frees the image only if it is still submitted with this completion value, so an image that was released and
+	// acquired again in the meantime is left alone
+	bool ReleaseSubmitted(int32 index, uint64 completionValue);
+	// Frees every submitted image whose completion value is at or below completedValue, returns how many were freed
+	int32 ReleaseCompleted(uint64 completedValue);
+	// Frees all images, e.g. after the GPU was flushed
+	void ReleaseAll();
+
+	int32 Num() const { return m_images.Num(); }
+	int32 NumFree() const;
+	EImageState GetState(int32 index) const;
+
+private:
+	struct FImage
+	{
+		EImageState state = EImageState::Free;
+		uint64 completionValue = 0;
+		// Order in which the image became free, the smallest free serial is acquired next
+		uint64 releaseSerial = 0;
+	};
+
+	mutable std::mutex m_lock;
+	// Notified whenever an image becomes free
+	std::condition_variable m_releasedCv;
+	TArray<FImage> m_images;
+	uint64 m_releaseSerial;
+
+	int32 AcquireLocked();
+	void ReleaseLocked(FImage& image);
+};
+
+#endif // HOLOLIGHT_UNREAL_FSTREAMSWAPCHAINIMAGEQUEUE_H
\ No newline at end of file
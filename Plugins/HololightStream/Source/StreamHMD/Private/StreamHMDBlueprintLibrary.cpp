@@ -82,4 +82,38 @@ bool UStreamHMDBlueprintLibrary::GetConnectionInfo(FStreamConnectionInfo& Connec
 	}
 
 	return false;
+}
+
+void UStreamHMDBlueprintLibrary::SetFocusPlaneSource(EStreamFocusPlaneSource Source)
+{
+	if (auto* streamHMD = GetStreamHMD())
+	{
+		streamHMD->SetFocusPlaneSource(Source);
+	}
+}
+
+EStreamFocusPlaneSource UStreamHMDBlueprintLibrary::GetFocusPlaneSource()
+{
+	if (auto* streamHMD = GetStreamHMD())
+	{
+		return streamHMD->GetFocusPlaneSource();
+	}
+
+	return EStreamFocusPlaneSource::Disabled;
+}
+
+void UStreamHMDBlueprintLibrary::SetFocusPlaneTarget(FVector WorldLocation)
+{
+	if (auto* streamHMD = GetStreamHMD())
+	{
+		streamHMD->SetFocusPlaneTarget(WorldLocation);
+	}
+}
+
+void UStreamHMDBlueprintLibrary::ClearFocusPlaneTarget()
+{
+	if (auto* streamHMD = GetStreamHMD())
+	{
+		streamHMD->ClearFocusPlaneTarget();
+	}
 }
\ No newline at end of file
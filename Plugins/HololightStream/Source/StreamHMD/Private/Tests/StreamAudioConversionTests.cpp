@@ -0,0 +1,168 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#include "Misc/AutomationTest.h"
+
+#include "FStreamAudioListener.h"
+#include "StreamAudio.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+using namespace stream::audio;
+
+namespace
+{
+struct FPcm16KernelCase
+{
+	const TCHAR* name;
+	FFloatToPcm16Kernel toPcm16;
+	FPcm16ToFloatKernel toFloat;
+};
+
+TArray<FPcm16KernelCase> GetVectorKernels()
+{
+	TArray<FPcm16KernelCase> kernels;
+#if PLATFORM_CPU_X86_FAMILY
+	kernels.Add({TEXT("SSE2"), &FloatToPcm16_SSE2, &Pcm16ToFloat_SSE2});
+	if (FPlatformMisc::HasAVX2InstructionSupport())
+	{
+		kernels.Add({TEXT("AVX2"), &FloatToPcm16_AVX2, &Pcm16ToFloat_AVX2});
+	}
+#endif
+	return kernels;
+}
+
+// The conversion loop OnNewSubmixBuffer ran before the kernels, with its fresh buffer per callback
+int64 ConvertLikeBaseline(const float* audioData, int32 numSamples)
+{
+	TArray<int16_t> pcmData;
+	pcmData.Reset(numSamples);
+	pcmData.AddZeroed(numSamples);
+
+	for (int i = 0; i < numSamples; i++)
+	{
+		int32 value = audioData[i] >= 0 ? audioData[i] * int32(MAX_int16) : audioData[i] * (int32(MAX_int16) + 1);
+		pcmData[i] = static_cast<int16_t>(FMath::Clamp(value, int32(MIN_int16), int32(MAX_int16)));
+	}
+	return pcmData[numSamples / 2];
+}
+
+// Normal audio plus the values the kernels have to agree on at the edges. The baseline loop does not clamp its input,
+// so it only gets the normal audio.
+TArray<float> MakeTestSignal(int32 count, bool withEdges = true)
+{
+	TArray<float> samples;
+	samples.SetNumUninitialized(count);
+	const float edges[] = {0.0f, -0.0f, 1.0f, -1.0f, 1.5f, -1.5f, 0.99999f, -0.99999f, 1.0f / 65536.0f,
+						   -1.0f / 65536.0f, 1e30f, -1e30f};
+	uint32 seed = 1;
+	for (int32 i = 0; i < count; i++)
+	{
+		seed = seed * 1664525u + 1013904223u;
+		const bool isEdge = withEdges && i < int32(UE_ARRAY_COUNT(edges));
+		samples[i] = isEdge ? edges[i] : (seed >> 8) / float(1 << 23) * 2.4f - 1.2f;
+	}
+	return samples;
+}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamAudioPcm16EquivalenceTest, "HololightStream.Audio.Pcm16.Equivalence",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamAudioPcm16EquivalenceTest::RunTest(const FString& Parameters)
+{
+	int16_t edges[4] = {};
+	const float edgeInput[4] = {1.0f, -1.0f, 2.0f, -2.0f};
+	FloatToPcm16_Scalar(edgeInput, edges, 4);
+	TestEqual(TEXT("1.0 maps to MAX_int16"), edges[0], int16_t(MAX_int16));
+	TestEqual(TEXT("-1.0 maps to MIN_int16"), edges[1], int16_t(MIN_int16));
+	TestEqual(TEXT("Values above 1.0 are clamped"), edges[2], int16_t(MAX_int16));
+	TestEqual(TEXT("Values below -1.0 are clamped"), edges[3], int16_t(MIN_int16));
+
+	const TArray<float> input = MakeTestSignal(4099);
+	TArray<int16_t> expected;
+	expected.SetNumUninitialized(input.Num());
+	TArray<int16_t> actual;
+	actual.SetNumUninitialized(input.Num());
+	TArray<float> expectedFloat;
+	expectedFloat.SetNumUninitialized(input.Num());
+	TArray<float> actualFloat;
+	actualFloat.SetNumUninitialized(input.Num());
+
+	for (const FPcm16KernelCase& kernel : GetVectorKernels())
+	{
+		// Every length up to a few vectors, so all tail lengths of the vector loops are covered
+		for (int32 count = 0; count <= input.Num(); count += count < 64 ? 1 : 1009)
+		{
+			FloatToPcm16_Scalar(input.GetData(), expected.GetData(), count);
+			kernel.toPcm16(input.GetData(), actual.GetData(), count);
+			if (FMemory::Memcmp(expected.GetData(), actual.GetData(), count * sizeof(int16_t)) != 0)
+			{
+				AddError(FString::Printf(TEXT("%s FloatToPcm16 differs from the scalar kernel for %d samples"),
+										 kernel.name, count));
+			}
+
+			Pcm16ToFloat_Scalar(expected.GetData(), expectedFloat.GetData(), count);
+			kernel.toFloat(expected.GetData(), actualFloat.GetData(), count);
+			if (FMemory::Memcmp(expectedFloat.GetData(), actualFloat.GetData(), count * sizeof(float)) != 0)
+			{
+				AddError(FString::Printf(TEXT("%s Pcm16ToFloat differs from the scalar kernel for %d samples"),
+										 kernel.name, count));
+			}
+		}
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamAudioPcm16BenchmarkTest, "HololightStream.Audio.Pcm16.Benchmark",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::PerfFilter)
+
+bool FStreamAudioPcm16BenchmarkTest::RunTest(const FString& Parameters)
+{
+	// Stereo blocks of one packet and of common submix buffer sizes, each converted as often as ten minutes of
+	// audio at 48 kHz take
+	const int32 blockFrames[] = {FStreamAudioListener::BUFFER_SIZE, 1024, 4096};
+	constexpr int32 numChannels = 2;
+	constexpr int64 totalSamples = int64(FStreamAudioListener::SAMPLE_RATE) * 600 * numChannels;
+
+	TArray<FPcm16KernelCase> kernels = GetVectorKernels();
+	kernels.Insert(FPcm16KernelCase{TEXT("Scalar"), &FloatToPcm16_Scalar, &Pcm16ToFloat_Scalar}, 0);
+	for (const int32 frames : blockFrames)
+	{
+		const int32 samples = frames * numChannels;
+		const int32 iterations = static_cast<int32>(totalSamples / samples);
+		const TArray<float> input = MakeTestSignal(samples, false);
+		TArray<int16_t> output;
+		output.SetNumUninitialized(samples);
+
+		double start = FPlatformTime::Seconds();
+		int64 checksum = 0;
+		for (int32 i = 0; i < iterations; i++)
+		{
+			checksum += ConvertLikeBaseline(input.GetData(), samples);
+		}
+		const double baselineNs = (FPlatformTime::Seconds() - start) * 1e9 / (double(iterations) * samples);
+		AddInfo(FString::Printf(TEXT("%d stereo frames, baseline loop: %.3f ns per sample"), frames, baselineNs));
+
+		for (const FPcm16KernelCase& kernel : kernels)
+		{
+			start = FPlatformTime::Seconds();
+			for (int32 i = 0; i < iterations; i++)
+			{
+				kernel.toPcm16(input.GetData(), output.GetData(), samples);
+				checksum += output[i % samples];
+			}
+			const double nsPerSample = (FPlatformTime::Seconds() - start) * 1e9 / (double(iterations) * samples);
+			AddInfo(FString::Printf(TEXT("%d stereo frames, FloatToPcm16 %s: %.3f ns per sample, %.2fx the loop"),
+									frames, kernel.name, nsPerSample, baselineNs / nsPerSample));
+		}
+		// Keeps the conversions from being optimized away
+		TestTrue(TEXT("Conversions ran"), checksum != MAX_int64);
+	}
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
\ No newline at end of file
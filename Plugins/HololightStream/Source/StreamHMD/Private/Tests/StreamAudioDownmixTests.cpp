@@ -0,0 +1,126 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#include "Misc/AutomationTest.h"
+
+#include "StreamAudioDownmix.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+using namespace stream::audio;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamAudioDownmixCoefficientTest, "HololightStream.Audio.Downmix.Coefficients",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamAudioDownmixCoefficientTest::RunTest(const FString& Parameters)
+{
+	constexpr float minus3dB = 0.70710678f;
+	FStreamAudioDownmix downmix;
+
+	TestFalse(TEXT("No input channels"), downmix.Configure(0, 2));
+	TestFalse(TEXT("More input channels than supported"), downmix.Configure(9, 2));
+	TestFalse(TEXT("Upmixing"), downmix.Configure(1, 2));
+
+	// 5.1: FL, FR, FC, LFE, SL, SR
+	TestTrue(TEXT("5.1 to stereo"), downmix.Configure(6, 2));
+	const float left51[6] = {1.0f, 0.0f, minus3dB, 0.0f, minus3dB, 0.0f};
+	const float right51[6] = {0.0f, 1.0f, minus3dB, 0.0f, 0.0f, minus3dB};
+	for (int32 channel = 0; channel < 6; channel++)
+	{
+		TestEqual(FString::Printf(TEXT("5.1 left gain of channel %d"), channel), downmix.GetCoefficient(0, channel),
+				  left51[channel]);
+		TestEqual(FString::Printf(TEXT("5.1 right gain of channel %d"), channel), downmix.GetCoefficient(1, channel),
+				  right51[channel]);
+	}
+
+	// 7.1: FL, FR, FC, LFE, BL, BR, SL, SR
+	TestTrue(TEXT("7.1 to stereo"), downmix.Configure(8, 2));
+	const float left71[8] = {1.0f, 0.0f, minus3dB, 0.0f, minus3dB, 0.0f, minus3dB, 0.0f};
+	const float right71[8] = {0.0f, 1.0f, minus3dB, 0.0f, 0.0f, minus3dB, 0.0f, minus3dB};
+	for (int32 channel = 0; channel < 8; channel++)
+	{
+		TestEqual(FString::Printf(TEXT("7.1 left gain of channel %d"), channel), downmix.GetCoefficient(0, channel),
+				  left71[channel]);
+		TestEqual(FString::Printf(TEXT("7.1 right gain of channel %d"), channel), downmix.GetCoefficient(1, channel),
+				  right71[channel]);
+	}
+
+	TestTrue(TEXT("Quad to stereo"), downmix.Configure(4, 2));
+	TestEqual(TEXT("Quad back left goes left"), downmix.GetCoefficient(0, 2), minus3dB);
+	TestEqual(TEXT("Quad back right goes right"), downmix.GetCoefficient(1, 3), minus3dB);
+	TestEqual(TEXT("Quad back left does not go right"), downmix.GetCoefficient(1, 2), 0.0f);
+
+	TestTrue(TEXT("5.1 to mono"), downmix.Configure(6, 1));
+	TestEqual(TEXT("Mono takes half of each front channel"), downmix.GetCoefficient(0, 0), 0.5f);
+	TestEqual(TEXT("Mono takes the center at -3 dB"), downmix.GetCoefficient(0, 2), minus3dB);
+	TestEqual(TEXT("Mono drops LFE"), downmix.GetCoefficient(0, 3), 0.0f);
+	TestEqual(TEXT("Mono has no second row"), downmix.GetCoefficient(1, 0), 0.0f);
+
+	TestTrue(TEXT("Odd layout to stereo"), downmix.Configure(3, 2));
+	for (int32 channel = 0; channel < 3; channel++)
+	{
+		TestEqual(TEXT("Odd layouts fold evenly into the left"), downmix.GetCoefficient(0, channel), 1.0f / 3.0f);
+		TestEqual(TEXT("Odd layouts fold evenly into the right"), downmix.GetCoefficient(1, channel), 1.0f / 3.0f);
+	}
+
+	TestTrue(TEXT("Mono passthrough"), downmix.Configure(1, 1));
+	TestEqual(TEXT("Mono input keeps its level"), downmix.GetCoefficient(0, 0), 1.0f);
+
+	TestTrue(TEXT("Reconfigure 5.1"), downmix.Configure(6, 2));
+	downmix.SetCoefficient(0, 3, 0.5f);
+	TestEqual(TEXT("Overridden gain is kept"), downmix.GetCoefficient(0, 3), 0.5f);
+	TestTrue(TEXT("Configuration is reported"), downmix.IsConfiguredFor(6, 2));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamAudioDownmixProcessTest, "HololightStream.Audio.Downmix.Process",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamAudioDownmixProcessTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 numFrames = 37;
+	const int32 layouts[][2] = {{2, 1}, {3, 2}, {4, 1}, {4, 2}, {6, 1}, {6, 2}, {8, 1}, {8, 2}};
+	for (const auto& layout : layouts)
+	{
+		const int32 inputChannels = layout[0];
+		const int32 outputChannels = layout[1];
+		FStreamAudioDownmix downmix;
+		TestTrue(TEXT("Configure"), downmix.Configure(inputChannels, outputChannels));
+		// Overridden gains have to reach the vector paths as well
+		downmix.SetCoefficient(0, inputChannels - 1, 0.25f);
+
+		TArray<float> input;
+		input.SetNumUninitialized(numFrames * inputChannels);
+		uint32 seed = 7;
+		for (float& sample : input)
+		{
+			seed = seed * 1664525u + 1013904223u;
+			sample = (seed >> 8) / float(1 << 23) - 1.0f;
+		}
+		TArray<float> output;
+		output.SetNumZeroed(numFrames * outputChannels);
+		downmix.Process(input.GetData(), numFrames, output.GetData());
+
+		float maxError = 0.0f;
+		for (int32 frame = 0; frame < numFrames; frame++)
+		{
+			for (int32 outChannel = 0; outChannel < outputChannels; outChannel++)
+			{
+				float expected = 0.0f;
+				for (int32 inChannel = 0; inChannel < inputChannels; inChannel++)
+				{
+					expected += downmix.GetCoefficient(outChannel, inChannel) * input[frame * inputChannels + inChannel];
+				}
+				maxError = FMath::Max(maxError, FMath::Abs(expected - output[frame * outputChannels + outChannel]));
+			}
+		}
+		TestTrue(FString::Printf(TEXT("%d to %d channels follows the gain matrix (max error %g)"), inputChannels,
+								 outputChannels, maxError), maxError < 1e-5f);
+	}
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
\ No newline at end of file
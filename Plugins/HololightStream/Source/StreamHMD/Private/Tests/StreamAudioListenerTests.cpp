@@ -0,0 +1,273 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#include "Misc/AutomationTest.h"
+
+#include "FStreamAudioListener.h"
+
+#include "HAL/IConsoleManager.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+using FClock = std::chrono::steady_clock;
+
+constexpr int32 NUM_CHANNELS = FStreamAudioListener::MAX_NUM_CHANNELS;
+// 5 ms submix buffers, so the queue the push thread sees only moves by half a packet between two callbacks
+constexpr int32 BLOCK_FRAMES = FStreamAudioListener::SAMPLE_RATE / 200;
+constexpr FClock::duration BLOCK_DURATION = std::chrono::microseconds(5000);
+// Puts the queue right in the middle of the band the push thread leaves alone, so real-time pacing with a few
+// milliseconds of scheduling jitter does not stretch or skip
+constexpr int32 TARGET_LATENCY_MS = 28;
+
+// Every frame carries its own number, frame / 8 on the left and frame % 8 on the right channel. Neighbouring frames
+// differ by at most one step on the left, so the ends of a stretched or skipped packet still decode exactly.
+float EncodeSample(uint32 value)
+{
+	return (value + 0.5f) / float(MAX_int16);
+}
+
+uint32 DecodeFrame(const int16_t* frame)
+{
+	return uint32(frame[0]) * 8 + uint32(frame[1]);
+}
+
+/// <summary>
+/// Stands in for pushAudioData. Records which frames every packet carried and can hold the push thread inside a
+/// push until the test opens the gate.
+/// </summary>
+class FMockAudioPush
+{
+public:
+	struct FPacket
+	{
+		uint32 firstFrame;
+		uint32 lastFrame;
+		bool consecutive;
+	};
+
+	isar::IsarError Push(const isar::IsarAudioData& data)
+	{
+		const int16_t* samples = static_cast<const int16_t*>(data.data);
+		const uint32 numFrames = static_cast<uint32>(data.samplesPerChannel);
+		FPacket packet = {DecodeFrame(samples), DecodeFrame(samples + (numFrames - 1) * NUM_CHANNELS), true};
+		for (uint32 frame = 1; frame < numFrames; frame++)
+		{
+			packet.consecutive &= DecodeFrame(samples + frame * NUM_CHANNELS) == packet.firstFrame + frame;
+		}
+
+		std::unique_lock lock(m_mutex);
+		m_packets.Add(packet);
+		m_malformedPackets += data.numberOfChannels != NUM_CHANNELS ||
+			data.samplesPerChannel != FStreamAudioListener::BUFFER_SIZE ||
+			data.sampleRate != FStreamAudioListener::SAMPLE_RATE;
+		m_changed.wait(lock, [this] { return m_gateOpen; });
+		return isar::IsarError::eNone;
+	}
+
+	void Reset()
+	{
+		std::scoped_lock lock(m_mutex);
+		m_packets.Reset();
+		m_malformedPackets = 0;
+		m_gateOpen = true;
+	}
+
+	void SetGateOpen(bool open)
+	{
+		std::scoped_lock lock(m_mutex);
+		m_gateOpen = open;
+		m_changed.notify_all();
+	}
+
+	TArray<FPacket> GetPackets()
+	{
+		std::scoped_lock lock(m_mutex);
+		return m_packets;
+	}
+
+	int32 GetMalformedPackets()
+	{
+		std::scoped_lock lock(m_mutex);
+		return m_malformedPackets;
+	}
+
+private:
+	std::mutex m_mutex;
+	std::condition_variable m_changed;
+	bool m_gateOpen = true;
+	int32 m_malformedPackets = 0;
+	TArray<FPacket> m_packets;
+};
+
+FMockAudioPush GAudioPush;
+
+isar::IsarError MockPushAudioData(isar::IsarConnection connection, isar::IsarAudioData data)
+{
+	return GAudioPush.Push(data);
+}
+
+// Stands in for the audio render thread, calls the listener with numbered frames at 48 kHz in real time
+class FPacedSubmixProducer
+{
+public:
+	explicit FPacedSubmixProducer(FStreamAudioListener& listener) : m_listener(listener)
+	{
+	}
+
+	void Produce(FClock::duration duration)
+	{
+		const FClock::time_point end = m_nextCallback + duration;
+		float block[BLOCK_FRAMES * NUM_CHANNELS];
+		while (m_nextCallback < end)
+		{
+			std::this_thread::sleep_until(m_nextCallback);
+			m_nextCallback += BLOCK_DURATION;
+			for (int32 frame = 0; frame < BLOCK_FRAMES; frame++)
+			{
+				block[frame * NUM_CHANNELS] = EncodeSample((m_nextFrame + frame) / 8);
+				block[frame * NUM_CHANNELS + 1] = EncodeSample((m_nextFrame + frame) % 8);
+			}
+			m_listener.OnNewSubmixBuffer(nullptr, block, BLOCK_FRAMES * NUM_CHANNELS, NUM_CHANNELS,
+										 FStreamAudioListener::SAMPLE_RATE,
+										 double(m_nextFrame) / FStreamAudioListener::SAMPLE_RATE);
+			m_nextFrame += BLOCK_FRAMES;
+		}
+	}
+
+	// The audio render thread is starved, it picks up where it left off afterwards
+	void Stall(FClock::duration duration)
+	{
+		std::this_thread::sleep_for(duration);
+		m_nextCallback = FClock::now();
+	}
+
+	uint32 GetProducedFrames() const { return m_nextFrame; }
+
+private:
+	FStreamAudioListener& m_listener;
+	FClock::time_point m_nextCallback = FClock::now();
+	uint32 m_nextFrame = 0;
+};
+
+class FScopedTargetLatency
+{
+public:
+	FScopedTargetLatency()
+		: m_variable(IConsoleManager::Get().FindConsoleVariable(TEXT("vr.StreamAudioTargetLatencyMs"))),
+		  m_previous(m_variable ? m_variable->GetInt() : 40)
+	{
+		if (m_variable)
+		{
+			m_variable->Set(TARGET_LATENCY_MS, ECVF_SetByCode);
+		}
+	}
+
+	~FScopedTargetLatency()
+	{
+		if (m_variable)
+		{
+			m_variable->Set(m_previous, ECVF_SetByCode);
+		}
+	}
+
+private:
+	IConsoleVariable* m_variable;
+	int32 m_previous;
+};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamAudioListenerRealTimeTest, "HololightStream.Audio.Listener.RealTime",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamAudioListenerRealTimeTest::RunTest(const FString& Parameters)
+{
+	FScopedTargetLatency targetLatency;
+	GAudioPush.Reset();
+	isar::IsarServerApi serverApi = {};
+	serverApi.pushAudioData = &MockPushAudioData;
+
+	FStreamAudioStats stats;
+	uint32 producedFrames = 0;
+	{
+		FStreamAudioListener listener;
+		listener.SetStreamApi(nullptr, &serverApi);
+		listener.SetConnected(true);
+		FPacedSubmixProducer producer(listener);
+
+		// Stays below the two seconds after which the drift estimate starts to correct the pacing
+		producer.Produce(std::chrono::milliseconds(600));
+		// Long enough for the queue to run dry once
+		producer.Stall(std::chrono::milliseconds(100));
+		producer.Produce(std::chrono::milliseconds(400));
+
+		// pushAudioData blocks for longer than the ring holds, the newest audio is refused
+		GAudioPush.SetGateOpen(false);
+		producer.Produce(std::chrono::milliseconds(500));
+		producedFrames = producer.GetProducedFrames();
+		GAudioPush.SetGateOpen(true);
+
+		// The push thread catches up without bursting and runs dry a second time
+		const FClock::time_point timeout = FClock::now() + std::chrono::seconds(5);
+		while (listener.GetStats().underflowCount < 2 && FClock::now() < timeout)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		}
+		stats = listener.GetStats();
+	}
+
+	const TArray<FMockAudioPush::FPacket> packets = GAudioPush.GetPackets();
+	if (!TestTrue(TEXT("Packets are pushed"), packets.Num() > 0))
+	{
+		return false;
+	}
+	TestEqual(TEXT("Every packet has the format the client expects"), GAudioPush.GetMalformedPackets(), 0);
+	TestEqual(TEXT("The first pushed frame is the first produced frame"), packets[0].firstFrame, 0u);
+
+	int32 gaps = 0;
+	int32 correctedPackets = 0;
+	int32 garbledPackets = 0;
+	uint32 pushedFrames = 0;
+	for (int32 index = 0; index < packets.Num(); index++)
+	{
+		const FMockAudioPush::FPacket& packet = packets[index];
+		gaps += index > 0 && packet.firstFrame != packets[index - 1].lastFrame + 1;
+		// Stretched and skipped packets are interpolated in between, only their ends are exact
+		const uint32 readFrames = packet.lastFrame - packet.firstFrame + 1;
+		correctedPackets += readFrames != FStreamAudioListener::BUFFER_SIZE;
+		garbledPackets += readFrames == FStreamAudioListener::BUFFER_SIZE && !packet.consecutive;
+		pushedFrames += readFrames;
+	}
+	TestEqual(TEXT("No frame is lost or pushed twice between packets"), gaps, 0);
+	TestEqual(TEXT("Packets that are not corrected carry their frames unchanged"), garbledPackets, 0);
+	TestEqual(TEXT("Every corrected packet is counted"), uint64(correctedPackets),
+			  stats.stretchedPackets + stats.skippedPackets);
+	TestEqual(TEXT("No packet is held back as silence"), stats.suppressedPackets, uint64(0));
+
+	// Starved once by the producer, once when it stopped
+	TestEqual(TEXT("Every time the queue ran dry is an underflow"), stats.underflowCount, uint64(2));
+
+	// What is left in the ring after the last packet was read
+	const uint32 queuedFrames = static_cast<uint32>(
+		FMath::RoundToInt(stats.queueDepthMs * FStreamAudioListener::SAMPLE_RATE / 1000.0));
+	const uint32 remainingFrames = queuedFrames - (packets.Last().lastFrame - packets.Last().firstFrame + 1);
+	TestTrue(TEXT("The ring overflowed while pushAudioData blocked"), stats.overflowSamples > 0);
+	TestEqual(TEXT("Whole submix buffers are refused"), stats.overflowSamples % (BLOCK_FRAMES * NUM_CHANNELS),
+			  uint64(0));
+	TestEqual(TEXT("The overflow counts exactly the frames that were neither pushed nor left in the ring"),
+			  stats.overflowSamples, uint64(producedFrames - pushedFrames - remainingFrames) * NUM_CHANNELS);
+
+	AddInfo(FString::Printf(TEXT("%d packets, %d corrected, %llu samples refused"), packets.Num(), correctedPackets,
+							stats.overflowSamples));
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
\ No newline at end of file
@@ -0,0 +1,195 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#include "Misc/AutomationTest.h"
+
+#include "StreamAudioResampler.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+using namespace stream::audio;
+
+namespace
+{
+// Resamples a sine in 480 frame blocks and returns the RMS of the output after the filter has settled
+double ResampleSineRms(FStreamAudioResampler& resampler, int32 inputRate, double frequency, int32 numChannels = 1)
+{
+	constexpr int32 blockFrames = 480;
+	constexpr int32 numBlocks = 200;
+	TArray<float> input;
+	input.SetNumUninitialized(blockFrames * numChannels);
+	TArray<float> output;
+	output.SetNumUninitialized(resampler.GetMaxOutputFrames(blockFrames) * numChannels);
+
+	double sumSquares = 0.0;
+	int64 measuredSamples = 0;
+	int64 inputFrame = 0;
+	for (int32 block = 0; block < numBlocks; block++)
+	{
+		for (int32 frame = 0; frame < blockFrames; frame++, inputFrame++)
+		{
+			const float value = FMath::Sin(2.0 * DOUBLE_PI * frequency * inputFrame / inputRate);
+			for (int32 channel = 0; channel < numChannels; channel++)
+			{
+				input[frame * numChannels + channel] = value;
+			}
+		}
+
+		const int32 outputFrames = resampler.Process(input.GetData(), blockFrames, output.GetData());
+		if (block < numBlocks / 4)
+		{
+			continue;
+		}
+		for (int32 sample = 0; sample < outputFrames * numChannels; sample++)
+		{
+			sumSquares += double(output[sample]) * output[sample];
+		}
+		measuredSamples += outputFrames * numChannels;
+	}
+	return FMath::Sqrt(sumSquares / FMath::Max<int64>(measuredSamples, 1));
+}
+
+double ToDecibels(double gain)
+{
+	return 20.0 * FMath::LogX(10.0, FMath::Max(gain, 1e-12));
+}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamAudioResamplerQualityTest, "HololightStream.Audio.Resampler.Quality",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamAudioResamplerQualityTest::RunTest(const FString& Parameters)
+{
+	// A full scale sine has an RMS of 1/sqrt(2)
+	const double fullScaleRms = 1.0 / FMath::Sqrt(2.0);
+	struct FQualityCase
+	{
+		int32 inputRate;
+		int32 outputRate;
+		double passbandFrequency;
+		double stopbandFrequency;
+		double minRejectionDb;
+	};
+	// Stopband tones sit above the output Nyquist frequency, whatever gets through aliases into the audible band
+	const FQualityCase cases[] = {
+		{96000, 48000, 1000.0, 36000.0, 70.0},
+		{192000, 48000, 1000.0, 40000.0, 70.0},
+		{88200, 48000, 1000.0, 36000.0, 70.0},
+		{44100, 48000, 1000.0, 0.0, 0.0},
+		{32000, 48000, 1000.0, 0.0, 0.0},
+	};
+
+	for (const FQualityCase& test : cases)
+	{
+		FStreamAudioResampler resampler;
+		if (!TestTrue(TEXT("Configure"), resampler.Configure(test.inputRate, test.outputRate, 2)))
+		{
+			continue;
+		}
+
+		const double passbandDb = ToDecibels(ResampleSineRms(resampler, test.inputRate, test.passbandFrequency, 2) /
+											 fullScaleRms);
+		TestTrue(FString::Printf(TEXT("%d -> %d passes %.0f Hz at unity gain (%.2f dB)"), test.inputRate,
+								 test.outputRate, test.passbandFrequency, passbandDb), FMath::Abs(passbandDb) < 0.1);
+
+		if (test.stopbandFrequency > 0.0)
+		{
+			resampler.Reset();
+			const double stopbandDb = ToDecibels(ResampleSineRms(resampler, test.inputRate, test.stopbandFrequency, 2) /
+												 fullScaleRms);
+			TestTrue(FString::Printf(TEXT("%d -> %d rejects %.0f Hz by %.0f dB (%.1f dB)"), test.inputRate,
+									 test.outputRate, test.stopbandFrequency, test.minRejectionDb, -stopbandDb),
+					 -stopbandDb >= test.minRejectionDb);
+		}
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamAudioResamplerResetTest, "HololightStream.Audio.Resampler.Reset",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamAudioResamplerResetTest::RunTest(const FString& Parameters)
+{
+	const int32 inputRates[] = {32000, 44100, 96000, 192000};
+	for (const int32 inputRate : inputRates)
+	{
+		FStreamAudioResampler resampler;
+		if (!TestTrue(TEXT("Configure"), resampler.Configure(inputRate, 48000, 2)))
+		{
+			continue;
+		}
+		// Fills the history with a full scale tone
+		ResampleSineRms(resampler, inputRate, 1000.0, 2);
+		resampler.Reset();
+
+		// Shorter than the filter, so every output frame reads from the history
+		const int32 silentFrames = resampler.GetTapsPerPhase() - 1;
+		TArray<float> silence;
+		silence.SetNumZeroed(silentFrames * 2);
+		TArray<float> output;
+		output.SetNumUninitialized(resampler.GetMaxOutputFrames(silentFrames) * 2);
+		const int32 outputFrames = resampler.Process(silence.GetData(), silentFrames, output.GetData());
+
+		float peak = 0.0f;
+		for (int32 sample = 0; sample < outputFrames * 2; sample++)
+		{
+			peak = FMath::Max(peak, FMath::Abs(output[sample]));
+		}
+		TestTrue(FString::Printf(TEXT("%d -> 48000 produces output after a reset"), inputRate), outputFrames > 0);
+		TestEqual(FString::Printf(TEXT("%d -> 48000 is silent after a reset"), inputRate), peak, 0.0f);
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamAudioResamplerBenchmarkTest, "HololightStream.Audio.Resampler.Benchmark",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::PerfFilter)
+
+bool FStreamAudioResamplerBenchmarkTest::RunTest(const FString& Parameters)
+{
+	const int32 inputRates[] = {32000, 44100, 88200, 96000, 192000};
+	for (const int32 inputRate : inputRates)
+	{
+		FStreamAudioResampler resampler;
+		resampler.Configure(inputRate, 48000, 2);
+
+		// Latency is where the response to an impulse peaks, it has to match what the resampler reports
+		TArray<float> impulse;
+		impulse.SetNumZeroed(inputRate / 10 * 2);
+		impulse[0] = 1.0f;
+		impulse[1] = 1.0f;
+		TArray<float> response;
+		response.SetNumUninitialized(resampler.GetMaxOutputFrames(inputRate / 10) * 2);
+		const int32 responseFrames = resampler.Process(impulse.GetData(), inputRate / 10, response.GetData());
+		int32 peakFrame = 0;
+		for (int32 frame = 0; frame < responseFrames; frame++)
+		{
+			peakFrame = response[frame * 2] > response[peakFrame * 2] ? frame : peakFrame;
+		}
+		TestTrue(TEXT("Impulse peaks at the reported latency"),
+				 FMath::Abs(peakFrame - resampler.GetLatencyFrames()) <= 1.0);
+
+		// Ten seconds of stereo audio in 10 ms blocks
+		const int32 blockFrames = inputRate / 100;
+		TArray<float> input;
+		input.SetNumZeroed(blockFrames * 2);
+		TArray<float> output;
+		output.SetNumUninitialized(resampler.GetMaxOutputFrames(blockFrames) * 2);
+		const double start = FPlatformTime::Seconds();
+		for (int32 block = 0; block < 1000; block++)
+		{
+			resampler.Process(input.GetData(), blockFrames, output.GetData());
+		}
+		const double seconds = FPlatformTime::Seconds() - start;
+
+		AddInfo(FString::Printf(TEXT("%d -> 48000: %d taps per phase, latency %.2f ms, %.3f ms per second of audio"),
+								inputRate, resampler.GetTapsPerPhase(), resampler.GetLatencyFrames() / 48.0,
+								seconds * 100.0));
+	}
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
\ No newline at end of file
@@ -0,0 +1,129 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#include "Misc/AutomationTest.h"
+
+#include "StreamAudioRingBuffer.h"
+
+#include <atomic>
+#include <thread>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+using namespace stream::audio;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamAudioRingBufferWrapTest, "HololightStream.Audio.RingBuffer.Wrap",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamAudioRingBufferWrapTest::RunTest(const FString& Parameters)
+{
+	FStreamAudioRingBuffer ring(6);
+	TestEqual(TEXT("Capacity is rounded up to a power of two"), ring.Capacity(), 8u);
+
+	const int16_t first[6] = {1, 2, 3, 4, 5, 6};
+	int16_t out[8] = {};
+	TestTrue(TEXT("Write into an empty ring"), ring.Write(first, 6));
+	TestTrue(TEXT("Read part of it"), ring.Read(out, 4));
+	TestEqual(TEXT("Oldest sample is read first"), out[0], int16_t(1));
+
+	// Starts at index 6 and wraps around the end of the storage
+	const int16_t second[5] = {7, 8, 9, 10, 11};
+	TestTrue(TEXT("Wrapping write"), ring.Write(second, 5));
+	TestEqual(TEXT("Queued samples"), ring.Num(), 7u);
+	TestFalse(TEXT("Write larger than the free space is refused"), ring.Write(second, 2));
+	TestEqual(TEXT("Refused samples are counted as overflow"), ring.GetOverflowCount(), uint64(2));
+
+	TestTrue(TEXT("Wrapping read"), ring.Read(out, 7));
+	for (int32 i = 0; i < 7; i++)
+	{
+		TestEqual(TEXT("Samples come out in order across the wrap"), out[i], int16_t(5 + i));
+	}
+
+	TestFalse(TEXT("Read from an empty ring fails"), ring.Read(out, 1));
+	TestEqual(TEXT("Failed read is counted as underflow"), ring.GetUnderflowCount(), uint64(1));
+
+	TestTrue(TEXT("Write after draining"), ring.Write(first, 6));
+	TestEqual(TEXT("Skip is bounded by the queued samples"), ring.Skip(10), 6u);
+	TestTrue(TEXT("Write after skipping"), ring.Write(first, 3));
+	ring.Reset();
+	TestEqual(TEXT("Reset drops everything"), ring.Num(), 0u);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamAudioRingBufferStressTest, "HololightStream.Audio.RingBuffer.Stress",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamAudioRingBufferStressTest::RunTest(const FString& Parameters)
+{
+	// Small enough that both threads wrap around many times and regularly find it full or empty
+	constexpr uint32 capacity = 1024;
+	constexpr uint32 totalSamples = 1 << 22;
+	FStreamAudioRingBuffer ring(capacity);
+
+	std::atomic<uint64> refusedSamples = 0;
+	std::thread producer([&ring, &refusedSamples]()
+	{
+		int16_t block[capacity];
+		uint32 written = 0;
+		uint32 seed = 12345;
+		while (written < totalSamples)
+		{
+			seed = seed * 1664525u + 1013904223u;
+			const uint32 count = FMath::Min(1u + (seed >> 16) % 700u, totalSamples - written);
+			for (uint32 i = 0; i < count; i++)
+			{
+				block[i] = static_cast<int16_t>((written + i) & 0x7FFF);
+			}
+
+			// Alternates between both write paths
+			const bool accepted = (seed & 1)
+									  ? ring.Write(block, count)
+									  : ring.WriteWith(count, [&block](int16_t* destination, uint32 offset,
+																	   uint32 numSamples)
+									  {
+										  FMemory::Memcpy(destination, block + offset, numSamples * sizeof(int16_t));
+									  });
+			if (accepted)
+			{
+				written += count;
+			}
+			else
+			{
+				refusedSamples += count;
+				std::this_thread::yield();
+			}
+		}
+	});
+
+	int16_t block[capacity];
+	uint32 read = 0;
+	uint32 seed = 54321;
+	int32 mismatches = 0;
+	while (read < totalSamples)
+	{
+		seed = seed * 1664525u + 1013904223u;
+		const uint32 count = FMath::Min(1u + (seed >> 16) % 500u, totalSamples - read);
+		if (!ring.Read(block, count))
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		for (uint32 i = 0; i < count; i++)
+		{
+			mismatches += block[i] != static_cast<int16_t>((read + i) & 0x7FFF) ? 1 : 0;
+		}
+		read += count;
+	}
+	producer.join();
+
+	TestEqual(TEXT("Every sample arrives once and in order"), mismatches, 0);
+	TestEqual(TEXT("Nothing is left behind"), ring.Num(), 0u);
+	TestEqual(TEXT("Overflow counts exactly the refused samples"), ring.GetOverflowCount(), refusedSamples.load());
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
\ No newline at end of file
@@ -0,0 +1,229 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#include "Misc/AutomationTest.h"
+
+#include "FStreamConnectionInfoCache.h"
+#include "FStreamHMD.h"
+
+#include "RenderingThread.h"
+#include "SceneViewExtension.h"
+
+#include <atomic>
+#include <thread>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+// Stands in for getConnectionInfo, every query reports a render config whose fields all hold the query count. The
+// remote name is lent out of a buffer the next query overwrites, like ISAR may update its own copy.
+std::atomic<uint32> GConnectionInfoQueries{0};
+ANSICHAR GRemoteName[64] = {};
+
+isar::IsarError MockGetConnectionInfo(isar::IsarConnection connection, isar::IsarConnectionInfo* connectionInfo)
+{
+	const uint32 query = ++GConnectionInfoQueries;
+	FCStringAnsi::Snprintf(GRemoteName, UE_ARRAY_COUNT(GRemoteName), "MockClient %u", query);
+	connectionInfo->remoteName = GRemoteName;
+	connectionInfo->renderConfig.width = query;
+	connectionInfo->renderConfig.height = query;
+	connectionInfo->renderConfig.numViews = query;
+	connectionInfo->renderConfig.encoderBitrateKbps = static_cast<int32>(query);
+	connectionInfo->renderConfig.framerate = query;
+	return isar::IsarError::eNone;
+}
+
+// Reports a remote name longer than a snapshot holds
+isar::IsarError MockGetLongNameConnectionInfo(isar::IsarConnection connection,
+											  isar::IsarConnectionInfo* connectionInfo)
+{
+	static ANSICHAR longName[FStreamConnectionInfoSnapshot::REMOTE_NAME_CAPACITY * 2];
+	FMemory::Memset(longName, 'a', sizeof(longName) - 1);
+	longName[UE_ARRAY_COUNT(longName) - 1] = '\0';
+	MockGetConnectionInfo(connection, connectionInfo);
+	connectionInfo->remoteName = longName;
+	return isar::IsarError::eNone;
+}
+
+// Reports a stereo connection, so the per frame paths take their two view branches
+isar::IsarError MockGetStereoConnectionInfo(isar::IsarConnection connection, isar::IsarConnectionInfo* connectionInfo)
+{
+	MockGetConnectionInfo(connection, connectionInfo);
+	connectionInfo->renderConfig.numViews = 2;
+	return isar::IsarError::eNone;
+}
+
+std::atomic<int64> GPulledPoses{0};
+
+isar::IsarError MockPullViewPose(isar::IsarConnection connection, isar::IsarXrPose* pose)
+{
+	*pose = {};
+	pose->poseLeft.orientation.w = 1.0f;
+	pose->poseRight.orientation.w = 1.0f;
+	// One client frame of 90 Hz in nanoseconds per pull
+	pose->poseTimestamp = ++GPulledPoses * 11111111;
+	pose->frameTimestamp = pose->poseTimestamp;
+	return isar::IsarError::eNone;
+}
+
+isar::IsarServerApi MakeMockServerApi()
+{
+	GConnectionInfoQueries = 0;
+	isar::IsarServerApi serverApi = {};
+	serverApi.getConnectionInfo = &MockGetConnectionInfo;
+	return serverApi;
+}
+
+bool IsConsistent(const FStreamConnectionInfoSnapshot& info)
+{
+	const isar::IsarRenderConfig& config = info.renderConfig;
+	ANSICHAR expectedName[UE_ARRAY_COUNT(GRemoteName)];
+	FCStringAnsi::Snprintf(expectedName, UE_ARRAY_COUNT(expectedName), "MockClient %u", config.width);
+	return config.width == config.height && config.width == config.numViews && config.width == config.framerate &&
+		static_cast<int32>(config.width) == config.encoderBitrateKbps &&
+		FCStringAnsi::Strcmp(info.remoteName, expectedName) == 0;
+}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamConnectionInfoCacheNoQueryPerFrameTest,
+								 "HololightStream.HMD.ConnectionInfoCache.NoQueryPerFrame",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamConnectionInfoCacheNoQueryPerFrameTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 CONNECTION_COUNT = 3;
+	constexpr int32 FRAME_COUNT = 200;
+
+	TRefCountPtr<FStreamRenderBridge> renderBridge;
+	const TSharedRef<FStreamHMD, ESPMode::ThreadSafe> hmd =
+		FSceneViewExtensions::NewExtension<FStreamHMD>(renderBridge);
+
+	// The HMD never connects, it only sees the mock API and a connection handle the mocks ignore
+	const isar::IsarServerApi createdApi = hmd->m_serverApi;
+	const isar::IsarConnection createdConnection = hmd->m_streamConnection;
+	isar::IsarServerApi serverApi = MakeMockServerApi();
+	serverApi.getConnectionInfo = &MockGetStereoConnectionInfo;
+	serverApi.pullViewPose = &MockPullViewPose;
+	hmd->m_serverApi = serverApi;
+	hmd->m_streamConnection = &serverApi;
+	for (FStreamHMD::FPipelinedFrameState* state :
+		 {&hmd->m_pipelinedFrameStateGame, &hmd->m_pipelinedFrameStateRendering, &hmd->m_pipelinedFrameStateRHI})
+	{
+		state->views.SetNum(2);
+	}
+
+	int32 wrongViewCounts = 0;
+	for (int32 connection = 1; connection <= CONNECTION_COUNT; connection++)
+	{
+		// What the CONNECTED callback does with the info
+		hmd->m_connectionInfo.Refresh(hmd->m_serverApi, hmd->m_streamConnection);
+		hmd->m_connected = true;
+
+		// Every frame the game thread locates the device, the render thread late latches the pose and the frame is
+		// finished on the RHI thread
+		for (int32 frame = 0; frame < FRAME_COUNT; frame++)
+		{
+			hmd->UpdateDeviceLocations();
+			wrongViewCounts += hmd->GetNumViews() != 2;
+			ENQUEUE_RENDER_COMMAND(StreamConnectionInfoNoQueryTest)(
+				[hmd](FRHICommandListImmediate& RHICmdList)
+				{
+					hmd->UpdateDeviceLocations();
+					hmd->GetNumViews();
+					hmd->OnFinishRendering_RHIThread();
+				});
+		}
+		FlushRenderingCommands();
+
+		TestEqual(FString::Printf(TEXT("Connection %d queried ISAR once"), connection), GConnectionInfoQueries.load(),
+				  uint32(connection));
+		hmd->m_connected = false;
+	}
+	TestEqual(TEXT("Every frame reads the cached view count"), wrongViewCounts, 0);
+	TestTrue(TEXT("The frames pulled poses"), GPulledPoses.load() >= CONNECTION_COUNT * FRAME_COUNT * 2);
+
+	// The HMD closes what it created itself on destruction
+	hmd->m_serverApi = createdApi;
+	hmd->m_streamConnection = createdConnection;
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamConnectionInfoCacheRemoteNameTest,
+								 "HololightStream.HMD.ConnectionInfoCache.RemoteName",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamConnectionInfoCacheRemoteNameTest::RunTest(const FString& Parameters)
+{
+	const isar::IsarServerApi serverApi = MakeMockServerApi();
+	FStreamConnectionInfoCache cache;
+	cache.Refresh(serverApi, nullptr);
+
+	// ISAR reuses the buffer it lent the name out of
+	FCStringAnsi::Strcpy(GRemoteName, "Overwritten");
+	FStreamConnectionInfoSnapshot info;
+	TestTrue(TEXT("The info is available"), cache.Get(info));
+	TestEqual(TEXT("The cached name is a copy"), FString(info.remoteName), FString(TEXT("MockClient 1")));
+	TestTrue(TEXT("The name points into the snapshot"), info.remoteName == info.remoteNameStorage);
+
+	// Names longer than the snapshot holds are cut off, not overrun
+	isar::IsarServerApi longNameApi = serverApi;
+	longNameApi.getConnectionInfo = &MockGetLongNameConnectionInfo;
+	cache.Refresh(longNameApi, nullptr);
+	FStreamConnectionInfoSnapshot longInfo;
+	cache.Get(longInfo);
+	TestEqual(TEXT("A long name is truncated"), FCStringAnsi::Strlen(longInfo.remoteName),
+			  FStreamConnectionInfoSnapshot::REMOTE_NAME_CAPACITY - 1);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamConnectionInfoCacheReconnectTest,
+								 "HololightStream.HMD.ConnectionInfoCache.Reconnect",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamConnectionInfoCacheReconnectTest::RunTest(const FString& Parameters)
+{
+	constexpr uint32 RECONNECT_COUNT = 20000;
+	const isar::IsarServerApi serverApi = MakeMockServerApi();
+	FStreamConnectionInfoCache cache;
+	cache.Refresh(serverApi, nullptr);
+
+	// Readers racing the refreshes of reconnects never see a mix of two infos or names
+	std::atomic<bool> reconnecting{true};
+	std::atomic<int32> tornReads{0};
+	auto readFrames = [&cache, &reconnecting, &tornReads]()
+	{
+		uint32 lastWidth = 0;
+		while (reconnecting)
+		{
+			FStreamConnectionInfoSnapshot info;
+			cache.Get(info);
+			if (!IsConsistent(info) || info.renderConfig.width < lastWidth)
+			{
+				tornReads++;
+			}
+			lastWidth = info.renderConfig.width;
+		}
+	};
+	std::thread renderThread(readFrames);
+	std::thread rhiThread(readFrames);
+	for (uint32 reconnect = 0; reconnect < RECONNECT_COUNT; reconnect++)
+	{
+		cache.Refresh(serverApi, nullptr);
+	}
+	reconnecting = false;
+	renderThread.join();
+	rhiThread.join();
+
+	FStreamConnectionInfoSnapshot info;
+	TestTrue(TEXT("The info is available"), cache.Get(info));
+	TestEqual(TEXT("The last refresh wins"), info.renderConfig.width, RECONNECT_COUNT + 1);
+	TestEqual(TEXT("No read is torn"), tornReads.load(), 0);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
\ No newline at end of file
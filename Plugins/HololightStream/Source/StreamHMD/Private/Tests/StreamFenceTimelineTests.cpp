@@ -0,0 +1,180 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#include "Misc/AutomationTest.h"
+
+#include "FStreamFenceTimeline.h"
+
+#include "RHICommandList.h"
+
+#include <atomic>
+#include <thread>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+// CPU stand-in for a GPU queue, executes recorded operations strictly in order when stepped
+class FFakeGpuQueue
+{
+public:
+	void Record(TFunction<void()>&& operation) { m_operations.Add(MoveTemp(operation)); }
+
+	// Executes the next recorded operation, returns false once everything has executed
+	bool Step()
+	{
+		if (m_executed >= m_operations.Num())
+		{
+			return false;
+		}
+		m_operations[m_executed++]();
+		return true;
+	}
+
+	int32 NumPending() const { return m_operations.Num() - m_executed; }
+
+private:
+	TArray<TFunction<void()>> m_operations;
+	int32 m_executed = 0;
+};
+
+class FFakeFenceTimeline : public FStreamFenceTimeline
+{
+public:
+	explicit FFakeFenceTimeline(FFakeGpuQueue* queue) : m_queue(queue) {}
+
+	uint64 GetCompletedValue() const override { return m_completedValue; }
+	int32 GetNumSignals() const { return m_numSignals.load(); }
+
+protected:
+	void EnqueueSignal(FRHICommandList& rhiCmdList, uint64 value) override
+	{
+		m_numSignals++;
+		if (m_queue)
+		{
+			m_queue->Record([this, value] { m_completedValue = value; });
+		}
+	}
+
+private:
+	FFakeGpuQueue* m_queue;
+	uint64 m_completedValue = 0;
+	std::atomic<int32> m_numSignals{0};
+};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamFenceTimelineOrderingTest, "HololightStream.HMD.FenceTimeline.Ordering",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamFenceTimelineOrderingTest::RunTest(const FString& Parameters)
+{
+	// Frames record their rendering, then signal the value they are pushed with, the way the correction pass does.
+	// The fake encoder reads a frame as soon as its value completed, it must always find it fully rendered.
+	constexpr int32 numFrames = 8;
+	constexpr int32 passesPerFrame = 3;
+
+	FFakeGpuQueue queue;
+	FFakeFenceTimeline timeline(&queue);
+	FRHICommandList rhiCmdList(FRHIGPUMask::All());
+
+	TestEqual(TEXT("A new timeline has signaled nothing"), timeline.GetLastSignaledValue(), uint64(0));
+	TestEqual(TEXT("A new timeline starts completed at zero"), timeline.GetCompletedValue(), uint64(0));
+
+	int32 renderedPasses[numFrames] = {};
+	uint64 frameValues[numFrames] = {};
+	for (int32 frame = 0; frame < numFrames; frame++)
+	{
+		for (int32 pass = 0; pass < passesPerFrame; pass++)
+		{
+			queue.Record([&renderedPasses, frame] { renderedPasses[frame]++; });
+		}
+		frameValues[frame] = timeline.Signal(rhiCmdList);
+		TestEqual(TEXT("Values count up from one"), frameValues[frame], uint64(frame + 1));
+		TestEqual(TEXT("Last signaled value follows"), timeline.GetLastSignaledValue(), frameValues[frame]);
+	}
+	TestEqual(TEXT("Nothing completes before the GPU ran"), timeline.GetCompletedValue(), uint64(0));
+
+	int32 encodedFrames = 0;
+	uint64 previousCompleted = 0;
+	while (queue.Step())
+	{
+		const uint64 completed = timeline.GetCompletedValue();
+		TestTrue(TEXT("Completed value never goes back"), completed >= previousCompleted);
+		previousCompleted = completed;
+		while (encodedFrames < numFrames && frameValues[encodedFrames] <= completed)
+		{
+			TestEqual(TEXT("An encoded frame finished rendering"), renderedPasses[encodedFrames], passesPerFrame);
+			encodedFrames++;
+		}
+		if (encodedFrames < numFrames)
+		{
+			TestTrue(TEXT("A frame is not encoded before its value completed"),
+					 frameValues[encodedFrames] > completed);
+		}
+	}
+
+	TestEqual(TEXT("Every frame was encoded"), encodedFrames, numFrames);
+	TestEqual(TEXT("The last value completed"), timeline.GetCompletedValue(), uint64(numFrames));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamFenceTimelineUniqueValuesTest,
+								 "HololightStream.HMD.FenceTimeline.UniqueValues",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamFenceTimelineUniqueValuesTest::RunTest(const FString& Parameters)
+{
+	// Values must stay unique even if render commands of several views signal at the same time
+	constexpr int32 numThreads = 4;
+	constexpr int32 signalsPerThread = 10000;
+
+	FFakeFenceTimeline timeline(nullptr);
+	TArray<uint64> values[numThreads];
+	std::thread threads[numThreads];
+	for (int32 thread = 0; thread < numThreads; thread++)
+	{
+		threads[thread] = std::thread([&timeline, &values, thread]
+		{
+			FRHICommandList rhiCmdList(FRHIGPUMask::All());
+			values[thread].Reserve(signalsPerThread);
+			for (int32 signal = 0; signal < signalsPerThread; signal++)
+			{
+				values[thread].Add(timeline.Signal(rhiCmdList));
+			}
+		});
+	}
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	TArray<uint8> seen;
+	seen.SetNumZeroed(numThreads * signalsPerThread + 1);
+	int32 duplicates = 0;
+	int32 outOfRange = 0;
+	for (const TArray<uint64>& threadValues : values)
+	{
+		uint64 previous = 0;
+		for (const uint64 value : threadValues)
+		{
+			outOfRange += value == 0 || value >= uint64(seen.Num()) || value <= previous ? 1 : 0;
+			if (value > 0 && value < uint64(seen.Num()))
+			{
+				duplicates += seen[value]++ > 0 ? 1 : 0;
+			}
+			previous = value;
+		}
+	}
+
+	TestEqual(TEXT("No value was handed out twice"), duplicates, 0);
+	TestEqual(TEXT("Values are in range and increase on every thread"), outOfRange, 0);
+	TestEqual(TEXT("Every signal was enqueued"), timeline.GetNumSignals(), numThreads * signalsPerThread);
+	TestEqual(TEXT("Last signaled value counts all signals"), timeline.GetLastSignaledValue(),
+			  uint64(numThreads * signalsPerThread));
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
\ No newline at end of file
@@ -0,0 +1,228 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#include "Misc/AutomationTest.h"
+
+#include "FStreamFocusPlaneProvider.h"
+
+#include "HAL/IConsoleManager.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+constexpr float WORLD_TO_METERS = 100.0f;
+// Client time of the first pose of every trace, in nanoseconds
+constexpr int64 TRACE_START = 1000000000000;
+
+// Pose timestamps of a client running at the given rate, with the jitter of its render loop
+TArray<int64> MakePoseTrace(double rate, double duration, double jitterSeconds)
+{
+	FRandomStream random(7);
+	TArray<int64> timestamps;
+	for (int32 index = 0; index < FMath::RoundToInt(duration * rate); index++)
+	{
+		const double time = index / rate + random.FRandRange(0.0f, 2.0f * jitterSeconds);
+		timestamps.Add(TRACE_START + FMath::RoundToInt64(time * 1e9));
+	}
+	return timestamps;
+}
+
+FVector ToVector(const isar::IsarVector3& vector)
+{
+	return FVector(vector.x, vector.y, vector.z);
+}
+
+// Replays a pose trace with a focus target that moves at the given velocity after moveTime, in world units per
+// second. Every pose is rendered repeats times, as when the server renders faster than the client sends poses.
+// Returns the velocity sent with the last frame of every pose.
+TArray<FVector> ReplayTargetTrace(FStreamFocusPlaneProvider& provider, const TArray<int64>& timestamps,
+								  const FVector& worldVelocity, double moveTime = 0.0, int32 repeats = 1)
+{
+	const XrPosef headPose = ToXrPose(FTransform::Identity);
+	TArray<FVector> velocities;
+	for (const int64 timestamp : timestamps)
+	{
+		const double time = PoseTimestampToSeconds(timestamp - TRACE_START);
+		provider.SetTarget(worldVelocity * FMath::Max(time - moveTime, 0.0));
+		provider.Update_GameThread(nullptr, FTransform::Identity, headPose, WORLD_TO_METERS, 100.0f);
+
+		isar::IsarFocusPlane plane = {};
+		for (int32 repeat = 0; repeat < repeats; repeat++)
+		{
+			provider.ComputeFocusPlane_RenderThread(headPose, PoseTimestampToSeconds(timestamp), plane);
+		}
+		velocities.Add(ToVector(plane.velocity));
+	}
+	return velocities;
+}
+
+// Meters per second in the tracking space the plane is sent in
+FVector ToTrackingVelocity(const FVector& worldVelocity)
+{
+	const XrVector3f velocity = ToXrVector(worldVelocity, WORLD_TO_METERS);
+	return FVector(velocity.x, velocity.y, velocity.z);
+}
+
+class FScopedFocusPlaneSmoothingTime
+{
+public:
+	explicit FScopedFocusPlaneSmoothingTime(float smoothingTime)
+		: m_variable(IConsoleManager::Get().FindConsoleVariable(TEXT("vr.StreamFocusPlaneSmoothingTime"))),
+		  m_previous(m_variable ? m_variable->GetFloat() : 0.1f)
+	{
+		if (m_variable)
+		{
+			m_variable->Set(smoothingTime, ECVF_SetByCode);
+		}
+	}
+
+	~FScopedFocusPlaneSmoothingTime()
+	{
+		if (m_variable)
+		{
+			m_variable->Set(m_previous, ECVF_SetByCode);
+		}
+	}
+
+private:
+	IConsoleVariable* m_variable;
+	float m_previous;
+};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamFocusPlaneVelocityTest, "HololightStream.HMD.FocusPlane.Velocity",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamFocusPlaneVelocityTest::RunTest(const FString& Parameters)
+{
+	FScopedFocusPlaneSmoothingTime smoothingTime(0.0f);
+	FStreamFocusPlaneProvider provider;
+	provider.SetSource(EStreamFocusPlaneSource::Target);
+
+	// The poses are created at uneven times, the motion between them still is linear in the pose time
+	const FVector worldVelocity(100.0, 50.0, 0.0);
+	const TArray<FVector> velocities = ReplayTargetTrace(provider, MakePoseTrace(72.0, 0.5, 0.002), worldVelocity);
+
+	const FVector expected = ToTrackingVelocity(worldVelocity);
+	TestTrue(TEXT("The first pose has no velocity"), velocities[0].IsZero());
+	for (int32 index = 1; index < velocities.Num(); index++)
+	{
+		if (!velocities[index].Equals(expected, 1e-3))
+		{
+			AddError(FString::Printf(TEXT("Pose %d moves at (%f, %f, %f) instead of (%f, %f, %f)"), index,
+									 velocities[index].X, velocities[index].Y, velocities[index].Z, expected.X,
+									 expected.Y, expected.Z));
+			break;
+		}
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamFocusPlaneRepeatedPoseTest, "HololightStream.HMD.FocusPlane.RepeatedPose",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamFocusPlaneRepeatedPoseTest::RunTest(const FString& Parameters)
+{
+	FScopedFocusPlaneSmoothingTime smoothingTime(0.1f);
+	const TArray<int64> timestamps = MakePoseTrace(45.0, 1.0, 0.002);
+	const FVector worldVelocity(0.0, 0.0, 100.0);
+
+	FStreamFocusPlaneProvider once;
+	once.SetSource(EStreamFocusPlaneSource::Target);
+	const TArray<FVector> velocitiesOnce = ReplayTargetTrace(once, timestamps, worldVelocity);
+
+	// A server at 90 Hz renders every pose of a 45 Hz client twice, the second frame adds no motion
+	FStreamFocusPlaneProvider twice;
+	twice.SetSource(EStreamFocusPlaneSource::Target);
+	const TArray<FVector> velocitiesTwice = ReplayTargetTrace(twice, timestamps, worldVelocity, 0.0, 2);
+
+	for (int32 index = 0; index < timestamps.Num(); index++)
+	{
+		if (!velocitiesTwice[index].Equals(velocitiesOnce[index], 1e-6))
+		{
+			AddError(FString::Printf(TEXT("Rendering pose %d twice changed its velocity from %f to %f"), index,
+									 velocitiesOnce[index].Size(), velocitiesTwice[index].Size()));
+			break;
+		}
+	}
+	TestTrue(TEXT("The velocity converges with repeated poses"),
+			 velocitiesTwice.Last().Equals(ToTrackingVelocity(worldVelocity), 0.01));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamFocusPlaneSmoothingTest, "HololightStream.HMD.FocusPlane.Smoothing",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamFocusPlaneSmoothingTest::RunTest(const FString& Parameters)
+{
+	constexpr float SMOOTHING_TIME = 0.1f;
+	constexpr double MOVE_TIME = 0.5;
+	FScopedFocusPlaneSmoothingTime smoothingTime(SMOOTHING_TIME);
+	const FVector worldVelocity(100.0, 0.0, 0.0);
+	const double expected = ToTrackingVelocity(worldVelocity).Size();
+
+	// The target starts moving half a second into the trace, clients at different rates see the same response
+	double responses[2] = {};
+	const double rates[2] = {60.0, 120.0};
+	for (int32 rateIndex = 0; rateIndex < 2; rateIndex++)
+	{
+		FStreamFocusPlaneProvider provider;
+		provider.SetSource(EStreamFocusPlaneSource::Target);
+		const TArray<int64> timestamps = MakePoseTrace(rates[rateIndex], 2.0, 0.0);
+		const TArray<FVector> velocities = ReplayTargetTrace(provider, timestamps, worldVelocity, MOVE_TIME);
+
+		for (int32 index = 0; index < timestamps.Num(); index++)
+		{
+			const double time = PoseTimestampToSeconds(timestamps[index] - TRACE_START);
+			if (time <= MOVE_TIME)
+			{
+				TestTrue(TEXT("A still target has no velocity"), velocities[index].IsNearlyZero(1e-6));
+			}
+			else if (responses[rateIndex] == 0.0 && time >= MOVE_TIME + 2.0 * SMOOTHING_TIME)
+			{
+				responses[rateIndex] = velocities[index].Size();
+			}
+		}
+		TestEqual(FString::Printf(TEXT("The velocity settles at %.0f Hz"), rates[rateIndex]), velocities.Last().Size(),
+				  expected, 0.01 * expected);
+	}
+
+	TestTrue(TEXT("The velocity is smoothed"), responses[0] > 0.3 * expected && responses[0] < 0.99 * expected);
+	TestEqual(TEXT("The smoothing does not depend on the pose rate"), responses[1], responses[0], 0.05 * expected);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamFocusPlaneClockRestartTest, "HololightStream.HMD.FocusPlane.ClockRestart",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamFocusPlaneClockRestartTest::RunTest(const FString& Parameters)
+{
+	FScopedFocusPlaneSmoothingTime smoothingTime(0.0f);
+	FStreamFocusPlaneProvider provider;
+	provider.SetSource(EStreamFocusPlaneSource::Target);
+	const FVector worldVelocity(100.0, 0.0, 0.0);
+	ReplayTargetTrace(provider, MakePoseTrace(72.0, 0.5, 0.0), worldVelocity);
+
+	// The client restarted and its pose times start over, the history of the old clock must not be used
+	const XrPosef headPose = ToXrPose(FTransform::Identity);
+	isar::IsarFocusPlane plane = {};
+	provider.SetTarget(FVector(500.0, 0.0, 0.0));
+	provider.Update_GameThread(nullptr, FTransform::Identity, headPose, WORLD_TO_METERS, 100.0f);
+	TestTrue(TEXT("The plane is computed"), provider.ComputeFocusPlane_RenderThread(headPose, 1.0, plane));
+	TestTrue(TEXT("The first pose after the restart has no velocity"), ToVector(plane.velocity).IsZero());
+
+	provider.SetTarget(FVector(510.0, 0.0, 0.0));
+	provider.Update_GameThread(nullptr, FTransform::Identity, headPose, WORLD_TO_METERS, 100.0f);
+	provider.ComputeFocusPlane_RenderThread(headPose, 1.1, plane);
+	TestTrue(TEXT("The velocity follows the new clock"),
+			 ToVector(plane.velocity).Equals(ToTrackingVelocity(worldVelocity), 1e-3));
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
\ No newline at end of file
@@ -0,0 +1,176 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#include "Misc/AutomationTest.h"
+
+#include "FStreamClientClock.h"
+#include "FStreamFramePacer.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+constexpr int32 FRAMERATE = 72;
+// The client clock has nothing in common with ours
+constexpr int64 CLIENT_CLOCK_START = 5000000000000;
+constexpr double SERVER_CLOCK_START = 10.0;
+// The client clock runs 100 ppm slow
+constexpr double CLIENT_CLOCK_RATE = 1.0 - 1e-4;
+constexpr double NETWORK_DELAY = 0.02;
+constexpr double NETWORK_JITTER = 0.004;
+// Long enough for every pose to have arrived when the frame starts
+constexpr double START_OFFSET = NETWORK_JITTER + 0.001;
+constexpr double RENDER_START = 0.005;
+// WaitForNextFrame pulls a pose this often while it holds the frame back
+constexpr double POLL_INTERVAL = 0.0005;
+
+struct FTracePose
+{
+	int64 timestamp;
+	double createTime;
+	double arrivalTime;
+};
+
+// Poses sent by the client at its frame rate, as they arrive at the server
+TArray<FTracePose> MakeArrivalTrace(int32 numPoses)
+{
+	FRandomStream random(5);
+	const double clientPeriod = 1.0 / FRAMERATE;
+	TArray<FTracePose> poses;
+	for (int32 index = 0; index < numPoses; index++)
+	{
+		FTracePose pose;
+		pose.timestamp = CLIENT_CLOCK_START + FMath::RoundToInt64(index * clientPeriod * 1e9);
+		pose.createTime = SERVER_CLOCK_START + index * clientPeriod / CLIENT_CLOCK_RATE;
+		pose.arrivalTime = pose.createTime + NETWORK_DELAY + random.FRandRange(0.0f, NETWORK_JITTER);
+		poses.Add(pose);
+	}
+	return poses;
+}
+
+// Index of the newest pose that arrived before the given time, what pullViewPose returns then
+int32 FindLatestArrived(const TArray<FTracePose>& poses, double time)
+{
+	int32 latest = INDEX_NONE;
+	for (int32 index = 0; index < poses.Num(); index++)
+	{
+		if (poses[index].arrivalTime <= time && (latest == INDEX_NONE || index > latest))
+		{
+			latest = index;
+		}
+	}
+	return latest;
+}
+
+void PullPose(FStreamClientClock& clock, FStreamFramePacer& pacer, const FTracePose& pose, double pullTime)
+{
+	clock.OnPosePulled(pose.timestamp, pullTime);
+	pacer.OnPoseReceived(pose.timestamp, clock.ToPlatformTime(pose.timestamp));
+}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamFramePacerPoseReplayTest,
+								 "HololightStream.HMD.FramePacer.PoseReplay",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamFramePacerPoseReplayTest::RunTest(const FString& Parameters)
+{
+	const TArray<FTracePose> poses = MakeArrivalTrace(FRAMERATE * 20);
+	FStreamClientClock clock;
+	FStreamFramePacer pacer;
+	pacer.Reset(1.0 / FRAMERATE);
+
+	// A game loop that polls poses while the pacer holds the frame back, pulls the pose when the frame starts and again
+	// when the render thread latches it, with a frame that takes half a period
+	double now = poses[0].arrivalTime;
+	int32 previousPose = INDEX_NONE;
+	int32 pacedFrames = 0;
+	int32 repeatedPoses = 0;
+	double maxStartDelay = 0.0;
+	double maxMappingError = 0.0;
+	while (now < poses.Last().arrivalTime)
+	{
+		const double nextStart = pacer.GetNextFrameStartTime(now, START_OFFSET);
+		const bool paced = nextStart > 0.0;
+		for (; now < nextStart; now += POLL_INTERVAL)
+		{
+			const int32 polledPose = FindLatestArrived(poses, now);
+			if (polledPose != INDEX_NONE)
+			{
+				PullPose(clock, pacer, poses[polledPose], now);
+			}
+		}
+		const double frameStart = paced ? nextStart : now;
+
+		const int32 gamePose = FindLatestArrived(poses, frameStart);
+		PullPose(clock, pacer, poses[gamePose], frameStart);
+		const int32 renderPose = FindLatestArrived(poses, frameStart + RENDER_START);
+		PullPose(clock, pacer, poses[renderPose], frameStart + RENDER_START);
+
+		// Skip the first second, the clock mapping and the cadence settle in
+		if (paced && frameStart > SERVER_CLOCK_START + 1.0)
+		{
+			pacedFrames++;
+			repeatedPoses += gamePose == previousPose;
+			maxStartDelay = FMath::Max(maxStartDelay, frameStart - poses[gamePose].arrivalTime);
+			const double mappedTime = clock.ToPlatformTime(poses[gamePose].timestamp);
+			maxMappingError = FMath::Max(maxMappingError,
+										 FMath::Abs(mappedTime - poses[gamePose].createTime - NETWORK_DELAY));
+		}
+		previousPose = gamePose;
+		now = frameStart + 0.5 / FRAMERATE;
+	}
+
+	const FStreamFramePacerStats stats = pacer.GetStats();
+	AddInfo(FString::Printf(TEXT("Cadence %.3f ms, max start delay %.2f ms, max mapping error %.2f ms"),
+							stats.cadencePeriodMs, maxStartDelay * 1000.0, maxMappingError * 1000.0));
+	TestTrue(TEXT("Frames are paced"), pacedFrames > FRAMERATE * 15);
+	TestEqual(TEXT("The cadence follows the client clock"), stats.cadencePeriodMs,
+			  1000.0 / FRAMERATE / CLIENT_CLOCK_RATE, 0.01);
+	TestEqual(TEXT("Every frame starts with a new pose"), repeatedPoses, 0);
+	TestTrue(TEXT("Frames start right after the pose arrived"), maxStartDelay < START_OFFSET + 0.001);
+	TestTrue(TEXT("The client clock maps to the earliest arrival"), maxMappingError < 0.001);
+	TestEqual(TEXT("No pose counts as missed"), stats.missedPoses, uint64(0));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamFramePacerOutOfOrderPullTest,
+								 "HololightStream.HMD.FramePacer.OutOfOrderPull",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamFramePacerOutOfOrderPullTest::RunTest(const FString& Parameters)
+{
+	const TArray<FTracePose> poses = MakeArrivalTrace(FRAMERATE);
+	FStreamClientClock clock;
+	FStreamFramePacer pacer;
+	pacer.Reset(1.0 / FRAMERATE);
+
+	for (int32 index = 0; index < poses.Num(); index++)
+	{
+		const double pullTime = poses[index].arrivalTime;
+		PullPose(clock, pacer, poses[index], pullTime);
+		if (index > 0)
+		{
+			// The other thread pulled the previous pose earlier but only gets to hand it in now
+			PullPose(clock, pacer, poses[index - 1], pullTime);
+		}
+	}
+
+	const FStreamFramePacerStats stats = pacer.GetStats();
+	TestEqual(TEXT("Every pose is counted once"), stats.receivedPoses, uint64(poses.Num()));
+	TestEqual(TEXT("No pose counts as missed"), stats.missedPoses, uint64(0));
+	TestEqual(TEXT("A late pose does not move the cadence"), stats.cadencePeriodMs, 1000.0 / FRAMERATE, 0.01);
+	TestTrue(TEXT("A late pose does not restart the client clock"),
+			 clock.ToPlatformTime(poses[0].timestamp) - poses[0].createTime < NETWORK_DELAY + NETWORK_JITTER);
+
+	// A client that restarted starts its clock over
+	const int64 restartedTimestamp = CLIENT_CLOCK_START / 2;
+	clock.OnPosePulled(restartedTimestamp, 100.0);
+	TestEqual(TEXT("A restarted client clock is mapped anew"), clock.ToPlatformTime(restartedTimestamp), 100.0, 1e-6);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
\ No newline at end of file
@@ -0,0 +1,288 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#include "Misc/AutomationTest.h"
+
+#include "FStreamFrameSubmitter.h"
+
+#include "HAL/IConsoleManager.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+// Stands in for pushFrame, can hold the submit thread inside a push until the test opens the gate
+class FMockFramePush
+{
+public:
+	bool Push(const FStreamFrameSubmission& submission)
+	{
+		std::unique_lock lock(m_mutex);
+		m_pushing = true;
+		m_changed.notify_all();
+		m_changed.wait(lock, [this] { return m_gateOpen; });
+		m_pushing = false;
+		m_pushedSerials.Add(submission.serial);
+		return !m_failOddSerials || submission.serial % 2 == 0;
+	}
+
+	void Complete(const FStreamFrameSubmission& submission, bool pushed)
+	{
+		std::scoped_lock lock(m_mutex);
+		m_completions.Add(TPair<uint64, bool>(submission.serial, pushed));
+		m_changed.notify_all();
+	}
+
+	void SetGateOpen(bool open)
+	{
+		std::scoped_lock lock(m_mutex);
+		m_gateOpen = open;
+		m_changed.notify_all();
+	}
+
+	void SetFailOddSerials(bool fail)
+	{
+		std::scoped_lock lock(m_mutex);
+		m_failOddSerials = fail;
+	}
+
+	// Waits until the submit thread is inside a push
+	bool WaitForPush()
+	{
+		std::unique_lock lock(m_mutex);
+		return m_changed.wait_for(lock, std::chrono::seconds(5), [this] { return m_pushing; });
+	}
+
+	bool WaitForCompletions(int32 count)
+	{
+		std::unique_lock lock(m_mutex);
+		return m_changed.wait_for(lock, std::chrono::seconds(5), [this, count] { return m_completions.Num() >= count; });
+	}
+
+	TArray<TPair<uint64, bool>> GetCompletions()
+	{
+		std::scoped_lock lock(m_mutex);
+		return m_completions;
+	}
+
+	TArray<uint64> GetPushedSerials()
+	{
+		std::scoped_lock lock(m_mutex);
+		return m_pushedSerials;
+	}
+
+	TUniquePtr<FStreamFrameSubmitter> MakeSubmitter()
+	{
+		return MakeUnique<FStreamFrameSubmitter>(
+			[this](const FStreamFrameSubmission& submission) { return Push(submission); },
+			[this](const FStreamFrameSubmission& submission, bool pushed) { Complete(submission, pushed); });
+	}
+
+private:
+	std::mutex m_mutex;
+	std::condition_variable m_changed;
+	bool m_gateOpen = true;
+	bool m_pushing = false;
+	bool m_failOddSerials = false;
+	TArray<uint64> m_pushedSerials;
+	TArray<TPair<uint64, bool>> m_completions;
+};
+
+FStreamFrameSubmission MakeSubmission(uint64 serial)
+{
+	FStreamFrameSubmission submission;
+	submission.serial = serial;
+	return submission;
+}
+
+// Returns how a frame completed, fails the test if it did not complete exactly once
+bool CheckCompletedOnce(FAutomationTestBase& test, const TArray<TPair<uint64, bool>>& completions, uint64 serial,
+						bool expectPushed)
+{
+	int32 count = 0;
+	bool pushed = false;
+	for (const TPair<uint64, bool>& completion : completions)
+	{
+		if (completion.Key == serial)
+		{
+			count++;
+			pushed = completion.Value;
+		}
+	}
+	const FString what = FString::Printf(TEXT("Frame %llu"), serial);
+	return test.TestEqual(*(what + TEXT(" completes exactly once")), count, 1) &&
+		test.TestEqual(*(what + (expectPushed ? TEXT(" is pushed") : TEXT(" is dropped"))), pushed, expectPushed);
+}
+
+// Runs the test with a submit queue of one frame, which is the default
+class FScopedSubmitQueueSize
+{
+public:
+	FScopedSubmitQueueSize()
+		: m_variable(IConsoleManager::Get().FindConsoleVariable(TEXT("vr.StreamFrameSubmitQueueSize"))),
+		  m_previous(m_variable ? m_variable->GetInt() : 1)
+	{
+		if (m_variable)
+		{
+			m_variable->Set(1, ECVF_SetByCode);
+		}
+	}
+
+	~FScopedSubmitQueueSize()
+	{
+		if (m_variable)
+		{
+			m_variable->Set(m_previous, ECVF_SetByCode);
+		}
+	}
+
+private:
+	IConsoleVariable* m_variable;
+	int32 m_previous;
+};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamFrameSubmitterDropOldestTest, "HololightStream.HMD.FrameSubmitter.DropOldest",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamFrameSubmitterDropOldestTest::RunTest(const FString& Parameters)
+{
+	FScopedSubmitQueueSize queueSize;
+	FMockFramePush mock;
+	mock.SetGateOpen(false);
+	TUniquePtr<FStreamFrameSubmitter> submitter = mock.MakeSubmitter();
+
+	submitter->Enqueue(MakeSubmission(1));
+	TestTrue(TEXT("The first frame is being pushed"), mock.WaitForPush());
+	// The encoder stalls, newer frames replace the queued one
+	submitter->Enqueue(MakeSubmission(2));
+	submitter->Enqueue(MakeSubmission(3));
+	submitter->Enqueue(MakeSubmission(4));
+	TestEqual(TEXT("Only the newest frame waits"), submitter->GetStats().queueDepth, 1);
+
+	mock.SetGateOpen(true);
+	TestTrue(TEXT("All frames complete"), mock.WaitForCompletions(4));
+
+	const TArray<TPair<uint64, bool>> completions = mock.GetCompletions();
+	CheckCompletedOnce(*this, completions, 1, true);
+	CheckCompletedOnce(*this, completions, 2, false);
+	CheckCompletedOnce(*this, completions, 3, false);
+	CheckCompletedOnce(*this, completions, 4, true);
+
+	const TArray<uint64> pushedSerials = mock.GetPushedSerials();
+	TestEqual(TEXT("Two frames reached the encoder"), pushedSerials.Num(), 2);
+	TestTrue(TEXT("Frames are pushed in order"), pushedSerials.Num() == 2 && pushedSerials[0] == 1 &&
+			 pushedSerials[1] == 4);
+
+	const FStreamFrameSubmitterStats stats = submitter->GetStats();
+	TestEqual(TEXT("Submitted frames"), stats.submittedFrames, uint64(2));
+	TestEqual(TEXT("Dropped frames"), stats.droppedFrames, uint64(2));
+	TestEqual(TEXT("Failed frames"), stats.failedFrames, uint64(0));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamFrameSubmitterFailedPushTest, "HololightStream.HMD.FrameSubmitter.FailedPush",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamFrameSubmitterFailedPushTest::RunTest(const FString& Parameters)
+{
+	FScopedSubmitQueueSize queueSize;
+	FMockFramePush mock;
+	mock.SetFailOddSerials(true);
+	TUniquePtr<FStreamFrameSubmitter> submitter = mock.MakeSubmitter();
+
+	constexpr int32 numFrames = 6;
+	for (int32 frame = 1; frame <= numFrames; frame++)
+	{
+		submitter->Enqueue(MakeSubmission(frame));
+		TestTrue(TEXT("Frame completes"), mock.WaitForCompletions(frame));
+	}
+
+	const TArray<TPair<uint64, bool>> completions = mock.GetCompletions();
+	for (int32 frame = 1; frame <= numFrames; frame++)
+	{
+		CheckCompletedOnce(*this, completions, frame, frame % 2 == 0);
+	}
+
+	const FStreamFrameSubmitterStats stats = submitter->GetStats();
+	TestEqual(TEXT("Accepted pushes are counted as submitted"), stats.submittedFrames, uint64(numFrames / 2));
+	TestEqual(TEXT("Rejected pushes are counted as failed"), stats.failedFrames, uint64(numFrames / 2));
+	TestEqual(TEXT("Nothing was dropped"), stats.droppedFrames, uint64(0));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamFrameSubmitterFlushTest, "HololightStream.HMD.FrameSubmitter.Flush",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamFrameSubmitterFlushTest::RunTest(const FString& Parameters)
+{
+	FScopedSubmitQueueSize queueSize;
+	FMockFramePush mock;
+	mock.SetGateOpen(false);
+	TUniquePtr<FStreamFrameSubmitter> submitter = mock.MakeSubmitter();
+
+	submitter->Enqueue(MakeSubmission(1));
+	TestTrue(TEXT("The first frame is being pushed"), mock.WaitForPush());
+	submitter->Enqueue(MakeSubmission(2));
+
+	std::atomic<bool> flushed(false);
+	std::thread flushThread([&submitter, &flushed]
+	{
+		submitter->Flush();
+		flushed = true;
+	});
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	TestFalse(TEXT("Flush waits for the push in progress"), flushed.load());
+
+	mock.SetGateOpen(true);
+	flushThread.join();
+	TestTrue(TEXT("Flush returns once the push did"), flushed.load());
+
+	const TArray<TPair<uint64, bool>> completions = mock.GetCompletions();
+	TestEqual(TEXT("Both frames completed when Flush returned"), completions.Num(), 2);
+	CheckCompletedOnce(*this, completions, 1, true);
+	CheckCompletedOnce(*this, completions, 2, false);
+	TestEqual(TEXT("The queued frame never reached the encoder"), mock.GetPushedSerials().Num(), 1);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamFrameSubmitterShutdownTest, "HololightStream.HMD.FrameSubmitter.Shutdown",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamFrameSubmitterShutdownTest::RunTest(const FString& Parameters)
+{
+	FScopedSubmitQueueSize queueSize;
+	FMockFramePush mock;
+	mock.SetGateOpen(false);
+	TUniquePtr<FStreamFrameSubmitter> submitter = mock.MakeSubmitter();
+
+	submitter->Enqueue(MakeSubmission(1));
+	TestTrue(TEXT("The first frame is being pushed"), mock.WaitForPush());
+	submitter->Enqueue(MakeSubmission(2));
+
+	std::thread encoder([&mock]
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		mock.SetGateOpen(true);
+	});
+	submitter.Reset();
+	encoder.join();
+
+	// Queued frames still have to give their swapchain images back when the submitter goes away
+	const TArray<TPair<uint64, bool>> completions = mock.GetCompletions();
+	CheckCompletedOnce(*this, completions, 1, true);
+	CheckCompletedOnce(*this, completions, 2, false);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
\ No newline at end of file
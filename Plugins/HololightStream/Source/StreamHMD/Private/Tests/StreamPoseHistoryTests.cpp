@@ -0,0 +1,221 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#include "Misc/AutomationTest.h"
+
+#include "FStreamClientClock.h"
+#include "FStreamPoseHistory.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+constexpr int32 FRAMERATE = 72;
+constexpr int64 CLIENT_CLOCK_START = 3000000000000;
+// The head moves along x at this speed, in meters per second
+constexpr double HEAD_SPEED = 1.0;
+
+isar::IsarXrPose MakePose(int64 poseTimestamp, double x, double yaw = 0.0)
+{
+	const FQuat orientation(FVector::UpVector, yaw);
+	isar::IsarXrPose pose = {};
+	pose.frameTimestamp = poseTimestamp;
+	pose.poseTimestamp = poseTimestamp;
+	pose.poseLeft.position.x = static_cast<float>(x);
+	pose.poseLeft.orientation.x = static_cast<float>(orientation.X);
+	pose.poseLeft.orientation.y = static_cast<float>(orientation.Y);
+	pose.poseLeft.orientation.z = static_cast<float>(orientation.Z);
+	pose.poseLeft.orientation.w = static_cast<float>(orientation.W);
+	pose.poseRight = pose.poseLeft;
+	return pose;
+}
+
+int64 ToClientTimestamp(double clientTime)
+{
+	return CLIENT_CLOCK_START + FMath::RoundToInt64(clientTime * 1e9);
+}
+
+double GetYaw(const isar::IsarPose& pose)
+{
+	const FQuat orientation(pose.orientation.x, pose.orientation.y, pose.orientation.z, pose.orientation.w);
+	return orientation.GetTwistAngle(FVector::UpVector);
+}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamPoseHistoryInterpolationTest,
+								 "HololightStream.HMD.PoseHistory.Interpolation",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamPoseHistoryInterpolationTest::RunTest(const FString& Parameters)
+{
+	FStreamPoseHistory history;
+	isar::IsarXrPose pose;
+	TestFalse(TEXT("An empty history has no pose"), history.SamplePose(1.0, pose));
+
+	history.AddPose(MakePose(ToClientTimestamp(0.0), 0.0, 0.0), 1.0);
+	history.AddPose(MakePose(ToClientTimestamp(0.1), 1.0, 0.4), 1.1);
+	history.AddPose(MakePose(ToClientTimestamp(0.2), 2.0, 0.8), 1.2);
+
+	TestTrue(TEXT("A pose is sampled"), history.SamplePose(1.125, pose));
+	TestEqual(TEXT("Positions are interpolated"), pose.poseLeft.position.x, 1.25f, 1e-4f);
+	TestEqual(TEXT("Orientations are interpolated"), GetYaw(pose.poseLeft), 0.5, 1e-4);
+	TestEqual(TEXT("Both eyes are interpolated"), pose.poseRight.position.x, 1.25f, 1e-4f);
+	TestEqual(TEXT("The timestamps are those of the newer pose"), pose.poseTimestamp, ToClientTimestamp(0.2));
+
+	history.SamplePose(1.075, pose);
+	TestEqual(TEXT("Older pairs of poses are interpolated"), pose.poseLeft.position.x, 0.75f, 1e-4f);
+	TestEqual(TEXT("Older pairs of orientations are interpolated"), GetYaw(pose.poseLeft), 0.3, 1e-4);
+	TestEqual(TEXT("The timestamps are those of the pair's newer pose"), pose.poseTimestamp, ToClientTimestamp(0.1));
+
+	history.SamplePose(0.5, pose);
+	TestEqual(TEXT("A time before the history takes the oldest pose"), pose.poseLeft.position.x, 0.0f);
+	history.SamplePose(1.2, pose);
+	TestEqual(TEXT("The newest pose is hit exactly"), pose.poseLeft.position.x, 2.0f, 1e-4f);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamPoseHistoryExtrapolationTest,
+								 "HololightStream.HMD.PoseHistory.Extrapolation",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamPoseHistoryExtrapolationTest::RunTest(const FString& Parameters)
+{
+	FStreamPoseHistory history;
+	history.AddPose(MakePose(ToClientTimestamp(0.0), 0.0, 0.0), 1.0);
+	history.AddPose(MakePose(ToClientTimestamp(0.1), 1.0, 0.4), 1.1);
+
+	isar::IsarXrPose pose;
+	TestTrue(TEXT("A pose is sampled"), history.SamplePose(1.13, pose));
+	TestEqual(TEXT("A pose shortly after the newest one is extrapolated"), pose.poseLeft.position.x, 1.3f, 1e-4f);
+	TestEqual(TEXT("The orientation keeps turning"), GetYaw(pose.poseLeft), 0.52, 1e-4);
+	TestEqual(TEXT("Both eyes are extrapolated"), pose.poseRight.position.x, 1.3f, 1e-4f);
+	TestEqual(TEXT("The timestamps are those of the newest pose"), pose.poseTimestamp, ToClientTimestamp(0.1));
+	history.SamplePose(2.0, pose);
+	TestEqual(TEXT("Extrapolation stops after 50 ms"), pose.poseLeft.position.x, 1.5f, 1e-4f);
+	TestEqual(TEXT("The orientation stops turning after 50 ms"), GetYaw(pose.poseLeft), 0.6, 1e-4);
+
+	// What the render thread samples with the default prediction, one pose pulled per client frame
+	FStreamPoseHistory clientRateHistory;
+	const double clientPeriod = 1.0 / FRAMERATE;
+	for (int32 index = 0; index < 3; index++)
+	{
+		clientRateHistory.AddPose(MakePose(ToClientTimestamp(index * clientPeriod), index * clientPeriod * HEAD_SPEED),
+								  1.0 + index * clientPeriod);
+	}
+	const double pullTime = 1.0 + 2 * clientPeriod;
+	clientRateHistory.SamplePose(pullTime + 0.01, pose);
+	TestEqual(TEXT("The predicted pose follows the head"), pose.poseLeft.position.x,
+			  static_cast<float>((2 * clientPeriod + 0.01) * HEAD_SPEED), 1e-4f);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamPoseHistoryOrderTest,
+								 "HololightStream.HMD.PoseHistory.Order",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamPoseHistoryOrderTest::RunTest(const FString& Parameters)
+{
+	FStreamPoseHistory history;
+	history.AddPose(MakePose(ToClientTimestamp(0.0), 0.0), 1.0);
+	history.AddPose(MakePose(ToClientTimestamp(0.1), 1.0), 1.1);
+
+	// The same pose mapped a little earlier once the clock found a shorter delay
+	history.AddPose(MakePose(ToClientTimestamp(0.1), 1.0), 1.099);
+	TestEqual(TEXT("A pose pulled again is ignored"), history.Num(), 2);
+	history.AddPose(MakePose(ToClientTimestamp(0.05), 0.5), 1.05);
+	TestEqual(TEXT("A pose older than the newest one is ignored"), history.Num(), 2);
+
+	// A restarted client clock is mapped to the time its first pose was pulled at
+	history.AddPose(MakePose(ToClientTimestamp(-100.0), 5.0), 1.2);
+	TestEqual(TEXT("The poses of a restarted client clock are added"), history.Num(), 3);
+
+	for (int32 index = 0; index < 100; index++)
+	{
+		history.AddPose(MakePose(ToClientTimestamp(index), index), 2.0 + index);
+	}
+	TestEqual(TEXT("The history keeps its capacity"), history.Num(), 64);
+	isar::IsarXrPose pose;
+	history.SamplePose(0.0, pose);
+	TestEqual(TEXT("The oldest poses are dropped"), pose.poseLeft.position.x, 36.0f);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamPoseHistoryNetworkJitterTest,
+								 "HololightStream.HMD.PoseHistory.NetworkJitter",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamPoseHistoryNetworkJitterTest::RunTest(const FString& Parameters)
+{
+	constexpr double SERVER_CLOCK_START = 20.0;
+	constexpr double NETWORK_DELAY = 0.02;
+	constexpr double NETWORK_JITTER = 0.008;
+	constexpr double PREDICTION = 0.01;
+
+	// Poses are pulled at a frame rate of their own, from a link that delays every one differently
+	FRandomStream random(3);
+	FStreamClientClock clock;
+	FStreamPoseHistory history;
+	// Keyed by the time the poses were pulled at instead
+	FStreamPoseHistory pullTimeHistory;
+	const double clientPeriod = 1.0 / FRAMERATE;
+	TArray<double> arrivalTimes;
+	for (int32 index = 0; index < FRAMERATE * 10; index++)
+	{
+		arrivalTimes.Add(SERVER_CLOCK_START + index * clientPeriod + NETWORK_DELAY +
+						 random.FRandRange(0.0f, NETWORK_JITTER));
+	}
+
+	double maxError = 0.0;
+	double maxPullTimeError = 0.0;
+	int32 nextPose = 0;
+	for (double pullTime = SERVER_CLOCK_START; pullTime < arrivalTimes.Last(); pullTime += 1.0 / 90.0)
+	{
+		// Poses that arrive out of order are overtaken, the newest one is pulled
+		int32 pulledPose = INDEX_NONE;
+		for (int32 index = nextPose; index < arrivalTimes.Num(); index++)
+		{
+			if (arrivalTimes[index] <= pullTime)
+			{
+				pulledPose = index;
+			}
+		}
+		if (pulledPose == INDEX_NONE)
+		{
+			continue;
+		}
+		nextPose = pulledPose + 1;
+
+		const double clientTime = pulledPose * clientPeriod;
+		const int64 timestamp = ToClientTimestamp(clientTime);
+		clock.OnPosePulled(timestamp, pullTime);
+		history.AddPose(MakePose(timestamp, clientTime * HEAD_SPEED), clock.ToPlatformTime(timestamp));
+		pullTimeHistory.AddPose(MakePose(timestamp, clientTime * HEAD_SPEED), pullTime);
+
+		isar::IsarXrPose pose;
+		history.SamplePose(pullTime + PREDICTION, pose);
+		isar::IsarXrPose pullTimePose;
+		pullTimeHistory.SamplePose(pullTime + PREDICTION, pullTimePose);
+		// Where the head was when the client created a pose mapped to the target time
+		const double expectedX = (pullTime + PREDICTION - SERVER_CLOCK_START - NETWORK_DELAY) * HEAD_SPEED;
+		// Skip the first second, the clock mapping settles in
+		if (pullTime > SERVER_CLOCK_START + 1.0 && pullTime + PREDICTION - clock.ToPlatformTime(timestamp) < 0.05)
+		{
+			maxError = FMath::Max(maxError, FMath::Abs(pose.poseLeft.position.x - expectedX));
+			maxPullTimeError = FMath::Max(maxPullTimeError, FMath::Abs(pullTimePose.poseLeft.position.x - expectedX));
+		}
+	}
+
+	AddInfo(FString::Printf(TEXT("Max position error %.2f mm, %.2f mm when keyed by the pull time"), maxError * 1000.0,
+							maxPullTimeError * 1000.0));
+	// Pulled at 90 Hz only, the mapping settles a few milliseconds after the earliest arrival
+	TestTrue(TEXT("Network jitter does not distort the sampled pose"), maxError < HEAD_SPEED * 0.003);
+	TestTrue(TEXT("The client pose time beats the pull time"), maxError < maxPullTimeError / 2.0);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
\ No newline at end of file
@@ -0,0 +1,232 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#include "Misc/AutomationTest.h"
+
+#include "FStreamResolutionController.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+constexpr int32 FRAMERATE = 72;
+constexpr double TARGET_FRAME_TIME_MS = 1000.0 / FRAMERATE;
+
+// A scene whose GPU time scales with the rendered pixels, with some frame to frame noise
+class FSyntheticScene
+{
+public:
+	explicit FSyntheticScene(double fullResolutionGPUTimeMs, double noise = 0.0)
+		: m_random(11),
+		  m_fullResolutionGPUTimeMs(fullResolutionGPUTimeMs),
+		  m_noise(noise)
+	{
+	}
+
+	void SetFullResolutionGPUTimeMs(double gpuTimeMs)
+	{
+		m_fullResolutionGPUTimeMs = gpuTimeMs;
+	}
+
+	FStreamResolutionSample Render(float resolutionFraction, int32 encodeQueueDepth = 0, int32 bitrateKbps = 0)
+	{
+		FStreamResolutionSample sample;
+		sample.gpuFrameTimeMs = m_fullResolutionGPUTimeMs * resolutionFraction * resolutionFraction *
+			(1.0 + m_random.FRandRange(-m_noise, m_noise));
+		sample.targetFrameTimeMs = TARGET_FRAME_TIME_MS;
+		sample.encodeQueueDepth = encodeQueueDepth;
+		sample.bitrateKbps = bitrateKbps;
+		sample.framerate = FRAMERATE;
+		sample.fullResolutionPixels = int64(2064) * 2208 * 2;
+		return sample;
+	}
+
+private:
+	FRandomStream m_random;
+	double m_fullResolutionGPUTimeMs;
+	double m_noise;
+};
+
+FStreamResolutionSettings MakeSettings()
+{
+	FStreamResolutionSettings settings;
+	// Only the GPU time drives the fraction unless a test sets a bitrate
+	settings.minBitsPerPixel = 0.0f;
+	return settings;
+}
+
+double GetGPUBudgetMs(const FStreamResolutionSettings& settings)
+{
+	return TARGET_FRAME_TIME_MS * settings.targetGPUUtilization;
+}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamResolutionControllerGPUBoundTest,
+								 "HololightStream.HMD.ResolutionController.GPUBound",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamResolutionControllerGPUBoundTest::RunTest(const FString& Parameters)
+{
+	const FStreamResolutionSettings settings = MakeSettings();
+	FStreamResolutionController controller;
+	// Full resolution takes almost twice the budget
+	FSyntheticScene scene(20.0, 0.03);
+
+	int32 framesOverBudget = 0;
+	double gpuTimeMs = 0.0;
+	for (int32 frame = 0; frame < 300; frame++)
+	{
+		const FStreamResolutionSample sample = scene.Render(controller.GetResolutionFraction());
+		gpuTimeMs = sample.gpuFrameTimeMs;
+		if (gpuTimeMs > GetGPUBudgetMs(settings) * (1.0 + settings.hysteresis))
+		{
+			framesOverBudget++;
+		}
+		controller.Update(sample, settings);
+	}
+
+	TestTrue(TEXT("The GPU is back within its budget within half a second"), framesOverBudget < FRAMERATE / 2);
+	TestEqual(TEXT("The GPU time settles at the budget"), gpuTimeMs, GetGPUBudgetMs(settings),
+			  GetGPUBudgetMs(settings) * (settings.hysteresis + 0.05));
+	TestTrue(TEXT("The fraction stays above the minimum"), controller.GetResolutionFraction() > settings.minFraction);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamResolutionControllerRecoveryTest,
+								 "HololightStream.HMD.ResolutionController.Recovery",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamResolutionControllerRecoveryTest::RunTest(const FString& Parameters)
+{
+	const FStreamResolutionSettings settings = MakeSettings();
+	FStreamResolutionController controller;
+	FSyntheticScene scene(80.0);
+	for (int32 frame = 0; frame < 100; frame++)
+	{
+		controller.Update(scene.Render(controller.GetResolutionFraction()), settings);
+	}
+	TestEqual(TEXT("A heavy scene renders at the minimum"), controller.GetResolutionFraction(), settings.minFraction);
+
+	// The scene gets light, the fraction climbs back in limited steps with a cooldown between them
+	scene.SetFullResolutionGPUTimeMs(4.0);
+	int32 framesSinceChange = 0;
+	int32 changes = 0;
+	bool stepsLimited = true;
+	bool cooldownKept = true;
+	float previousFraction = controller.GetResolutionFraction();
+	for (int32 frame = 0; frame < 2000 && controller.GetResolutionFraction() < settings.maxFraction; frame++)
+	{
+		framesSinceChange++;
+		const float fraction = controller.Update(scene.Render(controller.GetResolutionFraction()), settings);
+		if (fraction != previousFraction)
+		{
+			stepsLimited &= fraction - previousFraction <= 0.05f + 1e-5f;
+			// The first raise may come right away, the scene was stable before
+			cooldownKept &= changes == 0 || framesSinceChange >= settings.increaseCooldownFrames;
+			framesSinceChange = 0;
+			changes++;
+		}
+		previousFraction = fraction;
+	}
+
+	TestEqual(TEXT("The fraction recovers to the maximum"), controller.GetResolutionFraction(), settings.maxFraction);
+	TestTrue(TEXT("Every raise is limited"), stepsLimited);
+	TestTrue(TEXT("Raises wait for the cooldown"), cooldownKept);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamResolutionControllerHysteresisTest,
+								 "HololightStream.HMD.ResolutionController.Hysteresis",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamResolutionControllerHysteresisTest::RunTest(const FString& Parameters)
+{
+	const FStreamResolutionSettings settings = MakeSettings();
+	FStreamResolutionController controller;
+	// Right at the budget with frame to frame noise inside the hysteresis band
+	FSyntheticScene scene(GetGPUBudgetMs(settings), settings.hysteresis * 0.8);
+
+	int32 changes = 0;
+	float previousFraction = controller.GetResolutionFraction();
+	for (int32 frame = 0; frame < 1000; frame++)
+	{
+		const float fraction = controller.Update(scene.Render(controller.GetResolutionFraction()), settings);
+		changes += fraction != previousFraction;
+		previousFraction = fraction;
+	}
+	TestEqual(TEXT("Noise within the band does not change the resolution"), changes, 0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamResolutionControllerEncoderBehindTest,
+								 "HololightStream.HMD.ResolutionController.EncoderBehind",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamResolutionControllerEncoderBehindTest::RunTest(const FString& Parameters)
+{
+	const FStreamResolutionSettings settings = MakeSettings();
+	FStreamResolutionController controller;
+	// The GPU has plenty of headroom, only the encoder is behind
+	FSyntheticScene scene(4.0);
+
+	// A single frame waiting now and then is normal
+	for (int32 frame = 0; frame < 200; frame++)
+	{
+		controller.Update(scene.Render(controller.GetResolutionFraction(), frame % 10 == 0 ? 1 : 0), settings);
+	}
+	TestEqual(TEXT("An occasional waiting frame keeps the resolution"), controller.GetResolutionFraction(),
+			  settings.maxFraction);
+
+	bool raised = false;
+	float previousFraction = controller.GetResolutionFraction();
+	for (int32 frame = 0; frame < 200; frame++)
+	{
+		const float fraction = controller.Update(scene.Render(controller.GetResolutionFraction(), 2), settings);
+		raised |= fraction > previousFraction;
+		previousFraction = fraction;
+	}
+	TestFalse(TEXT("The resolution is never raised while the encoder is behind"), raised);
+	TestEqual(TEXT("A backed up encoder lowers the resolution to the minimum"), controller.GetResolutionFraction(),
+			  settings.minFraction);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamResolutionControllerBitrateTest,
+								 "HololightStream.HMD.ResolutionController.Bitrate",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamResolutionControllerBitrateTest::RunTest(const FString& Parameters)
+{
+	FStreamResolutionSettings settings = MakeSettings();
+	settings.minBitsPerPixel = 0.02f;
+	FStreamResolutionController controller;
+	FSyntheticScene scene(4.0);
+
+	// 10 Mbit/s at 72 Hz affords 6.9 million pixels at 0.02 bits each, of the 9.1 million of both views
+	constexpr int32 BITRATE_KBPS = 10000;
+	for (int32 frame = 0; frame < 100; frame++)
+	{
+		controller.Update(scene.Render(controller.GetResolutionFraction(), 0, BITRATE_KBPS), settings);
+	}
+	const double affordablePixels = BITRATE_KBPS * 1000.0 / FRAMERATE / settings.minBitsPerPixel;
+	const float expected = static_cast<float>(FMath::Sqrt(affordablePixels / (int64(2064) * 2208 * 2)));
+	TestEqual(TEXT("The bitrate limits the resolution"), controller.GetResolutionFraction(), expected, 1e-4f);
+
+	// Without a bitrate limit the same scene renders at full resolution
+	settings.minBitsPerPixel = 0.0f;
+	for (int32 frame = 0; frame < 1000; frame++)
+	{
+		controller.Update(scene.Render(controller.GetResolutionFraction(), 0, BITRATE_KBPS), settings);
+	}
+	TestEqual(TEXT("The resolution recovers once the bitrate is ignored"), controller.GetResolutionFraction(),
+			  settings.maxFraction);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
\ No newline at end of file
@@ -0,0 +1,182 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#include "Misc/AutomationTest.h"
+
+#include "FStreamSwapchainImageQueue.h"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+using EImageState = FStreamSwapchainImageQueue::EImageState;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamSwapchainImageQueueOutOfOrderTest,
+								 "HololightStream.HMD.SwapchainImageQueue.OutOfOrderRelease",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamSwapchainImageQueueOutOfOrderTest::RunTest(const FString& Parameters)
+{
+	FStreamSwapchainImageQueue queue(3);
+	for (uint64 completionValue = 1; completionValue <= 3; completionValue++)
+	{
+		const int32 index = queue.Acquire();
+		TestEqual(TEXT("Images are handed out in order"), index, int32(completionValue - 1));
+		queue.Submit(index, completionValue);
+	}
+
+	TestEqual(TEXT("Nothing is free while the encoder holds every image"), queue.Acquire(), int32(INDEX_NONE));
+	TestEqual(TEXT("Waiting without a release times out"), queue.AcquireWait(0.005), int32(INDEX_NONE));
+	for (int32 index = 0; index < queue.Num(); index++)
+	{
+		TestTrue(TEXT("Submitted images are never taken back"), queue.GetState(index) == EImageState::Submitted);
+	}
+
+	// The encoder finishes the middle frame first
+	TestFalse(TEXT("A stale completion value does not free the image"), queue.ReleaseSubmitted(1, 1));
+	TestTrue(TEXT("The matching completion value frees it"), queue.ReleaseSubmitted(1, 2));
+	TestEqual(TEXT("The image finished first is acquired"), queue.Acquire(), 1);
+	TestEqual(TEXT("Only that image was free"), queue.Acquire(), int32(INDEX_NONE));
+
+	TestEqual(TEXT("Completing the last value frees the rest"), queue.ReleaseCompleted(3), 2);
+	TestTrue(TEXT("The acquired image is not touched by completion"), queue.GetState(1) == EImageState::Acquired);
+	TestEqual(TEXT("Least recently released image comes first"), queue.Acquire(), 0);
+	TestEqual(TEXT("Then the next one"), queue.Acquire(), 2);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamSwapchainImageQueueWaitTest,
+								 "HololightStream.HMD.SwapchainImageQueue.AcquireWait",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamSwapchainImageQueueWaitTest::RunTest(const FString& Parameters)
+{
+	FStreamSwapchainImageQueue queue(2);
+	queue.Submit(queue.Acquire(), 1);
+	queue.Submit(queue.Acquire(), 2);
+
+	std::thread encoder([&queue]
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		queue.ReleaseSubmitted(1, 2);
+	});
+	const double start = FPlatformTime::Seconds();
+	const int32 acquired = queue.AcquireWait(1.0);
+	const double waited = FPlatformTime::Seconds() - start;
+	encoder.join();
+
+	TestEqual(TEXT("The image released during the wait is acquired"), acquired, 1);
+	TestTrue(TEXT("The wait ends on the release instead of the timeout"), waited < 0.5);
+	TestTrue(TEXT("The other image is still with the encoder"), queue.GetState(0) == EImageState::Submitted);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamSwapchainImageQueueFakeEncoderTest,
+								 "HololightStream.HMD.SwapchainImageQueue.FakeEncoder",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamSwapchainImageQueueFakeEncoderTest::RunTest(const FString& Parameters)
+{
+	// The renderer acquires with a short bounded wait and drops the frame if that fails, the fake encoder finishes
+	// the frames it holds in random order. No image may be handed to the renderer while the encoder reads it.
+	constexpr int32 numImages = 3;
+	constexpr int32 numFrames = 5000;
+	enum EOwner : int32
+	{
+		Free,
+		Renderer,
+		Encoder
+	};
+
+	FStreamSwapchainImageQueue queue(numImages);
+	std::atomic<int32> owners[numImages];
+	for (std::atomic<int32>& owner : owners)
+	{
+		owner = Free;
+	}
+
+	std::mutex encoderLock;
+	TArray<TPair<int32, uint64>> encoding;
+	std::atomic<bool> rendering(true);
+	std::atomic<int32> ownershipErrors(0);
+
+	std::thread encoder([&]
+	{
+		FRandomStream random(3);
+		for (;;)
+		{
+			TPair<int32, uint64> frame(INDEX_NONE, 0);
+			{
+				std::scoped_lock lock(encoderLock);
+				if (encoding.IsEmpty() && !rendering)
+				{
+					break;
+				}
+				if (!encoding.IsEmpty())
+				{
+					const int32 pick = random.RandRange(0, encoding.Num() - 1);
+					frame = encoding[pick];
+					encoding.RemoveAtSwap(pick);
+				}
+			}
+			if (frame.Key == INDEX_NONE)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			// Some frames take longer than the renderer waits, so it has to drop frames now and then
+			if (random.RandRange(0, 15) == 0)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(2));
+			}
+
+			int32 expected = Encoder;
+			if (!owners[frame.Key].compare_exchange_strong(expected, Free))
+			{
+				ownershipErrors++;
+			}
+			queue.ReleaseSubmitted(frame.Key, frame.Value);
+		}
+	});
+
+	int32 renderedFrames = 0;
+	int32 droppedFrames = 0;
+	for (uint64 completionValue = 1; completionValue <= numFrames; completionValue++)
+	{
+		const int32 index = queue.AcquireWait(0.001);
+		if (index == INDEX_NONE)
+		{
+			droppedFrames++;
+			continue;
+		}
+
+		int32 expected = Free;
+		if (!owners[index].compare_exchange_strong(expected, Renderer))
+		{
+			ownershipErrors++;
+			continue;
+		}
+		renderedFrames++;
+		owners[index] = Encoder;
+		std::scoped_lock lock(encoderLock);
+		queue.Submit(index, completionValue);
+		encoding.Add(TPair<int32, uint64>(index, completionValue));
+	}
+	rendering = false;
+	encoder.join();
+
+	TestEqual(TEXT("No image was acquired while the encoder held it"), ownershipErrors.load(), 0);
+	TestEqual(TEXT("Every frame was rendered or dropped"), renderedFrames + droppedFrames, numFrames);
+	TestEqual(TEXT("Every image is free once the encoder is done"), queue.NumFree(), numImages);
+	AddInfo(FString::Printf(TEXT("Rendered %d frames, dropped %d"), renderedFrames, droppedFrames));
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
\ No newline at end of file
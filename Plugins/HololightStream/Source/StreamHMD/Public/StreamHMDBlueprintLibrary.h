@@ -60,6 +60,17 @@ enum class EStreamCodecType : uint8
 	AV1_10Bit
 };
 
+UENUM(BlueprintType)
+enum class EStreamFocusPlaneSource : uint8
+{
+	// The target if one is set, otherwise the gaze hit, otherwise the depth histogram
+	Automatic,
+	Target,
+	Gaze,
+	DepthHistogram,
+	Disabled
+};
+
 USTRUCT(BlueprintType)
 struct FStreamConnectionInfo
 {
@@ -108,4 +119,16 @@ public:
 
 	UFUNCTION(BlueprintCallable, Category = "Hololight Stream")
 	static bool GetConnectionInfo(FStreamConnectionInfo& ConnectionInfo);
+
+	UFUNCTION(BlueprintCallable, Category = "Hololight Stream")
+	static void SetFocusPlaneSource(EStreamFocusPlaneSource Source);
+
+	UFUNCTION(BlueprintCallable, Category = "Hololight Stream")
+	static EStreamFocusPlaneSource GetFocusPlaneSource();
+
+	UFUNCTION(BlueprintCallable, Category = "Hololight Stream")
+	static void SetFocusPlaneTarget(FVector WorldLocation);
+
+	UFUNCTION(BlueprintCallable, Category = "Hololight Stream")
+	static void ClearFocusPlaneTarget();
 };
\ No newline at end of file
@@ -0,0 +1,219 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#include "FStreamHaptics.h"
+
+#include "Runtime/Launch/Resources/Version.h"
+
+using namespace isar;
+
+static TAutoConsoleVariable<int32> CVarStreamHapticMaxRate(
+	TEXT("vr.StreamHapticMaxRate"),
+	30,
+	TEXT("Maximum number of haptic messages per second the Stream plugin sends to the controller of each hand."),
+	ECVF_Default);
+
+// Durations of IsarHaptic messages are in nanoseconds
+static int64 ToHapticDuration(double seconds)
+{
+	return static_cast<int64>(seconds * 1e9);
+}
+
+FStreamHaptics::FStreamHaptics(FPushFunction pushFunction) : m_pushFunction(MoveTemp(pushFunction))
+{
+}
+
+void FStreamHaptics::SetForceFeedback(FForceFeedbackChannelType channel, float value)
+{
+	switch (channel)
+	{
+		case FForceFeedbackChannelType::LEFT_LARGE: m_hands[0].forceFeedbackLarge = value; break;
+		case FForceFeedbackChannelType::LEFT_SMALL: m_hands[0].forceFeedbackSmall = value; break;
+		case FForceFeedbackChannelType::RIGHT_LARGE: m_hands[1].forceFeedbackLarge = value; break;
+		case FForceFeedbackChannelType::RIGHT_SMALL: m_hands[1].forceFeedbackSmall = value; break;
+		default: break;
+	}
+}
+
+void FStreamHaptics::SetEffectValues(EControllerHand hand, float amplitude)
+{
+	const int32 handIndex = ToHandIndex(hand);
+	if (handIndex == INDEX_NONE)
+		return;
+
+	FHandState& state = m_hands[handIndex];
+	state.effectAmplitude = amplitude;
+	// A sound wave effect of this hand was stopped or replaced, the client drops what it still has queued on the
+	// stop or vibration that follows
+	state.pcmSamples.Reset();
+	state.pcmAppend = false;
+	state.pcmEndTime = 0.0;
+}
+
+void FStreamHaptics::QueuePcm(EControllerHand hand, FHapticFeedbackBuffer& buffer, double now)
+{
+	const int32 handIndex = ToHandIndex(hand);
+	if (handIndex == INDEX_NONE || !buffer.RawData || buffer.SamplingRate <= 0 || buffer.BufferLength <= 0)
+		return;
+
+	FHandState& state = m_hands[handIndex];
+	state.effectAmplitude = 0.0f;
+
+	// Stereo buffers interleave the samples of both hands
+	const int32 stride = buffer.bUseStereo ? 2 : 1;
+	const int32 channel = buffer.bUseStereo && handIndex == 1 ? 1 : 0;
+	const int32 sampleCount = buffer.BufferLength / stride;
+	if (buffer.SamplesSent == 0)
+	{
+		state.pcmSamples.Reset();
+		state.pcmSampleRate = static_cast<float>(buffer.SamplingRate);
+		state.pcmAppend = false;
+		state.pcmStartTime = now;
+		state.pcmEndTime = now + static_cast<double>(sampleCount) / buffer.SamplingRate;
+	}
+
+	// Samples are sent ahead of playback by two messages, so the client does not run dry while the rate limit holds
+	// the next chunk back
+	const double lookahead = 2.0 * GetSendInterval();
+	const int32 dueSamples = FMath::Min(sampleCount,
+										FMath::CeilToInt32((now - state.pcmStartTime + lookahead) * buffer.SamplingRate));
+	for (int32 sample = buffer.SamplesSent; sample < dueSamples; sample++)
+	{
+		const float value = buffer.RawData[sample * stride + channel] * buffer.ScaleFactor;
+		state.pcmSamples.Add(static_cast<uint8>(FMath::Clamp(value, 0.0f, 255.0f)));
+	}
+
+	buffer.SamplesSent = FMath::Max(buffer.SamplesSent, dueSamples);
+	buffer.CurrentPtr = buffer.SamplesSent * stride;
+	// The engine stops the effect once it finished, which must not happen before the client played the last samples
+	buffer.bFinishedPlaying = buffer.SamplesSent >= sampleCount && now >= state.pcmEndTime;
+}
+
+void FStreamHaptics::Flush(double now, FFindControllerFunction findController)
+{
+	const double interval = GetSendInterval();
+	FlushHand(m_hands[0], EControllerHand::Left, now, interval, findController);
+	FlushHand(m_hands[1], EControllerHand::Right, now, interval, findController);
+}
+
+void FStreamHaptics::FlushHand(FHandState& state, EControllerHand hand, double now, double interval,
+							   FFindControllerFunction findController)
+{
+	// A playing sound wave owns the actuator, vibrations would cut it off
+	if (now >= state.pcmEndTime)
+	{
+		if (state.amplitudes.IsEmpty())
+			state.amplitudesStartTime = now;
+		else if (state.amplitudes.Num() == MAX_ENVELOPE_SAMPLES)
+#if ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION > 3
+			state.amplitudes.RemoveAt(0, 1, EAllowShrinking::No);
+#else
+			state.amplitudes.RemoveAt(0, 1, false);
+#endif
+		const float amplitude = FMath::Max3(state.forceFeedbackLarge, state.forceFeedbackSmall,
+											state.effectAmplitude);
+		state.amplitudes.Add(FMath::Clamp(amplitude, 0.0f, 1.0f));
+	}
+
+	if (state.lastSendTime >= 0.0 && now - state.lastSendTime < interval)
+		return;
+
+	uint32_t controllerIdentifier = 0;
+	if (!findController(hand, controllerIdentifier))
+	{
+		state.amplitudes.Reset();
+		state.pcmSamples.Reset();
+		state.active = false;
+		return;
+	}
+
+	const IsarSpatialInteractionSourceHandedness handedness = hand == EControllerHand::Left
+																  ? IsarSpatialInteractionSourceHandedness_LEFT
+																  : IsarSpatialInteractionSourceHandedness_RIGHT;
+	IsarHaptic haptic = {};
+	if (!state.pcmSamples.IsEmpty())
+	{
+		haptic.type = IsarHapticType_PCM_VIBRATION;
+		haptic.data.hapticPcmVibration = {
+			controllerIdentifier, handedness, IsarHapticChannel_BODY, static_cast<uint32_t>(state.pcmSamples.Num()),
+			state.pcmSamples.GetData(), state.pcmSampleRate, state.pcmAppend
+		};
+		Push(haptic, state, now);
+		state.pcmSamples.Reset();
+		state.pcmAppend = true;
+		state.active = true;
+		return;
+	}
+
+	if (state.amplitudes.IsEmpty())
+		return;
+
+	const float amplitude = state.amplitudes.Last();
+	bool steady = true;
+	for (float frameAmplitude : state.amplitudes)
+	{
+		steady &= frameAmplitude == amplitude;
+	}
+
+	if (!steady)
+	{
+		// Plays back the frames since the last message, one message late instead of losing them to the rate limit
+		haptic.type = IsarHapticType_AMPLITUDE_ENVELOPE_VIBRATION;
+		haptic.data.hapticAmplitudeEnvelopeVibration = {
+			controllerIdentifier, handedness, IsarHapticChannel_BODY,
+			ToHapticDuration(FMath::Max(now - state.amplitudesStartTime, interval)),
+			static_cast<uint32_t>(state.amplitudes.Num()), state.amplitudes.GetData()
+		};
+		Push(haptic, state, now);
+		state.active = true;
+		// The envelope ends on its own, whatever follows has to be sent
+		state.sentAmplitude = -1.0f;
+	}
+	else if (amplitude > 0.0f)
+	{
+		// Vibrations last three intervals and are renewed after two, so they do not lapse while the value holds
+		if (!state.active || amplitude != state.sentAmplitude || now - state.lastSendTime >= 2.0 * interval)
+		{
+			haptic.type = IsarHapticType_VIBRATION;
+			// A frequency of 0 leaves it to the client, the actuators of the supported controllers differ too much
+			haptic.data.hapticVibration = {
+				controllerIdentifier, handedness, IsarHapticChannel_BODY, ToHapticDuration(3.0 * interval), 0.0f,
+				amplitude
+			};
+			Push(haptic, state, now);
+			state.active = true;
+			state.sentAmplitude = amplitude;
+		}
+	}
+	else if (state.active)
+	{
+		haptic.type = IsarHapticType_STOP;
+		haptic.data.hapticStop = {controllerIdentifier, handedness, IsarHapticChannel_BODY};
+		Push(haptic, state, now);
+		state.active = false;
+		state.sentAmplitude = 0.0f;
+	}
+	state.amplitudes.Reset();
+}
+
+void FStreamHaptics::Push(const IsarHaptic& haptic, FHandState& state, double now)
+{
+	m_pushFunction(haptic);
+	state.lastSendTime = now;
+}
+
+double FStreamHaptics::GetSendInterval()
+{
+	return 1.0 / FMath::Max(CVarStreamHapticMaxRate.GetValueOnGameThread(), 1);
+}
+
+int32 FStreamHaptics::ToHandIndex(EControllerHand hand)
+{
+	switch (hand)
+	{
+		case EControllerHand::Left: return 0;
+		case EControllerHand::Right: return 1;
+		default: return INDEX_NONE;
+	}
+}
\ No newline at end of file
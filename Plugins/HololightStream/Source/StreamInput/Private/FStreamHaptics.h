@@ -0,0 +1,72 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#ifndef HOLOLIGHT_UNREAL_FSTREAMHAPTICS_H
+#define HOLOLIGHT_UNREAL_FSTREAMHAPTICS_H
+
+#include "StreamInputCommon.h"
+
+#include "GenericPlatform/IInputInterface.h"
+#include "InputCoreTypes.h"
+
+/// <summary>
+/// Turns the force feedback and haptic effects of the engine into IsarHaptic messages for the controller in each hand.
+/// Values set during a frame only overwrite each other, Flush sends what they add up to at most at
+/// vr.StreamHapticMaxRate messages per hand. Amplitudes of frames that fall in between two messages are sent as an
+/// amplitude envelope, sound wave effects are streamed as PCM slightly ahead of playback.
+/// Sending is passed in as a function and all times are passed in, in seconds, so the class does not talk to ISAR.
+/// </summary>
+class FStreamHaptics
+{
+public:
+	using FPushFunction = TFunction<void(const isar::IsarHaptic& haptic)>;
+	// Returns false if the hand has no controller that can vibrate
+	using FFindControllerFunction = TFunctionRef<bool(EControllerHand hand, uint32_t& outControllerIdentifier)>;
+
+	explicit FStreamHaptics(FPushFunction pushFunction);
+
+	// Game thread, large and small motors of a hand add up to one vibration
+	void SetForceFeedback(FForceFeedbackChannelType channel, float value);
+	void SetEffectValues(EControllerHand hand, float amplitude);
+	// Game thread, takes the samples of the buffer that are due by now and moves the buffer's play position
+	void QueuePcm(EControllerHand hand, FHapticFeedbackBuffer& buffer, double now);
+	// Game thread, once per frame
+	void Flush(double now, FFindControllerFunction findController);
+
+private:
+	static constexpr int32 HAND_COUNT = 2;
+	// Envelopes are cut to the most recent frames if the rate is low compared to the frame rate
+	static constexpr int32 MAX_ENVELOPE_SAMPLES = 32;
+
+	struct FHandState
+	{
+		float forceFeedbackLarge = 0.0f;
+		float forceFeedbackSmall = 0.0f;
+		float effectAmplitude = 0.0f;
+		// One amplitude per frame since the last message
+		TArray<float, TInlineAllocator<MAX_ENVELOPE_SAMPLES>> amplitudes;
+		double amplitudesStartTime = 0.0;
+		// PCM samples due since the last message
+		TArray<uint8> pcmSamples;
+		float pcmSampleRate = 0.0f;
+		bool pcmAppend = false;
+		double pcmStartTime = 0.0;
+		double pcmEndTime = 0.0;
+		double lastSendTime = -1.0;
+		float sentAmplitude = 0.0f;
+		// Whether the last message may have left the actuator running
+		bool active = false;
+	};
+
+	FPushFunction m_pushFunction;
+	FHandState m_hands[HAND_COUNT];
+
+	static double GetSendInterval();
+	static int32 ToHandIndex(EControllerHand hand);
+	void FlushHand(FHandState& state, EControllerHand hand, double now, double interval,
+				   FFindControllerFunction findController);
+	void Push(const isar::IsarHaptic& haptic, FHandState& state, double now);
+};
+
+#endif // HOLOLIGHT_UNREAL_FSTREAMHAPTICS_H
\ No newline at end of file
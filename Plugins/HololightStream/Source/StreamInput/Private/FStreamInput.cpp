@@ -13,6 +13,7 @@
 #include "EnhancedInputDeveloperSettings.h"
 
 #include "Async/Async.h"
+#include "ProfilingDebugging/CsvProfiler.h"
 
 #if WITH_EDITOR
 #include "EnhancedInputEditorSubsystem.h"
@@ -27,6 +28,14 @@
 
 using namespace isar;
 
+CSV_DEFINE_CATEGORY(StreamInput, true);
+
+static TAutoConsoleVariable<float> CVarStreamInputAnalogDeadband(
+	TEXT("vr.StreamInputAnalogDeadband"),
+	0.01f,
+	TEXT("Minimum change of an analog value before the Stream plugin sends it to legacy input again."),
+	ECVF_Default);
+
 namespace stream_source_names
 {
 static const FName LEFT("Left");
@@ -66,12 +75,40 @@ inline uint32_t MapToDeviceID(IsarInteractionSourceState sourceState)
 	return (sourceState.controllerData.controllerIdentifier * 2) + (uint32_t)sourceState.controllerData.handedness + 1u;
 }
 
+inline IsarSpatialInteractionSourceHandedness ToHandedness(EControllerHand hand)
+{
+	switch (hand)
+	{
+		case EControllerHand::Left: return IsarSpatialInteractionSourceHandedness_LEFT;
+		case EControllerHand::Right: return IsarSpatialInteractionSourceHandedness_RIGHT;
+		default: return IsarSpatialInteractionSourceHandedness_UNSPECIFIED;
+	}
+}
+
+inline IsarSpatialInteractionSourceHandedness ToHandedness(const FName motionSource)
+{
+	if (motionSource == stream_source_names::LEFT || motionSource == stream_source_names::LEFT_PALM || motionSource ==
+		stream_source_names::LEFT_AIM)
+	{
+		return IsarSpatialInteractionSourceHandedness_LEFT;
+	}
+	if (motionSource == stream_source_names::RIGHT || motionSource == stream_source_names::RIGHT_PALM ||
+		motionSource == stream_source_names::RIGHT_AIM)
+	{
+		return IsarSpatialInteractionSourceHandedness_RIGHT;
+	}
+	return IsarSpatialInteractionSourceHandedness_UNSPECIFIED;
+}
+
 FStreamInput::FStreamInput()
 	  : m_streamConnection(nullptr)
 	  , m_serverApi(nullptr)
 	  , m_messageHandler(new FGenericApplicationMessageHandler())
 	  , m_actionsAttached(false)
+	  , m_haptics([this](const IsarHaptic& haptic) { PushHaptic(haptic); })
 {
+	RemoveAllControllers();
+
 	IModularFeatures::Get().RegisterModularFeature(IMotionController::GetModularFeatureName(),
 												   static_cast<IMotionController*>(this));
 	IModularFeatures::Get().RegisterModularFeature(IHandTracker::GetModularFeatureName(),
@@ -152,9 +189,12 @@ void FStreamInput::Start()
 	m_useEnhancedActions = !m_inputMappingContextToPriorityMap.IsEmpty();
 	if (m_useEnhancedActions)
 	{
-		for (auto& controller : m_xrControllers)
+		for (auto& controller : m_controllerSlots)
 		{
-			MapEnhancedActions(controller);
+			if (controller.inUse)
+			{
+				MapEnhancedActions(controller);
+			}
 		}
 	}
 }
@@ -173,8 +213,13 @@ void FStreamInput::OnConnectionStateChanged(IsarConnectionState newState)
 		return;
 	}
 		
-	for (auto controller : m_xrControllers)
+	for (const auto& controller : m_controllerSlots)
 	{
+		if (!controller.inUse)
+		{
+			continue;
+		}
+
 		FStreamControllerStateInfo newStateInfo
 		{
 			.ControllerName = FName(DEVICE_NAMES.at(controller.controllerType).c_str()),
@@ -195,7 +240,7 @@ void FStreamInput::OnConnectionStateChanged(IsarConnectionState newState)
 					});
 	}
 
-	m_xrControllers.clear();
+	RemoveAllControllers();
 }
 
 void FStreamInput::EnumerateSources(TArray<FMotionControllerSource>& sourcesOut) const
@@ -230,8 +275,9 @@ bool FStreamInput::AttachInputMappingContexts(const TSet<TObjectPtr<UInputMappin
 
 	m_useEnhancedActions = !m_inputMappingContextToPriorityMap.IsEmpty();
 	if (m_useEnhancedActions)
-		for (auto& controller : m_xrControllers)
-			MapEnhancedActions(controller);
+		for (auto& controller : m_controllerSlots)
+			if (controller.inUse)
+				MapEnhancedActions(controller);
 
 	return true;
 }
@@ -257,11 +303,10 @@ inline IsarVector3 ApplyControlerOffset(IsarPose const& inputPose, IsarVector3 o
 	return outputPosition;
 }
 
-FStreamInput::StreamControllerUpdateData FStreamInput::CreateUpdateData(const IsarInteractionSourceState& sourceState)
+void FStreamInput::UpdateControllerData(const IsarInteractionSourceState& sourceState,
+										StreamControllerUpdateData& outData)
 {
-	StreamControllerUpdateData data{};
-
-	data.controllerPose = sourceState.controllerData.controllerPose;
+	outData.controllerPose = sourceState.controllerData.controllerPose;
 
 	// Apply additional required controller offset for proper visualization (version 2024.0 and earlier
 	// versions executed this on the client device directly)(Only Quest controllers and the Stylus)
@@ -273,13 +318,15 @@ FStreamInput::StreamControllerUpdateData FStreamInput::CreateUpdateData(const Is
 		case IsarXRControllerType::IsarXRControllerType_Meta_Quest_3S_Controller:
 		{
 			// These hard coded values corrected controller model visualization
-			data.controllerPose.position = ApplyControlerOffset(data.controllerPose, IsarVector3(0, 0.03f, -0.04f));
+			outData.controllerPose.position = ApplyControlerOffset(outData.controllerPose,
+																   IsarVector3(0, 0.03f, -0.04f));
 			break;
 		}
 		case IsarXRControllerType::IsarXRControllerType_Logitech_MX_Ink_Stylus:
 		{
 			// These hard coded values corrected stylus model visualization
-			data.controllerPose.position = ApplyControlerOffset(data.controllerPose, IsarVector3(0, 0.03f, -0.1f));
+			outData.controllerPose.position = ApplyControlerOffset(outData.controllerPose,
+																   IsarVector3(0, 0.03f, -0.1f));
 			break;
 		}
 		default:
@@ -288,17 +335,16 @@ FStreamInput::StreamControllerUpdateData FStreamInput::CreateUpdateData(const Is
 		}
 	}
 
-	data.pointerPose = sourceState.controllerData.pointerPose;
-	data.handData = sourceState.controllerData.handData;
-
-	data.buttons.resize(sourceState.controllerData.buttonsLength);
-	memcpy(data.buttons.data(), sourceState.controllerData.buttons, data.buttons.size() * sizeof(IsarButton));
-	data.axis1D.resize(sourceState.controllerData.axis1DLength);
-	memcpy(data.axis1D.data(), sourceState.controllerData.axis1D, data.axis1D.size() * sizeof(IsarAxis1D));
-	data.axis2D.resize(sourceState.controllerData.axis2DLength);
-	memcpy(data.axis2D.data(), sourceState.controllerData.axis2D, data.axis2D.size() * sizeof(IsarAxis2D));
+	outData.pointerPose = sourceState.controllerData.pointerPose;
+	outData.handData = sourceState.controllerData.handData;
 
-	return data;
+	// Reset keeps the inline storage, Append only allocates if the client sends more features than ISAR defines
+	outData.buttons.Reset();
+	outData.buttons.Append(sourceState.controllerData.buttons, sourceState.controllerData.buttonsLength);
+	outData.axis1D.Reset();
+	outData.axis1D.Append(sourceState.controllerData.axis1D, sourceState.controllerData.axis1DLength);
+	outData.axis2D.Reset();
+	outData.axis2D.Append(sourceState.controllerData.axis2D, sourceState.controllerData.axis2DLength);
 }
 
 void FStreamInput::Tick(float deltaTime)
@@ -313,33 +359,32 @@ void FStreamInput::Tick(float deltaTime)
 	if (err || !outputCount)
 		return;
 
-	std::vector<IsarSpatialInput> spatialInput{};
-	spatialInput.resize(outputCount);
+	// Reset keeps the allocation of earlier frames, the staging buffer only grows when more inputs are queued
+	m_spatialInputStaging.Reset();
+	m_spatialInputStaging.AddUninitialized(outputCount);
 
-	err = m_serverApi->pullSpatialInput(m_streamConnection, spatialInput.data(), spatialInput.size(), nullptr);
+	err = m_serverApi->pullSpatialInput(m_streamConnection, m_spatialInputStaging.GetData(),
+										m_spatialInputStaging.Num(), nullptr);
 	if (err)
 		return;
 
-	for (auto& input : spatialInput)
+	for (auto& input : m_spatialInputStaging)
 	{
-		auto sourceState = reinterpret_cast<IsarInteractionSourceState&>(input.data);
+		auto& sourceState = reinterpret_cast<IsarInteractionSourceState&>(input.data);
 		switch (input.type)
 		{
 			case IsarInputType_SOURCE_PRESSED:
 			case IsarInputType_SOURCE_RELEASED:
 			case IsarInputType_SOURCE_UPDATED:
 			{
-				auto deviceId = MapToDeviceID(sourceState);
-				auto controller = std::find_if(m_xrControllers.begin(), m_xrControllers.end(),
-											   [deviceId](auto const& e) { return e.deviceId == deviceId; });
-
-				if (controller == m_xrControllers.end())
+				StreamController* controller = FindControllerByDeviceId(MapToDeviceID(sourceState));
+				if (!controller)
 				{
 					break;
 				}
 
 				controller->state = ControllerTrackingState::Tracking;
-				controller->updateData = CreateUpdateData(sourceState);
+				UpdateControllerData(sourceState, controller->updateData);
 				break;
 			}
 			case IsarInputType_SOURCE_DETECTED:
@@ -349,11 +394,8 @@ void FStreamInput::Tick(float deltaTime)
 			}
 			case IsarInputType_SOURCE_LOST:
 			{
-				auto deviceId = MapToDeviceID(sourceState);
-				auto controller = std::find_if(m_xrControllers.begin(), m_xrControllers.end(),
-											   [deviceId](auto const& e) { return e.deviceId == deviceId; });
-
-				if (controller == m_xrControllers.end())
+				StreamController* controller = FindControllerByDeviceId(MapToDeviceID(sourceState));
+				if (!controller)
 				{
 					break;
 				}
@@ -378,7 +420,7 @@ void FStreamInput::Tick(float deltaTime)
 						  });
 
 				controller->state = ControllerTrackingState::Lost;
-				m_xrControllers.erase(controller);
+				RemoveController(*controller);
 				break;
 			}
 			default: break;
@@ -400,17 +442,19 @@ void FStreamInput::SendControllerEvents()
 		return;
 
 	IPlatformInputDeviceMapper& deviceMapper = IPlatformInputDeviceMapper::Get();
+	const float deadband = FMath::Max(CVarStreamInputAnalogDeadband.GetValueOnGameThread(), 0.0f);
+	const uint64 suppressedEventsBefore = m_suppressedEvents;
 
-	for (auto& controller : m_xrControllers)
+	for (auto& controller : m_controllerSlots)
 	{
-		if (controller.state != ControllerTrackingState::Tracking)
-			return;
+		if (!controller.inUse || controller.state != ControllerTrackingState::Tracking)
+			continue;
 		auto& sourceData = controller.updateData;
 
 		if (m_useEnhancedActions)
 		{
 			// Buttons
-			for (uint32_t i = 0; i < sourceData.buttons.size(); i++)
+			for (int32 i = 0; i < sourceData.buttons.Num(); i++)
 			{
 				isar::IsarXRControllerFeatureKind featureKind;
 				// Setting the docked state alone because IsarXRControllerFeatureKind_DOCKED is not in sequence of the buttons group in IsarXRControllerFeatureKind enum.
@@ -421,130 +465,34 @@ void FStreamInput::SendControllerEvents()
 					featureKind = (isar::IsarXRControllerFeatureKind)(sourceData.buttons[i].identifier +
 						isar::IsarXRControllerFeatureKind_BUTTON_HOME);
 
-				if (!controller.streamToEnhancedActions.contains(featureKind))
-					continue;
-				auto inputValue = FInputActionValue(sourceData.buttons[i].value);
-				for (auto& mapping : controller.streamToEnhancedActions[featureKind])
-				{
-					auto injectSubsystemInput = [inputValue, mapping](IEnhancedInputSubsystemInterface* subsystem)
-					{
-						if (subsystem)
-						{
-							subsystem->InjectInputForAction(mapping.Action, inputValue, mapping.Modifiers,
-															mapping.Triggers);
-						}
-					};
-
-					IEnhancedInputModule::Get().GetLibrary()->ForEachSubsystem(injectSubsystemInput);
-#if WITH_EDITOR
-					if (GEditor)
-					{
-						// UEnhancedInputLibrary::ForEachSubsystem only enumerates runtime subsystems.
-						injectSubsystemInput(GEditor->GetEditorSubsystem<UEnhancedInputEditorSubsystem>());
-					}
-#endif
-				}
+				QueueEnhancedActions(controller, featureKind, FInputActionValue(sourceData.buttons[i].value));
 			}
 
 			// Axis1D
-			for (uint32_t i = 0; i < sourceData.axis1D.size(); i++)
+			for (int32 i = 0; i < sourceData.axis1D.Num(); i++)
 			{
 				auto featureKind = (isar::IsarXRControllerFeatureKind)(sourceData.axis1D[i].identifier +
 					isar::IsarXRControllerFeatureKind_BUTTON_PRIMARY_TRIGGER_PRESS);
-				if (controller.streamToEnhancedActions.contains(featureKind))
-				{
-					auto inputValue = FInputActionValue(sourceData.axis1D[i].value > 0.9f);
-					for (auto& mapping : controller.streamToEnhancedActions[featureKind])
-					{
-						auto injectSubsystemInput = [inputValue, mapping](IEnhancedInputSubsystemInterface* subsystem)
-						{
-							if (subsystem)
-							{
-								subsystem->InjectInputForAction(mapping.Action, inputValue, mapping.Modifiers,
-																mapping.Triggers);
-							}
-						};
-
-						IEnhancedInputModule::Get().GetLibrary()->ForEachSubsystem(injectSubsystemInput);
-#if WITH_EDITOR
-						if (GEditor)
-						{
-							// UEnhancedInputLibrary::ForEachSubsystem only enumerates runtime subsystems.
-							injectSubsystemInput(GEditor->GetEditorSubsystem<UEnhancedInputEditorSubsystem>());
-						}
-#endif
-					}
-				}
+				QueueEnhancedActions(controller, featureKind, FInputActionValue(sourceData.axis1D[i].value > 0.9f));
 
 				featureKind = (isar::IsarXRControllerFeatureKind)(sourceData.axis1D[i].identifier +
 					isar::IsarXRControllerFeatureKind_AXIS1D_PRIMARY_TRIGGER);
-				if (!controller.streamToEnhancedActions.contains(featureKind))
-					continue;
-				auto inputValue = FInputActionValue(sourceData.axis1D[i].value);
-				for (auto& mapping : controller.streamToEnhancedActions[featureKind])
-				{
-					auto injectSubsystemInput = [inputValue, mapping](IEnhancedInputSubsystemInterface* subsystem)
-					{
-						if (subsystem)
-						{
-							subsystem->InjectInputForAction(mapping.Action, inputValue, mapping.Modifiers,
-															mapping.Triggers);
-						}
-					};
-
-					IEnhancedInputModule::Get().GetLibrary()->ForEachSubsystem(injectSubsystemInput);
-#if WITH_EDITOR
-					if (GEditor)
-					{
-						// UEnhancedInputLibrary::ForEachSubsystem only enumerates runtime subsystems.
-						injectSubsystemInput(GEditor->GetEditorSubsystem<UEnhancedInputEditorSubsystem>());
-					}
-#endif
-				}
+				QueueEnhancedActions(controller, featureKind, FInputActionValue(sourceData.axis1D[i].value));
 			}
 
 			// Axis2D
-			for (uint32_t i = 0; i < sourceData.axis2D.size(); i++)
+			for (int32 i = 0; i < sourceData.axis2D.Num(); i++)
 			{
 				auto featureKind = (isar::IsarXRControllerFeatureKind)(sourceData.axis2D[i].identifier +
 					isar::IsarXRControllerFeatureKind_AXIS2D_PRIMARY_ANALOG_STICK);
-				if (!controller.streamToEnhancedActions.contains(featureKind))
-					continue;
-				for (auto& mapping : controller.streamToEnhancedActions[featureKind])
-				{
-					FInputActionValue inputValue;
-					if (mapping.Action->ValueType == EInputActionValueType::Axis2D)
-						inputValue = FInputActionValue(
-							FVector2D(sourceData.axis2D[i].value.x, sourceData.axis2D[i].value.y));
-					else if (mapping.Key.GetFName().ToString().Contains("_X"))
-						inputValue = FInputActionValue(sourceData.axis2D[i].value.x);
-					else
-						inputValue = FInputActionValue(sourceData.axis2D[i].value.y);
-
-					auto injectSubsystemInput = [inputValue, mapping](IEnhancedInputSubsystemInterface* subsystem)
-					{
-						if (subsystem)
-						{
-							subsystem->InjectInputForAction(mapping.Action, inputValue, mapping.Modifiers,
-															mapping.Triggers);
-						}
-					};
-
-					IEnhancedInputModule::Get().GetLibrary()->ForEachSubsystem(injectSubsystemInput);
-#if WITH_EDITOR
-					if (GEditor)
-					{
-						// UEnhancedInputLibrary::ForEachSubsystem only enumerates runtime subsystems.
-						injectSubsystemInput(GEditor->GetEditorSubsystem<UEnhancedInputEditorSubsystem>());
-					}
-#endif
-				}
+				auto inputValue = FInputActionValue(FVector2D(sourceData.axis2D[i].value.x, sourceData.axis2D[i].value.y));
+				QueueEnhancedActions(controller, featureKind, inputValue);
 			}
 		}
 		else
 		{
 			// Buttons
-			for (uint32_t i = 0; i < sourceData.buttons.size(); i++)
+			for (int32 i = 0; i < sourceData.buttons.Num(); i++)
 			{
 				isar::IsarXRControllerFeatureKind featureKind;
 				// Setting the docked state alone because IsarXRControllerFeatureKind_DOCKED is not in sequence of the buttons group in IsarXRControllerFeatureKind enum.
@@ -555,35 +503,39 @@ void FStreamInput::SendControllerEvents()
 					featureKind = (isar::IsarXRControllerFeatureKind)(sourceData.buttons[i].identifier +
 						isar::IsarXRControllerFeatureKind_BUTTON_HOME);
 
-				if (!controller.streamToKeyName.contains(featureKind))
+				auto keyName = controller.streamToKeyName.find(featureKind);
+				if (keyName == controller.streamToKeyName.end() ||
+					!ShouldSendButton(controller.legacyState[featureKind][0], sourceData.buttons[i].value))
 					continue;
 				if (sourceData.buttons[i].value)
-					m_messageHandler->OnControllerButtonPressed(controller.streamToKeyName[featureKind],
+					m_messageHandler->OnControllerButtonPressed(keyName->second,
 																deviceMapper.GetPrimaryPlatformUser(),
 																deviceMapper.GetDefaultInputDevice(), /*IsRepeat =*/
 																false);
 				else
-					m_messageHandler->OnControllerButtonReleased(controller.streamToKeyName[featureKind],
+					m_messageHandler->OnControllerButtonReleased(keyName->second,
 																 deviceMapper.GetPrimaryPlatformUser(),
 																 deviceMapper.GetDefaultInputDevice(), /*IsRepeat =*/
 																 false);
 			}
 
 			// Axis1D
-			for (uint32_t i = 0; i < sourceData.axis1D.size(); i++)
+			for (int32 i = 0; i < sourceData.axis1D.Num(); i++)
 			{
 				auto featureKind = (isar::IsarXRControllerFeatureKind)(sourceData.axis1D[i].identifier +
 					isar::IsarXRControllerFeatureKind_BUTTON_PRIMARY_TRIGGER_PRESS);
-				if (controller.streamToKeyName.contains(featureKind))
+				auto keyName = controller.streamToKeyName.find(featureKind);
+				bool buttonPress = sourceData.axis1D[i].value > 0.9f;
+				if (keyName != controller.streamToKeyName.end() &&
+					ShouldSendButton(controller.legacyState[featureKind][0], buttonPress))
 				{
-					bool buttonPress = sourceData.axis1D[i].value > 0.9f;
 					if (buttonPress)
-						m_messageHandler->OnControllerButtonPressed(controller.streamToKeyName[featureKind],
+						m_messageHandler->OnControllerButtonPressed(keyName->second,
 																	deviceMapper.GetPrimaryPlatformUser(),
 																	deviceMapper.GetDefaultInputDevice(), /*IsRepeat =*/
 																	false);
 					else
-						m_messageHandler->OnControllerButtonReleased(controller.streamToKeyName[featureKind],
+						m_messageHandler->OnControllerButtonReleased(keyName->second,
 																	 deviceMapper.GetPrimaryPlatformUser(),
 																	 deviceMapper.GetDefaultInputDevice(),
 																	 /*IsRepeat =*/false);
@@ -591,30 +543,239 @@ void FStreamInput::SendControllerEvents()
 
 				featureKind = (isar::IsarXRControllerFeatureKind)(sourceData.axis1D[i].identifier +
 					isar::IsarXRControllerFeatureKind_AXIS1D_PRIMARY_TRIGGER);
-				if (!controller.streamToKeyName.contains(featureKind))
+				keyName = controller.streamToKeyName.find(featureKind);
+				if (keyName == controller.streamToKeyName.end() ||
+					!ShouldSendAnalog(controller.legacyState[featureKind][0], sourceData.axis1D[i].value, deadband))
 					continue;
-				m_messageHandler->OnControllerAnalog(controller.streamToKeyName[featureKind],
+				m_messageHandler->OnControllerAnalog(keyName->second,
 													 deviceMapper.GetPrimaryPlatformUser(),
 													 deviceMapper.GetDefaultInputDevice(), sourceData.axis1D[i].value);
 			}
 
 			// Axis2D - Legacy system only supports 2D as two paired 1D axes
-			for (uint32_t i = 0; i < sourceData.axis2D.size(); i++)
+			for (int32 i = 0; i < sourceData.axis2D.Num(); i++)
 			{
 				auto featureKind = (isar::IsarXRControllerFeatureKind)(sourceData.axis2D[i].identifier +
 					isar::IsarXRControllerFeatureKind_AXIS2D_PRIMARY_ANALOG_STICK);
-				if (!controller.streamToKeyName.contains(featureKind))
+				auto keyName = controller.streamToKeyName.find(featureKind);
+				if (keyName == controller.streamToKeyName.end())
 					continue;
-				auto& keyPair = m_2DAxisMap[controller.streamToKeyName[featureKind]];
-				m_messageHandler->OnControllerAnalog(keyPair.first, deviceMapper.GetPrimaryPlatformUser(),
-													 deviceMapper.GetDefaultInputDevice(),
-													 sourceData.axis2D[i].value.x);
-				m_messageHandler->OnControllerAnalog(keyPair.second, deviceMapper.GetPrimaryPlatformUser(),
-													 deviceMapper.GetDefaultInputDevice(),
-													 sourceData.axis2D[i].value.y);
+				auto& keyPair = m_2DAxisMap[keyName->second];
+				if (ShouldSendAnalog(controller.legacyState[featureKind][0], sourceData.axis2D[i].value.x, deadband))
+					m_messageHandler->OnControllerAnalog(keyPair.first, deviceMapper.GetPrimaryPlatformUser(),
+														 deviceMapper.GetDefaultInputDevice(),
+														 sourceData.axis2D[i].value.x);
+				if (ShouldSendAnalog(controller.legacyState[featureKind][1], sourceData.axis2D[i].value.y, deadband))
+					m_messageHandler->OnControllerAnalog(keyPair.second, deviceMapper.GetPrimaryPlatformUser(),
+														 deviceMapper.GetDefaultInputDevice(),
+														 sourceData.axis2D[i].value.y);
 			}
 		}
 	}
+
+	CSV_CUSTOM_STAT(StreamInput, SuppressedEvents, int32(m_suppressedEvents - suppressedEventsBefore),
+					ECsvCustomStatOp::Accumulate);
+
+	m_haptics.Flush(FPlatformTime::Seconds(), [this](EControllerHand hand, uint32_t& outControllerIdentifier)
+	{
+		// Tracked hands have nothing that could vibrate, a controller held in a tracked hand still does
+		const StreamController* controller = FindControllerDeviceByHandedness(ToHandedness(hand));
+		if (!controller)
+			return false;
+		outControllerIdentifier = controller->controllerType;
+		return true;
+	});
+	InjectEnhancedActions();
+}
+
+bool FStreamInput::ShouldSendButton(StreamLegacyInputState& state, bool pressed)
+{
+	// The message handler keeps the key state, only the press and release edges need to reach it
+	const float value = pressed ? 1.0f : 0.0f;
+	if (state.sent && state.value == value)
+	{
+		m_suppressedEvents++;
+		return false;
+	}
+
+	state.value = value;
+	state.sent = true;
+	return true;
+}
+
+bool FStreamInput::ShouldSendAnalog(StreamLegacyInputState& state, float value, float deadband)
+{
+	// Returning to rest is always sent, otherwise an axis could stay just off zero
+	const bool returnedToRest = value == 0.0f && state.value != 0.0f;
+	if (state.sent && !returnedToRest && FMath::Abs(value - state.value) < deadband)
+	{
+		m_suppressedEvents++;
+		return false;
+	}
+
+	state.value = value;
+	state.sent = true;
+	return true;
+}
+
+void FStreamInput::GatherLegacyReleases(const StreamController& controller,
+										TArray<StreamLegacyRelease>& outReleases) const
+{
+	// In feature order, so the events do not depend on the order of the key map
+	for (int32 feature = 0; feature < FEATURE_KIND_COUNT; feature++)
+	{
+		auto keyName = controller.streamToKeyName.find((IsarXRControllerFeatureKind)feature);
+		if (keyName == controller.streamToKeyName.end())
+			continue;
+
+		const StreamLegacyInputState* states = controller.legacyState[feature];
+		const bool isAxis1D = feature >= IsarXRControllerFeatureKind_AXIS1D_PRIMARY_TRIGGER &&
+			feature <= IsarXRControllerFeatureKind_AXIS1D_SECONDARY_SQUEEZE;
+		const bool isAxis2D = feature >= IsarXRControllerFeatureKind_AXIS2D_PRIMARY_ANALOG_STICK &&
+			feature <= IsarXRControllerFeatureKind_AXIS2D_SECONDARY_ANALOG_STICK;
+		if (isAxis2D)
+		{
+			const std::pair<FName, FName>* axisKeys = m_2DAxisMap.Find(keyName->second);
+			if (!axisKeys)
+				continue;
+			if (states[0].sent && states[0].value != 0.0f)
+				outReleases.Add({axisKeys->first, false});
+			if (states[1].sent && states[1].value != 0.0f)
+				outReleases.Add({axisKeys->second, false});
+		}
+		else if (states[0].sent && states[0].value != 0.0f)
+		{
+			outReleases.Add({keyName->second, !isAxis1D});
+		}
+	}
+}
+
+void FStreamInput::SendLegacyReleases(FGenericApplicationMessageHandler& messageHandler,
+									  const TArray<StreamLegacyRelease>& releases)
+{
+	IPlatformInputDeviceMapper& deviceMapper = IPlatformInputDeviceMapper::Get();
+	for (const StreamLegacyRelease& release : releases)
+	{
+		if (release.button)
+			messageHandler.OnControllerButtonReleased(release.keyName, deviceMapper.GetPrimaryPlatformUser(),
+													  deviceMapper.GetDefaultInputDevice(), /*IsRepeat =*/false);
+		else
+			messageHandler.OnControllerAnalog(release.keyName, deviceMapper.GetPrimaryPlatformUser(),
+											  deviceMapper.GetDefaultInputDevice(), 0.0f);
+	}
+}
+
+void FStreamInput::QueueEnhancedActions(const StreamController& controller,
+										isar::IsarXRControllerFeatureKind featureKind,
+										const FInputActionValue& inputValue)
+{
+	if (featureKind < 0 || featureKind >= FEATURE_KIND_COUNT)
+		return;
+
+	const StreamFeatureDispatch& dispatch = controller.featureDispatch[featureKind];
+	for (int32 i = dispatch.firstBinding; i < dispatch.firstBinding + dispatch.numBindings; i++)
+	{
+		const StreamEnhancedActionBinding& binding = controller.enhancedBindings[i];
+		StreamEnhancedActionInjection& injection = m_enhancedInjections.AddDefaulted_GetRef();
+		injection.binding = &binding;
+		switch (binding.component)
+		{
+		case EnhancedAxisComponent::X:
+			injection.value = FInputActionValue(static_cast<float>(inputValue.Get<FVector2D>().X));
+			break;
+		case EnhancedAxisComponent::Y:
+			injection.value = FInputActionValue(static_cast<float>(inputValue.Get<FVector2D>().Y));
+			break;
+		default:
+			injection.value = inputValue;
+			break;
+		}
+	}
+}
+
+void FStreamInput::InjectEnhancedActions()
+{
+	if (m_enhancedInjections.IsEmpty())
+		return;
+
+	// One pass over the subsystems per frame, injecting everything the controllers produced
+	auto injectSubsystemInput = [this](IEnhancedInputSubsystemInterface* subsystem)
+	{
+		if (!subsystem)
+			return;
+		for (const StreamEnhancedActionInjection& injection : m_enhancedInjections)
+		{
+			const FEnhancedActionKeyMapping& mapping = injection.binding->mapping;
+			subsystem->InjectInputForAction(mapping.Action, injection.value, mapping.Modifiers, mapping.Triggers);
+		}
+	};
+
+	IEnhancedInputModule::Get().GetLibrary()->ForEachSubsystem(injectSubsystemInput);
+#if WITH_EDITOR
+	if (GEditor)
+	{
+		// UEnhancedInputLibrary::ForEachSubsystem only enumerates runtime subsystems.
+		injectSubsystemInput(GEditor->GetEditorSubsystem<UEnhancedInputEditorSubsystem>());
+	}
+#endif
+
+	m_enhancedInjections.Reset();
+}
+
+void FStreamInput::SetChannelValue(int32 controllerId, FForceFeedbackChannelType channelType, float value)
+{
+	// Stream input is sent as the primary platform user, whose controller id is 0
+	if (controllerId != 0)
+		return;
+
+	m_haptics.SetForceFeedback(channelType, value);
+}
+
+void FStreamInput::SetChannelValues(int32 controllerId, const FForceFeedbackValues& values)
+{
+	if (controllerId != 0)
+		return;
+
+	m_haptics.SetForceFeedback(FForceFeedbackChannelType::LEFT_LARGE, values.LeftLarge);
+	m_haptics.SetForceFeedback(FForceFeedbackChannelType::LEFT_SMALL, values.LeftSmall);
+	m_haptics.SetForceFeedback(FForceFeedbackChannelType::RIGHT_LARGE, values.RightLarge);
+	m_haptics.SetForceFeedback(FForceFeedbackChannelType::RIGHT_SMALL, values.RightSmall);
+}
+
+void FStreamInput::SetHapticFeedbackValues(int32 controllerId, int32 hand, const FHapticFeedbackValues& values)
+{
+	if (controllerId != 0)
+		return;
+
+	// Sound wave effects come as a buffer, curve and buffer effects as the amplitude of the frame
+	if (values.HapticBuffer)
+		m_haptics.QueuePcm((EControllerHand)hand, *values.HapticBuffer, FPlatformTime::Seconds());
+	else
+		m_haptics.SetEffectValues((EControllerHand)hand, values.Amplitude);
+}
+
+void FStreamInput::GetHapticFrequencyRange(float& minFrequency, float& maxFrequency) const
+{
+	// The frequency is left to the client, see FStreamHaptics
+	minFrequency = 0.0f;
+	maxFrequency = 1.0f;
+}
+
+float FStreamInput::GetHapticAmplitudeScale() const
+{
+	return 1.0f;
+}
+
+void FStreamInput::PushHaptic(const IsarHaptic& haptic)
+{
+	if (!m_connected || !m_serverApi)
+		return;
+
+	auto err = m_serverApi->pushHaptic(m_streamConnection, &haptic);
+	if (err != IsarError::eNone)
+	{
+		UE_LOG(LogHMD, Verbose, TEXT("FStreamInput: pushHaptic of type %d failed with error %d"), haptic.type, err);
+	}
 }
 
 void FStreamInput::SetMessageHandler(const TSharedRef<FGenericApplicationMessageHandler>& inMessageHandler)
@@ -627,11 +788,10 @@ void FStreamInput::HandleInputSourceDetected(IsarInteractionSourceState const& s
 	uint32_t deviceId = MapToDeviceID(sourceState);
 
 	// Check if a controller with that already exists (Don't create over existent controller which waits for being disconnected probably)
-	auto existingController = std::find_if(m_xrControllers.begin(), m_xrControllers.end(),
-										   [deviceId](auto const& e) { return e.deviceId == deviceId; });
-	if (existingController != m_xrControllers.end())
+	StreamController* existingController = FindControllerByDeviceId(deviceId);
+	if (existingController)
 	{
-		existingController->updateData = CreateUpdateData(sourceState);
+		UpdateControllerData(sourceState, existingController->updateData);
 		return;
 	}
 
@@ -640,7 +800,7 @@ void FStreamInput::HandleInputSourceDetected(IsarInteractionSourceState const& s
 	controller.state = ControllerTrackingState::Detected;
 	controller.handedness = sourceState.controllerData.handedness;
 	controller.controllerType = (IsarXRControllerType)sourceState.controllerData.controllerIdentifier;
-	controller.updateData = CreateUpdateData(sourceState);
+	UpdateControllerData(sourceState, controller.updateData);
 
 	using namespace stream::keys;
 
@@ -956,8 +1116,6 @@ void FStreamInput::HandleInputSourceDetected(IsarInteractionSourceState const& s
 		MapEnhancedActions(controller);
 	}
 
-	m_xrControllers.push_back(controller);
-
 	FStreamControllerStateInfo newStateInfo
 	{
 		.ControllerName = FName(DEVICE_NAMES.at(controller.controllerType).c_str()),
@@ -966,6 +1124,13 @@ void FStreamInput::HandleInputSourceDetected(IsarInteractionSourceState const& s
 		.Hand = (EControllerHand)(controller.handedness - 1)
 	};
 
+	if (!AddController(MoveTemp(controller)))
+	{
+		UE_LOG(LogHMD, Warning, TEXT("All %d controller slots are in use, ignoring device %u"), MAX_CONTROLLERS,
+			   deviceId);
+		return;
+	}
+
 	// Actors can have functionalities that need to be done on the Game Thread
 	AsyncTask(ENamedThreads::GameThread,
 			  [newStateInfo, controllerStateHandlers = m_controllerStateHandlers]()
@@ -990,39 +1155,19 @@ bool FStreamInput::GetControllerOrientationAndPosition(const int32 controllerInd
 
 	IsarVector3 position;
 	IsarQuaternion orientation;
-	auto it = m_xrControllers.end();
-
-	if (motionSource == stream_source_names::LEFT || motionSource == stream_source_names::LEFT_PALM || motionSource ==
-		stream_source_names::LEFT_AIM)
-	{
-		it = std::find_if(m_xrControllers.begin(), m_xrControllers.end(), [](auto const& controller)
-		{
-			return controller.handedness == IsarSpatialInteractionSourceHandedness_LEFT;
-		});
-
-	}
-	else if (motionSource == stream_source_names::RIGHT || motionSource == stream_source_names::RIGHT_PALM ||
-		motionSource ==
-		stream_source_names::RIGHT_AIM)
-	{
-		it = std::find_if(m_xrControllers.begin(), m_xrControllers.end(), [](auto const& controller)
-		{
-			return controller.handedness == IsarSpatialInteractionSourceHandedness_RIGHT;
-		});
-	}
-
-	if (it == m_xrControllers.end())
+	const StreamController* controller = FindControllerByHandedness(ToHandedness(motionSource));
+	if (!controller)
 		return false;
 
 	if (motionSource == stream_source_names::LEFT_AIM || motionSource == stream_source_names::RIGHT_AIM)
 	{
-		position = it->updateData.pointerPose.position;
-		orientation = it->updateData.pointerPose.orientation;
+		position = controller->updateData.pointerPose.position;
+		orientation = controller->updateData.pointerPose.orientation;
 	}
 	else
 	{
-		position = it->updateData.controllerPose.position;
-		orientation = it->updateData.controllerPose.orientation;
+		position = controller->updateData.controllerPose.position;
+		orientation = controller->updateData.controllerPose.orientation;
 	}
 
 	outPosition = FVector(-position.z * worldToMetersScale, position.x * worldToMetersScale,
@@ -1037,26 +1182,8 @@ ETrackingStatus FStreamInput::GetControllerTrackingStatus(const int32 controller
 	if (!m_connected)
 		return ETrackingStatus::NotTracked;
 
-	auto it = m_xrControllers.end();
-	if (motionSource == stream_source_names::LEFT || motionSource == stream_source_names::LEFT_PALM || motionSource ==
-		stream_source_names::LEFT_AIM)
-	{
-		it = std::find_if(m_xrControllers.begin(), m_xrControllers.end(), [](auto const& controller)
-		{
-			return controller.handedness == IsarSpatialInteractionSourceHandedness_LEFT;
-		});
-	}
-	else if (motionSource == stream_source_names::RIGHT || motionSource == stream_source_names::RIGHT_PALM ||
-		motionSource ==
-		stream_source_names::RIGHT_AIM)
-	{
-		it = std::find_if(m_xrControllers.begin(), m_xrControllers.end(), [](auto const& controller)
-		{
-			return controller.handedness == IsarSpatialInteractionSourceHandedness_RIGHT;
-		});
-	}
-
-	if (it != m_xrControllers.end() && it->state == ControllerTrackingState::Tracking)
+	const StreamController* controller = FindControllerByHandedness(ToHandedness(motionSource));
+	if (controller && controller->state == ControllerTrackingState::Tracking)
 	{
 		return ETrackingStatus::Tracked;
 	}
@@ -1069,12 +1196,7 @@ bool FStreamInput::IsHandTrackingStateValid() const
 	if (!m_connected)
 		return false;
 
-	auto it = std::find_if(m_xrControllers.begin(), m_xrControllers.end(), [](auto const& controller)
-	{
-		return controller.deviceType == TrackedDeviceType::Hand;
-	});
-
-	return it != m_xrControllers.end();
+	return m_handCount > 0;
 }
 
 bool FStreamInput::GetKeypointState(EControllerHand hand, EHandKeypoint keypoint, FTransform& outTransform,
@@ -1083,28 +1205,11 @@ bool FStreamInput::GetKeypointState(EControllerHand hand, EHandKeypoint keypoint
 	if (!m_connected)
 		return false;
 
-	auto it = m_xrControllers.end();
-	if (hand == EControllerHand::Left)
-	{
-		it = std::find_if(m_xrControllers.begin(), m_xrControllers.end(), [](auto const& controller)
-		{
-			return controller.deviceType == TrackedDeviceType::Hand && controller.handedness ==
-				IsarSpatialInteractionSourceHandedness_LEFT;
-		});
-	}
-	else if (hand == EControllerHand::Right)
-	{
-		it = std::find_if(m_xrControllers.begin(), m_xrControllers.end(), [](auto const& controller)
-		{
-			return controller.deviceType == TrackedDeviceType::Hand && controller.handedness ==
-				IsarSpatialInteractionSourceHandedness_RIGHT;
-		});
-	}
-
-	if (it == m_xrControllers.end() || it->state != ControllerTrackingState::Tracking)
+	const StreamController* controller = FindHandByHandedness(ToHandedness(hand));
+	if (!controller || controller->state != ControllerTrackingState::Tracking)
 		return false;
 
-	auto joint = it->updateData.handData.jointPoses[(uint32)keypoint];
+	auto joint = controller->updateData.handData.jointPoses[(uint32)keypoint];
 	outTransform = FTransform(ToFQuat(joint.orientation), ToFVector(joint.position));
 	outRadius = joint.radius;
 
@@ -1117,25 +1222,8 @@ bool FStreamInput::GetAllKeypointStates(EControllerHand hand, TArray<FVector>& o
 	if (!m_connected)
 		return false;
 
-	auto it = m_xrControllers.end();
-	if (hand == EControllerHand::Left)
-	{
-		it = std::find_if(m_xrControllers.begin(), m_xrControllers.end(), [](auto const& controller)
-		{
-			return controller.deviceType == TrackedDeviceType::Hand && controller.handedness ==
-				IsarSpatialInteractionSourceHandedness_LEFT;
-		});
-	}
-	else if (hand == EControllerHand::Right)
-	{
-		it = std::find_if(m_xrControllers.begin(), m_xrControllers.end(), [](auto const& controller)
-		{
-			return controller.deviceType == TrackedDeviceType::Hand && controller.handedness ==
-				IsarSpatialInteractionSourceHandedness_RIGHT;
-		});
-	}
-
-	if (it == m_xrControllers.end() || it->state != ControllerTrackingState::Tracking)
+	const StreamController* controller = FindHandByHandedness(ToHandedness(hand));
+	if (!controller || controller->state != ControllerTrackingState::Tracking)
 		return false;
 
 	outPositions.Empty(EHandKeypointCount);
@@ -1143,7 +1231,7 @@ bool FStreamInput::GetAllKeypointStates(EControllerHand hand, TArray<FVector>& o
 	outRadii.Empty(EHandKeypointCount);
 	for (int i = 0; i <= isar::IsarXRControllerFeatureKind_HAND_LITTLE_TIP; i++)
 	{
-		auto joint = it->updateData.handData.jointPoses[i];
+		auto joint = controller->updateData.handData.jointPoses[i];
 		outPositions.Add(ToFVector(joint.position));
 		outRotations.Add(ToFQuat(joint.orientation));
 		outRadii.Add(joint.radius);
@@ -1163,32 +1251,55 @@ bool FStreamInput::GetAllKeypointStates(EControllerHand hand, TArray<FVector>& o
 
 void FStreamInput::MapEnhancedActions(StreamController& controller)
 {
+	// Rebuilt from scratch, mapping contexts can be attached again while the controller is tracked
+	controller.enhancedBindings.Reset();
+
 	PRAGMA_DISABLE_DEPRECATION_WARNINGS
-	for (const auto& mappingContext : m_inputMappingContextToPriorityMap)
+	for (int32 feature = 0; feature < FEATURE_KIND_COUNT; feature++)
 	{
-		for (const FEnhancedActionKeyMapping& mapping : mappingContext.Key->GetMappings())
+		StreamFeatureDispatch& dispatch = controller.featureDispatch[feature];
+		dispatch.firstBinding = controller.enhancedBindings.Num();
+		dispatch.numBindings = 0;
+
+		auto keyName = controller.streamToKeyName.find((IsarXRControllerFeatureKind)feature);
+		if (keyName == controller.streamToKeyName.end())
+			continue;
+
+		const bool isAxis2D = feature >= IsarXRControllerFeatureKind_AXIS2D_PRIMARY_ANALOG_STICK &&
+			feature <= IsarXRControllerFeatureKind_AXIS2D_SECONDARY_ANALOG_STICK;
+		const std::pair<FName, FName>* axisKeys = m_2DAxisMap.Find(keyName->second);
+		for (const auto& mappingContext : m_inputMappingContextToPriorityMap)
 		{
-			if (!mapping.Action)
+			for (const FEnhancedActionKeyMapping& mapping : mappingContext.Key->GetMappings())
 			{
-				continue;
-			}
+				if (!mapping.Action)
+				{
+					continue;
+				}
 
-			for (auto& [feature, keyName] : controller.streamToKeyName)
-			{
-				if (mapping.Key.GetFName() == keyName)
+				const FName mappingKey = mapping.Key.GetFName();
+				int32 matches = mappingKey == keyName->second ? 1 : 0;
+				if (axisKeys)
 				{
-					controller.streamToEnhancedActions[feature].push_back(mapping);
+					matches += axisKeys->first == mappingKey ? 1 : 0;
+					matches += axisKeys->second == mappingKey ? 1 : 0;
 				}
 
-				if (m_2DAxisMap.Contains(keyName))
+				for (int32 i = 0; i < matches; i++)
 				{
-					if (m_2DAxisMap[keyName].first == mapping.Key.GetFName())
-						controller.streamToEnhancedActions[feature].push_back(mapping);
-					if (m_2DAxisMap[keyName].second == mapping.Key.GetFName())
-						controller.streamToEnhancedActions[feature].push_back(mapping);
+					StreamEnhancedActionBinding& binding = controller.enhancedBindings.AddDefaulted_GetRef();
+					binding.mapping = mapping;
+					// A 2D axis feeds scalar actions one of its components, picked by the key they are bound to
+					if (!isAxis2D || mapping.Action->ValueType == EInputActionValueType::Axis2D)
+						binding.component = EnhancedAxisComponent::Value;
+					else if (mappingKey.ToString().Contains("_X"))
+						binding.component = EnhancedAxisComponent::X;
+					else
+						binding.component = EnhancedAxisComponent::Y;
 				}
 			}
 		}
+		dispatch.numBindings = controller.enhancedBindings.Num() - dispatch.firstBinding;
 	}
 	PRAGMA_ENABLE_DEPRECATION_WARNINGS
 }
@@ -1200,38 +1311,192 @@ DeviceInfo FStreamInput::GetDeviceInfo(EControllerHand hand)
 		return {-1, "", FVector::ZeroVector, FQuat::Identity};
 	}
 
-	auto it = m_xrControllers.end();
-	if (hand == EControllerHand::Left)
+	const StreamController* controller = FindControllerByHandedness(ToHandedness(hand));
+	if (!controller || controller->state != ControllerTrackingState::Tracking)
 	{
-		it = std::find_if(m_xrControllers.begin(), m_xrControllers.end(),
-						  [](auto const& e) {
-							  return e.handedness == IsarSpatialInteractionSourceHandedness_LEFT;
-						  });
+		return {-1, "", FVector::ZeroVector, FQuat::Identity};
 	}
-	else if (hand == EControllerHand::Right)
+
+	
+	auto outPosition = FVector(-controller->updateData.controllerPose.position.z,
+								controller->updateData.controllerPose.position.x,
+								controller->updateData.controllerPose.position.y);
+
+	auto outOrientation = FQuat(-controller->updateData.controllerPose.orientation.z,
+								 controller->updateData.controllerPose.orientation.x,
+								 controller->updateData.controllerPose.orientation.y,
+								-controller->updateData.controllerPose.orientation.w);
+
+	return {(int32_t)controller->deviceId, DEVICE_NAMES.at(controller->controllerType), outPosition, outOrientation};
+}
+
+FStreamInput::StreamController* FStreamInput::AddController(StreamController&& controller)
+{
+	for (int32 slot = 0; slot < MAX_CONTROLLERS; slot++)
 	{
-		it = std::find_if(m_xrControllers.begin(), m_xrControllers.end(),
-						  [](auto const& e) {
-							  return e.handedness == IsarSpatialInteractionSourceHandedness_RIGHT;
-						  });
+		if (m_controllerSlots[slot].inUse)
+		{
+			continue;
+		}
+
+		StreamController& slotController = m_controllerSlots[slot];
+		slotController = MoveTemp(controller);
+		slotController.inUse = true;
+		slotController.detectionOrder = m_nextDetectionOrder++;
+		if (slotController.deviceId < DEVICE_ID_COUNT)
+		{
+			m_deviceIdToSlot[slotController.deviceId] = slot;
+		}
+		RebuildHandednessIndex();
+		return &slotController;
 	}
+	return nullptr;
+}
 
-	if (it == m_xrControllers.end() || it->state != ControllerTrackingState::Tracking)
+void FStreamInput::RemoveController(StreamController& controller)
+{
+	// The message handler keeps the last state it got, keys still held down would stay down. Called from Tick, on the
+	// game thread.
+	TArray<StreamLegacyRelease> releases;
+	GatherLegacyReleases(controller, releases);
+	SendLegacyReleases(m_messageHandler.Get(), releases);
+
+	if (controller.deviceId < DEVICE_ID_COUNT)
 	{
-		return {-1, "", FVector::ZeroVector, FQuat::Identity};
+		m_deviceIdToSlot[controller.deviceId] = INDEX_NONE;
 	}
+	// Drops the key and action maps, the slot is reused by the next detected controller
+	controller = StreamController{};
+	RebuildHandednessIndex();
+}
 
-	
-	auto outPosition = FVector(-it->updateData.controllerPose.position.z,
-								it->updateData.controllerPose.position.x,
-								it->updateData.controllerPose.position.y);
+void FStreamInput::RemoveAllControllers()
+{
+	TArray<StreamLegacyRelease> releases;
+	for (StreamController& controller : m_controllerSlots)
+	{
+		if (controller.inUse)
+		{
+			GatherLegacyReleases(controller, releases);
+		}
+		controller = StreamController{};
+	}
+	if (!releases.IsEmpty())
+	{
+		// Called when the connection drops, on the thread of the connection callback
+		AsyncTask(ENamedThreads::GameThread,
+				  [messageHandler = m_messageHandler, releases = MoveTemp(releases)]()
+				  {
+					  SendLegacyReleases(messageHandler.Get(), releases);
+				  });
+	}
+	for (int32& slot : m_deviceIdToSlot)
+	{
+		slot = INDEX_NONE;
+	}
+	RebuildHandednessIndex();
+}
+
+void FStreamInput::RebuildHandednessIndex()
+{
+	for (int32 handedness = 0; handedness < HANDEDNESS_COUNT; handedness++)
+	{
+		m_handednessToSlot[handedness] = INDEX_NONE;
+		m_handednessToHandSlot[handedness] = INDEX_NONE;
+		m_handednessToControllerSlot[handedness] = INDEX_NONE;
+	}
+	m_handCount = 0;
+
+	// Queries by hand used to get the first matching controller in detection order, keep it that way
+	for (int32 slot = 0; slot < MAX_CONTROLLERS; slot++)
+	{
+		const StreamController& controller = m_controllerSlots[slot];
+		if (controller.inUse && controller.deviceType == TrackedDeviceType::Hand)
+		{
+			m_handCount++;
+		}
+		if (!controller.inUse || controller.handedness < 0 || controller.handedness >= HANDEDNESS_COUNT)
+		{
+			continue;
+		}
 
-	auto outOrientation = FQuat(-it->updateData.controllerPose.orientation.z,
-								 it->updateData.controllerPose.orientation.x,
-								 it->updateData.controllerPose.orientation.y,
-								-it->updateData.controllerPose.orientation.w);
+		int32& handednessSlot = m_handednessToSlot[controller.handedness];
+		if (handednessSlot == INDEX_NONE ||
+			m_controllerSlots[handednessSlot].detectionOrder > controller.detectionOrder)
+		{
+			handednessSlot = slot;
+		}
+
+		int32& handSlot = m_handednessToHandSlot[controller.handedness];
+		if (controller.deviceType == TrackedDeviceType::Hand &&
+			(handSlot == INDEX_NONE || m_controllerSlots[handSlot].detectionOrder > controller.detectionOrder))
+		{
+			handSlot = slot;
+		}
+
+		int32& controllerSlot = m_handednessToControllerSlot[controller.handedness];
+		if (controller.deviceType == TrackedDeviceType::Controller &&
+			(controllerSlot == INDEX_NONE ||
+			 m_controllerSlots[controllerSlot].detectionOrder > controller.detectionOrder))
+		{
+			controllerSlot = slot;
+		}
+	}
+}
+
+FStreamInput::StreamController* FStreamInput::FindControllerByDeviceId(uint32_t deviceId)
+{
+	if (deviceId < DEVICE_ID_COUNT)
+	{
+		const int32 slot = m_deviceIdToSlot[deviceId];
+		return slot != INDEX_NONE ? &m_controllerSlots[slot] : nullptr;
+	}
+
+	// Controller types newer than this plugin do not fit the index
+	for (StreamController& controller : m_controllerSlots)
+	{
+		if (controller.inUse && controller.deviceId == deviceId)
+		{
+			return &controller;
+		}
+	}
+	return nullptr;
+}
+
+const FStreamInput::StreamController* FStreamInput::FindControllerByHandedness(
+	IsarSpatialInteractionSourceHandedness handedness) const
+{
+	if (handedness <= IsarSpatialInteractionSourceHandedness_UNSPECIFIED || handedness >= HANDEDNESS_COUNT)
+	{
+		return nullptr;
+	}
+
+	const int32 slot = m_handednessToSlot[handedness];
+	return slot != INDEX_NONE ? &m_controllerSlots[slot] : nullptr;
+}
+
+const FStreamInput::StreamController* FStreamInput::FindHandByHandedness(
+	IsarSpatialInteractionSourceHandedness handedness) const
+{
+	if (handedness <= IsarSpatialInteractionSourceHandedness_UNSPECIFIED || handedness >= HANDEDNESS_COUNT)
+	{
+		return nullptr;
+	}
+
+	const int32 slot = m_handednessToHandSlot[handedness];
+	return slot != INDEX_NONE ? &m_controllerSlots[slot] : nullptr;
+}
+
+const FStreamInput::StreamController* FStreamInput::FindControllerDeviceByHandedness(
+	IsarSpatialInteractionSourceHandedness handedness) const
+{
+	if (handedness <= IsarSpatialInteractionSourceHandedness_UNSPECIFIED || handedness >= HANDEDNESS_COUNT)
+	{
+		return nullptr;
+	}
 
-	return {(int32_t)it->deviceId, DEVICE_NAMES.at(it->controllerType), outPosition, outOrientation};
+	const int32 slot = m_handednessToControllerSlot[handedness];
+	return slot != INDEX_NONE ? &m_controllerSlots[slot] : nullptr;
 }
 
 void FStreamInput::RegisterControllerStateHandler(
@@ -10,20 +10,23 @@
 #include "IInputDevice.h"
 #include "XRMotionControllerBase.h"
 #include "IHandTracker.h"
+#include "IHapticDevice.h"
 #include "InputMappingContext.h"
+#include "InputActionValue.h"
 #include "UObject/ObjectPtr.h"
 #include "UObject/StrongObjectPtr.h"
 #include "Runtime/Launch/Resources/Version.h"
 
 #include "IStreamExtension.h"
+#include "FStreamHaptics.h"
 
-#include <vector>
 #include <unordered_map>
 #include <utility>
 
 using namespace isar;
 
-class STREAMINPUT_API FStreamInput : public IInputDevice, public FXRMotionControllerBase, public IHandTracker, public IStreamExtension
+class STREAMINPUT_API FStreamInput : public IInputDevice, public FXRMotionControllerBase, public IHandTracker,
+									 public IHapticDevice, public IStreamExtension
 {
 public:
 	FStreamInput();
@@ -42,13 +45,14 @@ public:
 	void SetMessageHandler(const TSharedRef<FGenericApplicationMessageHandler>& inMessageHandler) override;
 	bool Exec(UWorld* inWorld, const TCHAR* cmd, FOutputDevice& ar) override { return true; };
 
-	void SetChannelValue(int32 controllerId, FForceFeedbackChannelType channelType, float value) override
-	{
-	};
+	void SetChannelValue(int32 controllerId, FForceFeedbackChannelType channelType, float value) override;
+	void SetChannelValues(int32 controllerId, const FForceFeedbackValues& values) override;
+	IHapticDevice* GetHapticDevice() override { return this; }
 
-	void SetChannelValues(int32 controllerId, const FForceFeedbackValues& values) override
-	{
-	};
+	// IHapticDevice
+	void SetHapticFeedbackValues(int32 controllerId, int32 hand, const FHapticFeedbackValues& values) override;
+	void GetHapticFrequencyRange(float& minFrequency, float& maxFrequency) const override;
+	float GetHapticAmplitudeScale() const override;
 
 	// FXRMotionControllerBase
 	FName GetMotionControllerDeviceTypeName() const override
@@ -94,6 +98,8 @@ public:
 	void RegisterControllerStateHandler(TScriptInterface<IStreamControllerStateHandler> controllerStateHandler);
 	void UnregisterControllerStateHandler(TScriptInterface<IStreamControllerStateHandler> controllerStateHandler);
 
+	uint64 GetSuppressedEventCount() const { return m_suppressedEvents; }
+
 private:
 	enum class ControllerTrackingState
 	{
@@ -113,9 +119,53 @@ private:
 		IsarPose controllerPose;
 		IsarPose pointerPose;
 		IsarHandPose handData;
-		std::vector<IsarButton> buttons;
-		std::vector<IsarAxis1D> axis1D;
-		std::vector<IsarAxis2D> axis2D;
+		// Sized for every kind ISAR knows, so updating a controller never allocates
+		TArray<IsarButton, TInlineAllocator<IsarButtonKind_COUNT>> buttons;
+		TArray<IsarAxis1D, TInlineAllocator<IsarAxis1DKind_COUNT>> axis1D;
+		TArray<IsarAxis2D, TInlineAllocator<IsarAxis2DKind_COUNT>> axis2D;
+	};
+
+	static constexpr int32 FEATURE_KIND_COUNT = IsarXRControllerFeatureKind_DOCKED + 1;
+
+	// Which part of the input value an action receives
+	enum class EnhancedAxisComponent : uint8
+	{
+		Value,
+		X,
+		Y
+	};
+
+	struct StreamEnhancedActionBinding
+	{
+		FEnhancedActionKeyMapping mapping;
+		EnhancedAxisComponent component = EnhancedAxisComponent::Value;
+	};
+
+	// Range of a feature's actions in the controller's binding table
+	struct StreamFeatureDispatch
+	{
+		int32 firstBinding = 0;
+		int32 numBindings = 0;
+	};
+
+	struct StreamEnhancedActionInjection
+	{
+		const StreamEnhancedActionBinding* binding;
+		FInputActionValue value;
+	};
+
+	// Last value sent to legacy input for one feature, or one component of a 2D axis
+	struct StreamLegacyInputState
+	{
+		float value = 0.0f;
+		bool sent = false;
+	};
+
+	// Event that returns a key the message handler holds pressed or off rest, sent when its controller goes away
+	struct StreamLegacyRelease
+	{
+		FName keyName;
+		bool button;
 	};
 
 	struct StreamController
@@ -126,15 +176,35 @@ private:
 		TrackedDeviceType deviceType;
 		StreamControllerUpdateData updateData;
 		ControllerTrackingState state = ControllerTrackingState::Detected;
+		// Whether the slot holds a controller, and when it was detected relative to the others
+		bool inUse = false;
+		uint64 detectionOrder = 0;
 		std::unordered_map<IsarXRControllerFeatureKind, FName> streamToKeyName;
-		std::unordered_map<IsarXRControllerFeatureKind, std::vector<FEnhancedActionKeyMapping>> streamToEnhancedActions;
+		// Compiled by MapEnhancedActions, the actions of every feature are stored back to back in enhancedBindings
+		StreamFeatureDispatch featureDispatch[FEATURE_KIND_COUNT];
+		TArray<StreamEnhancedActionBinding> enhancedBindings;
+		StreamLegacyInputState legacyState[FEATURE_KIND_COUNT][2];
 	};
 
 	IsarConnection m_streamConnection;
 	IsarServerApi* m_serverApi;
 	bool m_connected = false;
 
-	std::vector<StreamController> m_xrControllers;
+	// Slots keep their index while their controller is tracked, removing a controller does not move the others.
+	// Looked up through the device id and the handedness indices, which are rebuilt when a controller comes or goes.
+	static constexpr int32 MAX_CONTROLLERS = 8;
+	static constexpr int32 HANDEDNESS_COUNT = IsarSpatialInteractionSourceHandedness_RIGHT + 1;
+	static constexpr uint32_t DEVICE_ID_COUNT = IsarXRControllerType_COUNT * 2 + HANDEDNESS_COUNT;
+	StreamController m_controllerSlots[MAX_CONTROLLERS];
+	int32 m_deviceIdToSlot[DEVICE_ID_COUNT];
+	// Earliest detected controller of either type per handedness, the one queries by hand or motion source get
+	int32 m_handednessToSlot[HANDEDNESS_COUNT];
+	int32 m_handednessToHandSlot[HANDEDNESS_COUNT];
+	// Earliest detected device of controller type per handedness, the one haptics go to
+	int32 m_handednessToControllerSlot[HANDEDNESS_COUNT];
+	// Tracked hands of any handedness, also those that do not say which hand they are
+	int32 m_handCount = 0;
+	uint64 m_nextDetectionOrder = 0;
 	TMap<FName, std::pair<FName, FName>> m_2DAxisMap;
 	bool m_useEnhancedActions = false;
 
@@ -146,12 +216,40 @@ private:
 
 	TArray<TScriptInterface<IStreamControllerStateHandler>> m_controllerStateHandlers;
 
-	StreamControllerUpdateData CreateUpdateData(const IsarInteractionSourceState& sourceState);
+	// Inputs pulled in Tick, only grows so draining the input queue does not allocate every frame
+	TArray<IsarSpatialInput> m_spatialInputStaging;
+	// Injections gathered from all controllers in SendControllerEvents, handed to the subsystems in one pass
+	TArray<StreamEnhancedActionInjection> m_enhancedInjections;
+	// Legacy events not sent because the value did not change, since the plugin was loaded
+	uint64 m_suppressedEvents = 0;
+
+	// Coalesces force feedback and haptic effects, flushed once per frame in SendControllerEvents
+	FStreamHaptics m_haptics;
+
+	void UpdateControllerData(const IsarInteractionSourceState& sourceState, StreamControllerUpdateData& outData);
 
 	void OnConnectionStateChanged(IsarConnectionState newState);
 	void HandleInputSourceDetected(IsarInteractionSourceState const& sourceState);
 
 	void MapEnhancedActions(StreamController& controller);
+	void QueueEnhancedActions(const StreamController& controller, isar::IsarXRControllerFeatureKind featureKind,
+							  const FInputActionValue& inputValue);
+	void InjectEnhancedActions();
+	bool ShouldSendButton(StreamLegacyInputState& state, bool pressed);
+	bool ShouldSendAnalog(StreamLegacyInputState& state, float value, float deadband);
+	void GatherLegacyReleases(const StreamController& controller, TArray<StreamLegacyRelease>& outReleases) const;
+	static void SendLegacyReleases(FGenericApplicationMessageHandler& messageHandler,
+								   const TArray<StreamLegacyRelease>& releases);
+	void PushHaptic(const IsarHaptic& haptic);
+
+	StreamController* AddController(StreamController&& controller);
+	void RemoveController(StreamController& controller);
+	void RemoveAllControllers();
+	void RebuildHandednessIndex();
+	StreamController* FindControllerByDeviceId(uint32_t deviceId);
+	const StreamController* FindControllerByHandedness(IsarSpatialInteractionSourceHandedness handedness) const;
+	const StreamController* FindHandByHandedness(IsarSpatialInteractionSourceHandedness handedness) const;
+	const StreamController* FindControllerDeviceByHandedness(IsarSpatialInteractionSourceHandedness handedness) const;
 };
 
 #endif // HOLOLIGHT_UNREAL_FSTREAMINPUT_H
\ No newline at end of file
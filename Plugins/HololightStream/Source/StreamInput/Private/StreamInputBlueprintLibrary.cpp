@@ -43,3 +43,13 @@ void UStreamInputBlueprintLibrary::UnregisterControllerStateHandler(
 		streamInput->UnregisterControllerStateHandler(controllerStateHandler);
 	}
 }
+
+int64 UStreamInputBlueprintLibrary::GetSuppressedInputEventCount()
+{
+	if (auto* streamInput = GetStreamInput())
+	{
+		return static_cast<int64>(streamInput->GetSuppressedEventCount());
+	}
+
+	return 0;
+}
@@ -0,0 +1,326 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#include "Misc/AutomationTest.h"
+
+#include "FStreamHaptics.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+// Intervals and frame times of these rates are exact in binary, so the rate limit lands on known frames
+constexpr int32 HAPTIC_RATE = 32;
+constexpr int32 FRAMES_PER_INTERVAL = 4;
+constexpr double INTERVAL = 1.0 / HAPTIC_RATE;
+constexpr double FRAME_TIME = INTERVAL / FRAMES_PER_INTERVAL;
+constexpr uint32_t CONTROLLER_IDENTIFIER = 7;
+
+// A pushed message, with the samples it points to copied, they are only valid during the push
+struct FPushedHaptic
+{
+	int32 frame;
+	isar::IsarHaptic haptic;
+	TArray<float> amplitudes;
+	TArray<uint8> pcmSamples;
+};
+
+/// <summary>
+/// Records the messages FStreamHaptics pushes, along with the frame they were pushed in, and finds a controller in
+/// the hands that hold one.
+/// </summary>
+class FHapticsRecorder
+{
+public:
+	int32 frame = 0;
+	bool leftController = true;
+	bool rightController = true;
+	TArray<FPushedHaptic> pushed;
+
+	FStreamHaptics::FPushFunction GetPushFunction()
+	{
+		return [this](const isar::IsarHaptic& haptic)
+		{
+			FPushedHaptic& message = pushed.AddDefaulted_GetRef();
+			message.frame = frame;
+			message.haptic = haptic;
+			if (haptic.type == isar::IsarHapticType_AMPLITUDE_ENVELOPE_VIBRATION)
+			{
+				const isar::IsarHapticAmplitudeEnvelopeVibration& envelope =
+					haptic.data.hapticAmplitudeEnvelopeVibration;
+				message.amplitudes.Append(envelope.amplitudes, envelope.amplitudeCount);
+			}
+			else if (haptic.type == isar::IsarHapticType_PCM_VIBRATION)
+			{
+				const isar::IsarHapticPcmVibration& pcm = haptic.data.hapticPcmVibration;
+				message.pcmSamples.Append(pcm.buffer, pcm.bufferSize);
+			}
+		};
+	}
+
+	void Flush(FStreamHaptics& haptics)
+	{
+		haptics.Flush(frame * FRAME_TIME, [this](EControllerHand hand, uint32_t& outControllerIdentifier)
+		{
+			outControllerIdentifier = CONTROLLER_IDENTIFIER;
+			return hand == EControllerHand::Left ? leftController : rightController;
+		});
+		frame++;
+	}
+};
+
+// Runs the test at a haptic rate the frame times line up with
+class FScopedHapticMaxRate
+{
+public:
+	FScopedHapticMaxRate()
+		: m_variable(IConsoleManager::Get().FindConsoleVariable(TEXT("vr.StreamHapticMaxRate"))),
+		  m_previous(m_variable ? m_variable->GetInt() : 30)
+	{
+		if (m_variable)
+		{
+			m_variable->Set(HAPTIC_RATE, ECVF_SetByCode);
+		}
+	}
+
+	~FScopedHapticMaxRate()
+	{
+		if (m_variable)
+		{
+			m_variable->Set(m_previous, ECVF_SetByCode);
+		}
+	}
+
+private:
+	IConsoleVariable* m_variable;
+	int32 m_previous;
+};
+
+int64 ToNanoseconds(double seconds)
+{
+	return static_cast<int64>(seconds * 1e9);
+}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamHapticsCoalescingTest,
+								 "HololightStream.Input.Haptics.Coalescing",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamHapticsCoalescingTest::RunTest(const FString& Parameters)
+{
+	FScopedHapticMaxRate hapticMaxRate;
+	FHapticsRecorder recorder;
+	FStreamHaptics haptics(recorder.GetPushFunction());
+
+	// Force feedback and a haptic effect play on the left hand at once, the strongest one wins
+	haptics.SetForceFeedback(FForceFeedbackChannelType::LEFT_LARGE, 0.3f);
+	haptics.SetForceFeedback(FForceFeedbackChannelType::LEFT_SMALL, 0.6f);
+	haptics.SetEffectValues(EControllerHand::Left, 0.1f);
+	haptics.SetEffectValues(EControllerHand::Left, 0.2f);
+	recorder.Flush(haptics);
+
+	if (!TestEqual(TEXT("Values set in one frame are sent as one message"), recorder.pushed.Num(), 1))
+	{
+		return false;
+	}
+	const isar::IsarHaptic& first = recorder.pushed[0].haptic;
+	TestEqual(TEXT("A steady value is sent as a vibration"), first.type, isar::IsarHapticType_VIBRATION);
+	TestEqual(TEXT("The strongest value is sent"), first.data.hapticVibration.amplitude, 0.6f);
+	TestEqual(TEXT("The vibration goes to the left hand"), first.data.hapticVibration.handedness,
+			  isar::IsarSpatialInteractionSourceHandedness_LEFT);
+	TestEqual(TEXT("The vibration goes to the controller in that hand"),
+			  first.data.hapticVibration.controllerIdentifier, CONTROLLER_IDENTIFIER);
+	TestEqual(TEXT("The vibration lasts three intervals"), first.data.hapticVibration.duration,
+			  ToNanoseconds(3.0 * INTERVAL));
+
+	// The value holds for a second
+	while (recorder.frame < HAPTIC_RATE * FRAMES_PER_INTERVAL)
+	{
+		haptics.SetForceFeedback(FForceFeedbackChannelType::LEFT_LARGE, 0.3f);
+		haptics.SetForceFeedback(FForceFeedbackChannelType::LEFT_SMALL, 0.6f);
+		recorder.Flush(haptics);
+	}
+	TestEqual(TEXT("A held value is renewed every two intervals"), recorder.pushed.Num(), HAPTIC_RATE / 2);
+	for (int32 index = 1; index < recorder.pushed.Num(); index++)
+	{
+		const FPushedHaptic& message = recorder.pushed[index];
+		TestEqual(TEXT("Renewals are vibrations"), message.haptic.type, isar::IsarHapticType_VIBRATION);
+		TestEqual(TEXT("Renewals are sent before the last vibration ran out"), message.frame,
+				  recorder.pushed[index - 1].frame + 2 * FRAMES_PER_INTERVAL);
+	}
+
+	// The force feedback stops
+	const int32 stopFrame = recorder.frame;
+	haptics.SetForceFeedback(FForceFeedbackChannelType::LEFT_LARGE, 0.0f);
+	haptics.SetForceFeedback(FForceFeedbackChannelType::LEFT_SMALL, 0.0f);
+	haptics.SetEffectValues(EControllerHand::Left, 0.0f);
+	const int32 pushedBeforeStop = recorder.pushed.Num();
+	for (int32 frame = 0; frame < 2 * FRAMES_PER_INTERVAL; frame++)
+	{
+		recorder.Flush(haptics);
+	}
+	if (TestEqual(TEXT("Stopping sends one message"), recorder.pushed.Num(), pushedBeforeStop + 1))
+	{
+		const FPushedHaptic& stop = recorder.pushed.Last();
+		TestEqual(TEXT("The vibration is stopped"), stop.haptic.type, isar::IsarHapticType_STOP);
+		TestTrue(TEXT("The stop waits for the rate limit only"), stop.frame - stopFrame < FRAMES_PER_INTERVAL);
+	}
+
+	for (const FPushedHaptic& message : recorder.pushed)
+	{
+		TestEqual(TEXT("Nothing is sent to the right hand"), message.haptic.data.hapticStop.handedness,
+				  isar::IsarSpatialInteractionSourceHandedness_LEFT);
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamHapticsEnvelopeTest,
+								 "HololightStream.Input.Haptics.Envelope",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamHapticsEnvelopeTest::RunTest(const FString& Parameters)
+{
+	FScopedHapticMaxRate hapticMaxRate;
+	FHapticsRecorder recorder;
+	FStreamHaptics haptics(recorder.GetPushFunction());
+
+	// A haptic effect ramps up on the right hand over an interval, then holds and stops
+	const float amplitudes[] = {0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f, 0.0f, 0.0f, 0.0f, 0.0f};
+	for (float amplitude : amplitudes)
+	{
+		haptics.SetEffectValues(EControllerHand::Right, amplitude);
+		recorder.Flush(haptics);
+	}
+
+	const isar::IsarHapticType expectedTypes[] = {
+		isar::IsarHapticType_VIBRATION, isar::IsarHapticType_AMPLITUDE_ENVELOPE_VIBRATION,
+		isar::IsarHapticType_VIBRATION, isar::IsarHapticType_STOP
+	};
+	if (!TestEqual(TEXT("One message is sent per interval at most"), recorder.pushed.Num(),
+				   static_cast<int32>(UE_ARRAY_COUNT(expectedTypes))))
+	{
+		return false;
+	}
+	for (int32 index = 0; index < recorder.pushed.Num(); index++)
+	{
+		const FPushedHaptic& message = recorder.pushed[index];
+		TestEqual(FString::Printf(TEXT("Type of message %d"), index), message.haptic.type, expectedTypes[index]);
+		TestEqual(FString::Printf(TEXT("Frame of message %d"), index), message.frame, index * FRAMES_PER_INTERVAL);
+		TestEqual(TEXT("Messages go to the right hand"), message.haptic.data.hapticStop.handedness,
+				  isar::IsarSpatialInteractionSourceHandedness_RIGHT);
+	}
+
+	const FPushedHaptic& envelope = recorder.pushed[1];
+	TestTrue(TEXT("The envelope has the amplitudes of the frames since the last message"),
+			 envelope.amplitudes == TArray<float>({0.2f, 0.3f, 0.4f, 0.5f}));
+	TestEqual(TEXT("The envelope plays back over an interval"),
+			  envelope.haptic.data.hapticAmplitudeEnvelopeVibration.duration, ToNanoseconds(INTERVAL));
+	TestEqual(TEXT("The value the envelope ended on is sent once it holds"),
+			  recorder.pushed[2].haptic.data.hapticVibration.amplitude, 0.5f);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamHapticsPcmTest,
+								 "HololightStream.Input.Haptics.Pcm",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamHapticsPcmTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 SAMPLE_RATE = 8000;
+	constexpr int32 SAMPLE_COUNT = SAMPLE_RATE / 10;
+
+	FScopedHapticMaxRate hapticMaxRate;
+	FHapticsRecorder recorder;
+	FStreamHaptics haptics(recorder.GetPushFunction());
+
+	TArray<uint8> samples;
+	for (int32 sample = 0; sample < SAMPLE_COUNT; sample++)
+	{
+		samples.Add(static_cast<uint8>(sample));
+	}
+	FHapticFeedbackBuffer buffer;
+	buffer.RawData = samples.GetData();
+	buffer.BufferLength = SAMPLE_COUNT;
+	buffer.SamplingRate = SAMPLE_RATE;
+	buffer.ScaleFactor = 1.0f;
+
+	// The engine queues the sound wave every frame until it finished playing
+	const int32 endFrame = FMath::CeilToInt32(static_cast<double>(SAMPLE_COUNT) / SAMPLE_RATE / FRAME_TIME);
+	while (recorder.frame <= endFrame)
+	{
+		haptics.QueuePcm(EControllerHand::Left, buffer, recorder.frame * FRAME_TIME);
+		if (buffer.bFinishedPlaying)
+		{
+			break;
+		}
+		recorder.Flush(haptics);
+	}
+	TestEqual(TEXT("The sound wave finishes once the client played it"), recorder.frame, endFrame);
+
+	TArray<uint8> sentSamples;
+	for (int32 index = 0; index < recorder.pushed.Num(); index++)
+	{
+		const FPushedHaptic& message = recorder.pushed[index];
+		if (!TestEqual(TEXT("A playing sound wave is sent as PCM"), message.haptic.type,
+					   isar::IsarHapticType_PCM_VIBRATION))
+		{
+			return false;
+		}
+		const isar::IsarHapticPcmVibration& pcm = message.haptic.data.hapticPcmVibration;
+		TestEqual(TEXT("Only the first chunk starts a new sound wave"), pcm.append, index > 0);
+		TestEqual(TEXT("The sample rate is sent along"), pcm.sampleRate, static_cast<float>(SAMPLE_RATE));
+		TestEqual(TEXT("Chunks are sent at the haptic rate"), message.frame, index * FRAMES_PER_INTERVAL);
+		sentSamples.Append(message.pcmSamples);
+	}
+	TestTrue(TEXT("Every sample is sent once, in order"), sentSamples == samples);
+	TestEqual(TEXT("The first chunk is two intervals ahead of playback"), recorder.pushed[0].pcmSamples.Num(),
+			  FMath::CeilToInt32(2.0 * INTERVAL * SAMPLE_RATE));
+
+	// The engine stops the finished effect
+	const int32 pushedBeforeStop = recorder.pushed.Num();
+	haptics.SetEffectValues(EControllerHand::Left, 0.0f);
+	recorder.Flush(haptics);
+	if (TestEqual(TEXT("Stopping the effect sends one message"), recorder.pushed.Num(), pushedBeforeStop + 1))
+	{
+		TestEqual(TEXT("The actuator is stopped"), recorder.pushed.Last().haptic.type, isar::IsarHapticType_STOP);
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamHapticsNoControllerTest,
+								 "HololightStream.Input.Haptics.NoController",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamHapticsNoControllerTest::RunTest(const FString& Parameters)
+{
+	FScopedHapticMaxRate hapticMaxRate;
+	FHapticsRecorder recorder;
+	FStreamHaptics haptics(recorder.GetPushFunction());
+
+	// The left hand is tracked without a controller
+	recorder.leftController = false;
+	haptics.SetForceFeedback(FForceFeedbackChannelType::LEFT_LARGE, 0.5f);
+	for (int32 frame = 0; frame < 2 * FRAMES_PER_INTERVAL; frame++)
+	{
+		recorder.Flush(haptics);
+	}
+	TestEqual(TEXT("Nothing is sent to a hand without a controller"), recorder.pushed.Num(), 0);
+
+	// A controller is picked up while the force feedback holds
+	recorder.leftController = true;
+	recorder.Flush(haptics);
+	if (TestEqual(TEXT("The controller vibrates right away"), recorder.pushed.Num(), 1))
+	{
+		TestEqual(TEXT("The held value is sent as a vibration"), recorder.pushed[0].haptic.type,
+				  isar::IsarHapticType_VIBRATION);
+		TestEqual(TEXT("The held value is sent"), recorder.pushed[0].haptic.data.hapticVibration.amplitude, 0.5f);
+	}
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
\ No newline at end of file
@@ -0,0 +1,630 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#include "Misc/AutomationTest.h"
+
+#include "FStreamInput.h"
+
+#include "InputAction.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "HAL/MemoryBase.h"
+#include "HAL/PlatformTLS.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+// Inputs the mock pullSpatialInput returns next. Their controller data arrays are allocated with malloc like those of
+// ISAR, Tick frees them.
+constexpr int32 MAX_QUEUED_INPUTS = 16;
+TArray<isar::IsarSpatialInput> GQueuedInputs;
+isar::IsarConnectionStateChangedCallback GConnectionStateCallback = nullptr;
+void* GConnectionStateUserData = nullptr;
+TArray<isar::IsarHaptic> GPushedHaptics;
+
+void MockRegisterConnectionStateHandler(isar::IsarConnection connection, isar::IsarConnectionStateChangedCallback cb,
+										void* userData)
+{
+	GConnectionStateCallback = cb;
+	GConnectionStateUserData = userData;
+}
+
+isar::IsarError MockPullSpatialInput(isar::IsarConnection connection, isar::IsarSpatialInput* spatialInput,
+									 uint32_t inputCount, uint32_t* outputCount)
+{
+	if (!spatialInput)
+	{
+		*outputCount = GQueuedInputs.Num();
+		return isar::IsarError::eNone;
+	}
+
+	const int32 count = FMath::Min(static_cast<int32>(inputCount), GQueuedInputs.Num());
+	FMemory::Memcpy(spatialInput, GQueuedInputs.GetData(), count * sizeof(isar::IsarSpatialInput));
+#if ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION > 3
+	GQueuedInputs.RemoveAt(0, count, EAllowShrinking::No);
+#else
+	GQueuedInputs.RemoveAt(0, count, false);
+#endif
+	if (outputCount)
+	{
+		*outputCount = count;
+	}
+	return isar::IsarError::eNone;
+}
+
+isar::IsarError MockPushHaptic(isar::IsarConnection connection, isar::IsarHaptic const* haptic)
+{
+	GPushedHaptics.Add(*haptic);
+	return isar::IsarError::eNone;
+}
+
+isar::IsarServerApi MakeMockServerApi()
+{
+	GQueuedInputs.Reset();
+	GQueuedInputs.Reserve(MAX_QUEUED_INPUTS);
+	GConnectionStateCallback = nullptr;
+	GConnectionStateUserData = nullptr;
+	GPushedHaptics.Reset();
+	isar::IsarServerApi serverApi = {};
+	serverApi.registerConnectionStateHandler = &MockRegisterConnectionStateHandler;
+	serverApi.pullSpatialInput = &MockPullSpatialInput;
+	serverApi.pushHaptic = &MockPushHaptic;
+	return serverApi;
+}
+
+// The server API has to outlive the input
+void Connect(FStreamInput& input, isar::IsarServerApi& serverApi)
+{
+	input.SetStreamApi(nullptr, &serverApi);
+	GConnectionStateCallback(isar::IsarConnectionState_CONNECTED, GConnectionStateUserData);
+}
+
+// What a Quest 3 controller reports in one input, X or A, the trigger and the thumbstick of its hand
+struct FControllerSample
+{
+	bool buttonPressed = false;
+	float trigger = 0.0f;
+	float stickX = 0.0f;
+	float stickY = 0.0f;
+};
+
+isar::IsarSpatialInput MakeSourceInput(isar::IsarInputType type, isar::IsarXRControllerType controllerType,
+									   isar::IsarSpatialInteractionSourceHandedness handedness)
+{
+	isar::IsarSpatialInput input = {};
+	input.type = type;
+	isar::IsarControllerData& data = input.data.sourceUpdated.interactionSourceState.controllerData;
+	data.controllerIdentifier = controllerType;
+	data.handedness = handedness;
+	data.controllerPose.orientation.w = 1.0f;
+	data.pointerPose.orientation.w = 1.0f;
+	for (isar::IsarJointPose& joint : data.handData.jointPoses)
+	{
+		joint.orientation.w = 1.0f;
+	}
+	return input;
+}
+
+void QueueControllerInput(isar::IsarInputType type, isar::IsarSpatialInteractionSourceHandedness handedness,
+						  const FControllerSample& sample)
+{
+	const bool left = handedness == isar::IsarSpatialInteractionSourceHandedness_LEFT;
+	isar::IsarSpatialInput input = MakeSourceInput(type, isar::IsarXRControllerType_Meta_Quest_3_Controller,
+												   handedness);
+	isar::IsarControllerData& data = input.data.sourceUpdated.interactionSourceState.controllerData;
+	data.buttons = static_cast<isar::IsarButton*>(malloc(sizeof(isar::IsarButton)));
+	data.buttons[0] = {
+		static_cast<uint32_t>(left ? isar::IsarButtonKind_X : isar::IsarButtonKind_A), sample.buttonPressed
+	};
+	data.buttonsLength = 1;
+	data.axis1D = static_cast<isar::IsarAxis1D*>(malloc(sizeof(isar::IsarAxis1D)));
+	data.axis1D[0] = {
+		static_cast<uint32_t>(left ? isar::IsarAxis1DKind_PRIMARY_TRIGGER : isar::IsarAxis1DKind_SECONARDY_TRIGGER),
+		sample.trigger
+	};
+	data.axis1DLength = 1;
+	data.axis2D = static_cast<isar::IsarAxis2D*>(malloc(sizeof(isar::IsarAxis2D)));
+	data.axis2D[0] = {
+		static_cast<uint32_t>(left ? isar::IsarAxis2DKind_PRIMARY_STICK : isar::IsarAxis2DKind_SECONDARY_STICK),
+		{sample.stickX, sample.stickY}
+	};
+	data.axis2DLength = 1;
+	GQueuedInputs.Add(input);
+}
+
+// Tracked hands report their joints only
+void QueueHandInput(isar::IsarInputType type, isar::IsarSpatialInteractionSourceHandedness handedness)
+{
+	GQueuedInputs.Add(MakeSourceInput(type, isar::IsarXRControllerType_Meta_Quest_Hands, handedness));
+}
+
+// Records the legacy input events, prefixed with the frame they were sent in
+class FRecordingMessageHandler : public FGenericApplicationMessageHandler
+{
+public:
+	int32 frame = 0;
+	TArray<FString> events;
+
+	bool OnControllerButtonPressed(FName keyName, FPlatformUserId platformUserId, FInputDeviceId inputDeviceId,
+								   bool isRepeat) override
+	{
+		events.Add(FString::Printf(TEXT("%d Pressed %s"), frame, *keyName.ToString()));
+		return true;
+	}
+
+	bool OnControllerButtonReleased(FName keyName, FPlatformUserId platformUserId, FInputDeviceId inputDeviceId,
+									bool isRepeat) override
+	{
+		events.Add(FString::Printf(TEXT("%d Released %s"), frame, *keyName.ToString()));
+		return true;
+	}
+
+	bool OnControllerAnalog(FName keyName, FPlatformUserId platformUserId, FInputDeviceId inputDeviceId,
+							float analogValue) override
+	{
+		events.Add(FString::Printf(TEXT("%d Analog %s %.2f"), frame, *keyName.ToString(), analogValue));
+		return true;
+	}
+};
+
+/// <summary>
+/// Installed as GMalloc, forwards everything to the allocator it replaced and counts the allocations of the thread
+/// that installed it. The other threads keep allocating through it meanwhile, so it stays alive after it was removed.
+/// </summary>
+class FThreadAllocationCounter : public FMalloc
+{
+public:
+	void Install()
+	{
+		m_threadId = FPlatformTLS::GetCurrentThreadId();
+		m_allocations = 0;
+		m_inner = GMalloc;
+		GMalloc = this;
+	}
+
+	void Uninstall()
+	{
+		GMalloc = m_inner;
+	}
+
+	// Only read by the thread that installed it
+	uint64 GetAllocations() const { return m_allocations; }
+
+	void* Malloc(SIZE_T count, uint32 alignment) override
+	{
+		Count();
+		return m_inner->Malloc(count, alignment);
+	}
+
+	void* TryMalloc(SIZE_T count, uint32 alignment) override
+	{
+		Count();
+		return m_inner->TryMalloc(count, alignment);
+	}
+
+	void* Realloc(void* original, SIZE_T count, uint32 alignment) override
+	{
+		Count();
+		return m_inner->Realloc(original, count, alignment);
+	}
+
+	void* TryRealloc(void* original, SIZE_T count, uint32 alignment) override
+	{
+		Count();
+		return m_inner->TryRealloc(original, count, alignment);
+	}
+
+	void Free(void* original) override { m_inner->Free(original); }
+	SIZE_T QuantizeSize(SIZE_T count, uint32 alignment) override { return m_inner->QuantizeSize(count, alignment); }
+	bool GetAllocationSize(void* original, SIZE_T& sizeOut) override
+	{
+		return m_inner->GetAllocationSize(original, sizeOut);
+	}
+	void Trim(bool trimThreadCaches) override { m_inner->Trim(trimThreadCaches); }
+	void SetupTLSCachesOnCurrentThread() override { m_inner->SetupTLSCachesOnCurrentThread(); }
+	void MarkTLSCachesAsUsedOnCurrentThread() override { m_inner->MarkTLSCachesAsUsedOnCurrentThread(); }
+	void MarkTLSCachesAsUnusedOnCurrentThread() override { m_inner->MarkTLSCachesAsUnusedOnCurrentThread(); }
+	void ClearAndDisableTLSCachesOnCurrentThread() override { m_inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+	bool IsInternallyThreadSafe() const override { return m_inner->IsInternallyThreadSafe(); }
+	bool ValidateHeap() override { return m_inner->ValidateHeap(); }
+	const TCHAR* GetDescriptiveName() override { return m_inner->GetDescriptiveName(); }
+
+private:
+	FMalloc* m_inner = nullptr;
+	uint32 m_threadId = 0;
+	uint64 m_allocations = 0;
+
+	void Count()
+	{
+		if (FPlatformTLS::GetCurrentThreadId() == m_threadId)
+		{
+			m_allocations++;
+		}
+	}
+};
+
+FThreadAllocationCounter GAllocationCounter;
+
+// Ticks the input like the engine does once per frame, returns the allocations of the game thread
+uint64 TickCounted(FStreamInput& input)
+{
+	GAllocationCounter.Install();
+	input.Tick(1.0f / 90.0f);
+	input.SendControllerEvents();
+	GAllocationCounter.Uninstall();
+	return GAllocationCounter.GetAllocations();
+}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamInputTickAllocationTest,
+								 "HololightStream.Input.Tick.NoAllocation",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamInputTickAllocationTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 MAX_INPUTS_PER_HAND = 4;
+	constexpr int32 FRAME_COUNT = 900;
+	isar::IsarServerApi serverApi = MakeMockServerApi();
+	FStreamInput input;
+	Connect(input, serverApi);
+
+	QueueControllerInput(isar::IsarInputType_SOURCE_DETECTED, isar::IsarSpatialInteractionSourceHandedness_LEFT, {});
+	QueueControllerInput(isar::IsarInputType_SOURCE_DETECTED, isar::IsarSpatialInteractionSourceHandedness_RIGHT, {});
+	TestTrue(TEXT("Detecting the controllers allocates their key maps"), TickCounted(input) > 0);
+
+	// The staging buffer grows to the most inputs a frame brings
+	for (int32 index = 0; index < MAX_INPUTS_PER_HAND; index++)
+	{
+		QueueControllerInput(isar::IsarInputType_SOURCE_UPDATED, isar::IsarSpatialInteractionSourceHandedness_LEFT, {});
+		QueueControllerInput(isar::IsarInputType_SOURCE_UPDATED, isar::IsarSpatialInteractionSourceHandedness_RIGHT,
+							 {});
+	}
+	TickCounted(input);
+
+	// Input arrives unevenly, none in some frames, several in others, and every value changes so events are sent
+	FRandomStream random(7);
+	uint64 allocations = 0;
+	for (int32 frame = 0; frame < FRAME_COUNT; frame++)
+	{
+		const float phase = frame * 0.05f;
+		const FControllerSample sample = {
+			(frame / 10) % 2 == 1, 0.5f + 0.5f * FMath::Sin(phase), FMath::Cos(phase), FMath::Sin(phase)
+		};
+		for (int32 index = random.RandRange(0, MAX_INPUTS_PER_HAND); index > 0; index--)
+		{
+			QueueControllerInput(isar::IsarInputType_SOURCE_UPDATED, isar::IsarSpatialInteractionSourceHandedness_LEFT,
+								 sample);
+		}
+		for (int32 index = random.RandRange(0, MAX_INPUTS_PER_HAND); index > 0; index--)
+		{
+			QueueControllerInput(isar::IsarInputType_SOURCE_UPDATED, isar::IsarSpatialInteractionSourceHandedness_RIGHT,
+								 sample);
+		}
+		allocations += TickCounted(input);
+	}
+
+	AddInfo(FString::Printf(TEXT("%llu allocations in %d frames"), allocations, FRAME_COUNT));
+	TestEqual(TEXT("Input frames do not allocate once the buffers have grown"), allocations, uint64(0));
+	TestEqual(TEXT("Every queued input was pulled"), GQueuedInputs.Num(), 0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamInputHandTrackingStateTest,
+								 "HololightStream.Input.Queries.HandTrackingState",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamInputHandTrackingStateTest::RunTest(const FString& Parameters)
+{
+	isar::IsarServerApi serverApi = MakeMockServerApi();
+	FStreamInput input;
+	Connect(input, serverApi);
+	TestFalse(TEXT("Nothing is tracked before a device was detected"), input.IsHandTrackingStateValid());
+
+	QueueControllerInput(isar::IsarInputType_SOURCE_DETECTED, isar::IsarSpatialInteractionSourceHandedness_LEFT, {});
+	input.Tick(0.0f);
+	TestFalse(TEXT("Controllers are not tracked hands"), input.IsHandTrackingStateValid());
+
+	// Some clients do not say which hand they track
+	QueueHandInput(isar::IsarInputType_SOURCE_DETECTED, isar::IsarSpatialInteractionSourceHandedness_UNSPECIFIED);
+	input.Tick(0.0f);
+	TestTrue(TEXT("A hand of unspecified handedness is tracked"), input.IsHandTrackingStateValid());
+	QueueHandInput(isar::IsarInputType_SOURCE_LOST, isar::IsarSpatialInteractionSourceHandedness_UNSPECIFIED);
+	input.Tick(0.0f);
+	TestFalse(TEXT("The lost hand is not tracked anymore"), input.IsHandTrackingStateValid());
+
+	QueueHandInput(isar::IsarInputType_SOURCE_DETECTED, isar::IsarSpatialInteractionSourceHandedness_RIGHT);
+	QueueHandInput(isar::IsarInputType_SOURCE_UPDATED, isar::IsarSpatialInteractionSourceHandedness_RIGHT);
+	input.Tick(0.0f);
+	TestTrue(TEXT("A right hand is tracked"), input.IsHandTrackingStateValid());
+	FTransform transform;
+	float radius = 0.0f;
+	TestTrue(TEXT("The right hand has keypoints"),
+			 input.GetKeypointState(EControllerHand::Right, EHandKeypoint::Palm, transform, radius));
+	TestFalse(TEXT("The left controller has no keypoints"),
+			  input.GetKeypointState(EControllerHand::Left, EHandKeypoint::Palm, transform, radius));
+
+	GConnectionStateCallback(isar::IsarConnectionState_DISCONNECTED, GConnectionStateUserData);
+	TestFalse(TEXT("Nothing is tracked after the connection dropped"), input.IsHandTrackingStateValid());
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamInputQueryBenchmark,
+								 "HololightStream.Input.Queries.Benchmark",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::PerfFilter)
+
+bool FStreamInputQueryBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int32 FRAME_COUNT = 1000;
+	constexpr int32 COMPONENT_COUNTS[] = {1, 16, 64, 256};
+	isar::IsarServerApi serverApi = MakeMockServerApi();
+	FStreamInput input;
+	Connect(input, serverApi);
+
+	// Both controllers and both hands, with the controllers detected first, as when a user puts them down
+	for (isar::IsarInputType type : {isar::IsarInputType_SOURCE_DETECTED, isar::IsarInputType_SOURCE_UPDATED})
+	{
+		QueueControllerInput(type, isar::IsarSpatialInteractionSourceHandedness_LEFT, {});
+		QueueControllerInput(type, isar::IsarSpatialInteractionSourceHandedness_RIGHT, {});
+		QueueHandInput(type, isar::IsarSpatialInteractionSourceHandedness_LEFT);
+		QueueHandInput(type, isar::IsarSpatialInteractionSourceHandedness_RIGHT);
+	}
+	input.Tick(0.0f);
+
+	TArray<FMotionControllerSource> sources;
+	input.EnumerateSources(sources);
+	TArray<FVector> positions;
+	TArray<FQuat> rotations;
+	TArray<float> radii;
+	int32 trackedQueries = 0;
+	for (const int32 componentCount : COMPONENT_COUNTS)
+	{
+		// Every motion controller component asks for the status and the pose of its source once per frame, the hand
+		// tracking visualization reads all keypoints of both hands
+		trackedQueries = 0;
+		const double startTime = FPlatformTime::Seconds();
+		for (int32 frame = 0; frame < FRAME_COUNT; frame++)
+		{
+			for (int32 component = 0; component < componentCount; component++)
+			{
+				const FName source = sources[component % sources.Num()].SourceName;
+				FRotator orientation;
+				FVector position;
+				trackedQueries += input.GetControllerTrackingStatus(0, source) == ETrackingStatus::Tracked &&
+					input.GetControllerOrientationAndPosition(0, source, orientation, position, 100.0f);
+			}
+			if (input.IsHandTrackingStateValid())
+			{
+				input.GetAllKeypointStates(EControllerHand::Left, positions, rotations, radii);
+				input.GetAllKeypointStates(EControllerHand::Right, positions, rotations, radii);
+			}
+		}
+		const double elapsed = FPlatformTime::Seconds() - startTime;
+		AddInfo(FString::Printf(TEXT("%d components: %.2f us per frame"), componentCount,
+								elapsed * 1e6 / FRAME_COUNT));
+	}
+
+	const int32 lastComponentCount = COMPONENT_COUNTS[UE_ARRAY_COUNT(COMPONENT_COUNTS) - 1];
+	TestEqual(TEXT("Every source is tracked"), trackedQueries, lastComponentCount * FRAME_COUNT);
+	TestEqual(TEXT("All keypoints are read"), positions.Num(), EHandKeypointCount);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamInputEnhancedDispatchBenchmark,
+								 "HololightStream.Input.EnhancedDispatch.Benchmark",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::PerfFilter)
+
+bool FStreamInputEnhancedDispatchBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int32 FRAME_COUNT = 1000;
+	constexpr int32 MAPPING_COUNTS[] = {16, 64, 256, 1024};
+	// Every eighth mapping binds a key of the Quest 3 controllers, the others keys of devices Stream does not have
+	constexpr int32 STREAM_KEY_INTERVAL = 8;
+	struct FStreamKeyMapping
+	{
+		FKey key;
+		EInputActionValueType valueType;
+	};
+	const FStreamKeyMapping streamKeys[] = {
+		{EKeys::OculusTouch_Left_X_Click, EInputActionValueType::Boolean},
+		{EKeys::OculusTouch_Left_Trigger_Axis, EInputActionValueType::Axis1D},
+		{EKeys::OculusTouch_Left_Thumbstick_2D, EInputActionValueType::Axis2D},
+		{EKeys::OculusTouch_Left_Thumbstick_X, EInputActionValueType::Axis1D},
+		{EKeys::OculusTouch_Right_A_Click, EInputActionValueType::Boolean},
+		{EKeys::OculusTouch_Right_Trigger_Axis, EInputActionValueType::Axis1D},
+		{EKeys::OculusTouch_Right_Thumbstick_2D, EInputActionValueType::Axis2D},
+		{EKeys::OculusTouch_Right_Thumbstick_Y, EInputActionValueType::Axis1D}
+	};
+
+	for (const int32 mappingCount : MAPPING_COUNTS)
+	{
+		UInputMappingContext* mappingContext = NewObject<UInputMappingContext>();
+		for (int32 index = 0; index < mappingCount; index++)
+		{
+			UInputAction* action = NewObject<UInputAction>();
+			if (index % STREAM_KEY_INTERVAL == 0)
+			{
+				const int32 streamKeyIndex = (index / STREAM_KEY_INTERVAL) % UE_ARRAY_COUNT(streamKeys);
+				const FStreamKeyMapping& streamKey = streamKeys[streamKeyIndex];
+				action->ValueType = streamKey.valueType;
+				mappingContext->MapKey(action, streamKey.key);
+			}
+			else
+			{
+				mappingContext->MapKey(action, FKey(*FString::Printf(TEXT("StreamBenchmark_Key%d"), index)));
+			}
+		}
+		TSet<TObjectPtr<UInputMappingContext>> mappingContexts;
+		mappingContexts.Add(mappingContext);
+
+		isar::IsarServerApi serverApi = MakeMockServerApi();
+		FStreamInput input;
+		Connect(input, serverApi);
+		input.AttachInputMappingContexts(mappingContexts);
+
+		// Detecting the controllers compiles their dispatch tables
+		const FControllerSample sample = {true, 0.5f, 0.5f, -0.5f};
+		for (isar::IsarInputType type : {isar::IsarInputType_SOURCE_DETECTED, isar::IsarInputType_SOURCE_UPDATED})
+		{
+			QueueControllerInput(type, isar::IsarSpatialInteractionSourceHandedness_LEFT, sample);
+			QueueControllerInput(type, isar::IsarSpatialInteractionSourceHandedness_RIGHT, sample);
+		}
+		const double compileStartTime = FPlatformTime::Seconds();
+		input.Tick(0.0f);
+		const double compileTime = FPlatformTime::Seconds() - compileStartTime;
+
+		const double startTime = FPlatformTime::Seconds();
+		for (int32 frame = 0; frame < FRAME_COUNT; frame++)
+		{
+			input.SendControllerEvents();
+		}
+		const double elapsed = FPlatformTime::Seconds() - startTime;
+		AddInfo(FString::Printf(TEXT("%d mappings: %.1f us to compile the tables, %.2f us per frame"), mappingCount,
+								compileTime * 1e6, elapsed * 1e6 / FRAME_COUNT));
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamInputLegacyReplayTest,
+								 "HololightStream.Input.LegacyEvents.Replay",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamInputLegacyReplayTest::RunTest(const FString& Parameters)
+{
+	constexpr isar::IsarSpatialInteractionSourceHandedness LEFT = isar::IsarSpatialInteractionSourceHandedness_LEFT;
+	constexpr isar::IsarSpatialInteractionSourceHandedness RIGHT = isar::IsarSpatialInteractionSourceHandedness_RIGHT;
+	struct FRecordedInput
+	{
+		int32 frame;
+		isar::IsarInputType type;
+		isar::IsarSpatialInteractionSourceHandedness handedness;
+		FControllerSample sample;
+	};
+
+	// The left controller is picked up, X pressed, the trigger pulled through and the stick moved, then the controller
+	// is lost while X is held. The right one is picked up with A pressed before the connection drops.
+	const FRecordedInput recording[] = {
+		{0, isar::IsarInputType_SOURCE_DETECTED, LEFT, {}},
+		{1, isar::IsarInputType_SOURCE_UPDATED, LEFT, {}},
+		{2, isar::IsarInputType_SOURCE_UPDATED, LEFT, {}},
+		// The trigger moves less than the deadband
+		{3, isar::IsarInputType_SOURCE_PRESSED, LEFT, {true, 0.005f, 0.0f, 0.0f}},
+		{4, isar::IsarInputType_SOURCE_UPDATED, LEFT, {true, 0.5f, 0.3f, 0.0f}},
+		{5, isar::IsarInputType_SOURCE_UPDATED, LEFT, {true, 0.95f, 0.3f, 0.0f}},
+		// Nothing arrives in frame 6
+		{7, isar::IsarInputType_SOURCE_RELEASED, LEFT, {false, 0.0f, 0.0f, 0.0f}},
+		{8, isar::IsarInputType_SOURCE_PRESSED, LEFT, {true, 0.6f, 0.0f, -0.7f}},
+		{9, isar::IsarInputType_SOURCE_LOST, LEFT, {}},
+		{10, isar::IsarInputType_SOURCE_DETECTED, RIGHT, {}},
+		{11, isar::IsarInputType_SOURCE_PRESSED, RIGHT, {true, 0.0f, 0.0f, 0.0f}}
+	};
+	constexpr int32 FRAME_COUNT = 12;
+	const TCHAR* expectedEvents[] = {
+		TEXT("1 Released OculusTouch_Left_X_Click"),
+		TEXT("1 Released OculusTouch_Left_Trigger_Click"),
+		TEXT("1 Analog OculusTouch_Left_Trigger_Axis 0.00"),
+		TEXT("1 Analog OculusTouch_Left_Thumbstick_X 0.00"),
+		TEXT("1 Analog OculusTouch_Left_Thumbstick_Y 0.00"),
+		TEXT("3 Pressed OculusTouch_Left_X_Click"),
+		TEXT("4 Analog OculusTouch_Left_Trigger_Axis 0.50"),
+		TEXT("4 Analog OculusTouch_Left_Thumbstick_X 0.30"),
+		TEXT("5 Pressed OculusTouch_Left_Trigger_Click"),
+		TEXT("5 Analog OculusTouch_Left_Trigger_Axis 0.95"),
+		TEXT("7 Released OculusTouch_Left_X_Click"),
+		TEXT("7 Released OculusTouch_Left_Trigger_Click"),
+		TEXT("7 Analog OculusTouch_Left_Trigger_Axis 0.00"),
+		TEXT("7 Analog OculusTouch_Left_Thumbstick_X 0.00"),
+		TEXT("8 Pressed OculusTouch_Left_X_Click"),
+		TEXT("8 Analog OculusTouch_Left_Trigger_Axis 0.60"),
+		TEXT("8 Analog OculusTouch_Left_Thumbstick_Y -0.70"),
+		// Keys of a lost controller go back to rest
+		TEXT("9 Released OculusTouch_Left_X_Click"),
+		TEXT("9 Analog OculusTouch_Left_Trigger_Axis 0.00"),
+		TEXT("9 Analog OculusTouch_Left_Thumbstick_Y 0.00"),
+		TEXT("11 Pressed OculusTouch_Right_A_Click"),
+		TEXT("11 Released OculusTouch_Right_Trigger_Click"),
+		TEXT("11 Analog OculusTouch_Right_Trigger_Axis 0.00"),
+		TEXT("11 Analog OculusTouch_Right_Thumbstick_X 0.00"),
+		TEXT("11 Analog OculusTouch_Right_Thumbstick_Y 0.00"),
+		// So do those of a dropped connection
+		TEXT("12 Released OculusTouch_Right_A_Click")
+	};
+	// Values sent in an earlier frame that did not change, the trigger within the deadband included
+	constexpr uint64 SUPPRESSED_EVENTS = 23;
+
+	isar::IsarServerApi serverApi = MakeMockServerApi();
+	FStreamInput input;
+	const TSharedRef<FRecordingMessageHandler> messageHandler = MakeShared<FRecordingMessageHandler>();
+	input.SetMessageHandler(messageHandler);
+	Connect(input, serverApi);
+
+	int32 nextInput = 0;
+	for (int32 frame = 0; frame < FRAME_COUNT; frame++)
+	{
+		messageHandler->frame = frame;
+		for (; nextInput < UE_ARRAY_COUNT(recording) && recording[nextInput].frame == frame; nextInput++)
+		{
+			const FRecordedInput& recorded = recording[nextInput];
+			QueueControllerInput(recorded.type, recorded.handedness, recorded.sample);
+		}
+		input.Tick(1.0f / 90.0f);
+		input.SendControllerEvents();
+	}
+
+	// The connection callback hands the releases to the game thread
+	messageHandler->frame = FRAME_COUNT;
+	GConnectionStateCallback(isar::IsarConnectionState_DISCONNECTED, GConnectionStateUserData);
+	FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+
+	const TArray<FString>& events = messageHandler->events;
+	TestEqual(TEXT("Only changes are sent"), events.Num(), static_cast<int32>(UE_ARRAY_COUNT(expectedEvents)));
+	for (int32 index = 0; index < FMath::Min(events.Num(), static_cast<int32>(UE_ARRAY_COUNT(expectedEvents))); index++)
+	{
+		TestEqual(FString::Printf(TEXT("Event %d"), index), events[index], FString(expectedEvents[index]));
+	}
+	TestEqual(TEXT("Unchanged values are counted as suppressed"), input.GetSuppressedEventCount(), SUPPRESSED_EVENTS);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamInputHapticsControllerTest,
+								 "HololightStream.Input.Haptics.ControllerInTrackedHand",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamInputHapticsControllerTest::RunTest(const FString& Parameters)
+{
+	isar::IsarServerApi serverApi = MakeMockServerApi();
+	FStreamInput input;
+	Connect(input, serverApi);
+
+	// Both hands are tracked before a controller is picked up with the left one
+	QueueHandInput(isar::IsarInputType_SOURCE_DETECTED, isar::IsarSpatialInteractionSourceHandedness_LEFT);
+	QueueHandInput(isar::IsarInputType_SOURCE_DETECTED, isar::IsarSpatialInteractionSourceHandedness_RIGHT);
+	input.Tick(1.0f / 90.0f);
+	QueueControllerInput(isar::IsarInputType_SOURCE_DETECTED, isar::IsarSpatialInteractionSourceHandedness_LEFT, {});
+	input.Tick(1.0f / 90.0f);
+
+	input.SetChannelValue(0, FForceFeedbackChannelType::LEFT_LARGE, 0.5f);
+	input.SetChannelValue(0, FForceFeedbackChannelType::RIGHT_LARGE, 0.5f);
+	input.SendControllerEvents();
+
+	if (!TestEqual(TEXT("Only the hand holding a controller vibrates"), GPushedHaptics.Num(), 1))
+	{
+		return false;
+	}
+	const isar::IsarHaptic& haptic = GPushedHaptics[0];
+	TestEqual(TEXT("The force feedback is sent as a vibration"), haptic.type, isar::IsarHapticType_VIBRATION);
+	TestEqual(TEXT("The vibration goes to the left hand"), haptic.data.hapticVibration.handedness,
+			  isar::IsarSpatialInteractionSourceHandedness_LEFT);
+	TestEqual(TEXT("The vibration goes to the controller, not the tracked hand detected before it"),
+			  haptic.data.hapticVibration.controllerIdentifier,
+			  static_cast<uint32_t>(isar::IsarXRControllerType_Meta_Quest_3_Controller));
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
\ No newline at end of file
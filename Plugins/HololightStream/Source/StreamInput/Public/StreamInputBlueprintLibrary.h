@@ -22,4 +22,8 @@ public:
 
 	UFUNCTION(BlueprintCallable, Category = "Hololight Stream|Input")
 	static void UnregisterControllerStateHandler(TScriptInterface<IStreamControllerStateHandler> ControllerStateHandler);
+
+	// Legacy input events not sent because the value did not change, since the plugin was loaded
+	UFUNCTION(BlueprintCallable, Category = "Hololight Stream|Input")
+	static int64 GetSuppressedInputEventCount();
 };
\ No newline at end of file
@@ -0,0 +1,92 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#include "FStreamMicrophoneArrivalClock.h"
+
+FStreamMicrophoneArrivalClock::FStreamMicrophoneArrivalClock() : m_reset(true),
+																 m_clockBase(0.0),
+																 m_clockFrames(0),
+																 m_clockSampleRate(0),
+																 m_arrivalOrigin(0.0),
+																 m_minArrivalLag(0.0),
+																 m_jitterEstimate(0.0),
+																 m_gapSuspected(false),
+																 m_suspectedLag(0.0),
+																 m_suspectedAt(0.0)
+{
+}
+
+void FStreamMicrophoneArrivalClock::Reset()
+{
+	m_reset = true;
+}
+
+double FStreamMicrophoneArrivalClock::Update(uint32 numFrames, int32 sampleRate, double now)
+{
+	if (m_clockSampleRate != sampleRate)
+	{
+		// Fold the frames counted at the old rate into the base, so the timeline stays continuous
+		m_clockBase = GetReceivedSeconds();
+		m_clockFrames = 0;
+		m_clockSampleRate = sampleRate;
+	}
+
+	// The client sends a packet once its last frame was recorded. Measured against its first frame, a larger packet
+	// would look late by the extra audio it carries.
+	const double packetSeconds = double(numFrames) / sampleRate;
+	const double receivedTime = GetReceivedSeconds() + packetSeconds;
+	double gap = 0.0;
+	if (m_reset)
+	{
+		m_reset = false;
+		m_arrivalOrigin = now - receivedTime;
+		m_minArrivalLag = 0.0;
+		m_jitterEstimate = 0.0;
+		m_gapSuspected = false;
+	}
+	else
+	{
+		// How far the arrival of this packet is behind the audio received so far. Its floor is the network delay,
+		// anything well above it means packets are late or never arrived.
+		const double lag = (now - m_arrivalOrigin) - receivedTime;
+		m_minArrivalLag = FMath::Min(lag, m_minArrivalLag + ARRIVAL_LAG_DECAY_PER_SECOND * packetSeconds);
+
+		const double delay = lag - m_minArrivalLag;
+		if (delay <= GAP_THRESHOLD_SECONDS)
+		{
+			// Either no gap or the late audio caught up with the timeline
+			m_gapSuspected = false;
+			// Peak follower of the arrival delay, the jitter buffer has to cover the worst recent case
+			m_jitterEstimate = FMath::Max(delay, m_jitterEstimate - JITTER_DECAY_PER_SECOND * packetSeconds);
+		}
+		else if (!m_gapSuspected)
+		{
+			m_gapSuspected = true;
+			m_suspectedLag = lag;
+			m_suspectedAt = receivedTime;
+		}
+		else
+		{
+			// Late audio arrives faster than the client records it until it has caught up, audio after lost
+			// packets keeps the client pace and the lag stays where it was
+			const double receivedSinceGap = receivedTime - m_suspectedAt;
+			if (receivedSinceGap >= GAP_CONFIRM_SECONDS &&
+				m_suspectedLag - lag < GAP_CATCH_UP_RATIO * receivedSinceGap)
+			{
+				// Skip the timeline over the missing audio so it keeps pace with the client
+				gap = delay;
+				m_clockBase += gap;
+				m_gapSuspected = false;
+			}
+		}
+	}
+
+	m_clockFrames += numFrames;
+	return gap;
+}
+
+double FStreamMicrophoneArrivalClock::GetReceivedSeconds() const
+{
+	return m_clockSampleRate > 0 ? m_clockBase + double(m_clockFrames) / m_clockSampleRate : m_clockBase;
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#ifndef HOLOLIGHT_UNREAL_FSTREAMMICROPHONEARRIVALCLOCK_H
+#define HOLOLIGHT_UNREAL_FSTREAMMICROPHONEARRIVALCLOCK_H
+
+#include "CoreMinimal.h"
+
+/// <summary>
+/// Tracks when microphone packets arrive against the audio received so far. The lowest lag between the two is the
+/// network delay, lag above it is arrival jitter the jitter buffer has to cover.
+/// A packet far behind the timeline is either late or follows audio that never arrived. The packets carry no sequence
+/// number, so the gap is only confirmed once the packets after it keep arriving at the client pace without catching
+/// up. Late audio that arrives in a burst instead brings the lag back down and the timeline is left untouched.
+/// All times are passed in, in seconds, so recorded arrivals can be replayed.
+/// </summary>
+class FStreamMicrophoneArrivalClock
+{
+public:
+	FStreamMicrophoneArrivalClock();
+
+	// The next packet starts a new timeline
+	void Reset();
+	// Returns the duration of audio confirmed missing before this packet, the timeline is advanced by it
+	double Update(uint32 numFrames, int32 sampleRate, double now);
+
+	// Peak arrival delay above the network delay, excluding gaps
+	double GetJitterEstimate() const { return m_jitterEstimate; }
+	// Duration of the audio received plus the gaps skipped over
+	double GetReceivedSeconds() const;
+	bool IsGapSuspected() const { return m_gapSuspected; }
+
+private:
+	// Packets arriving this much later than the audio received so far accounts for are late or follow lost audio
+	static constexpr double GAP_THRESHOLD_SECONDS = 0.1;
+	// Audio received after a suspected gap before it is confirmed
+	static constexpr double GAP_CONFIRM_SECONDS = 0.05;
+	// Late audio arriving in a burst makes up at least this much of the audio received after it in lag
+	static constexpr double GAP_CATCH_UP_RATIO = 0.5;
+	// Lets the network delay floor rise by 1 ms per second, so slow drift of the client clock is not seen as a gap
+	static constexpr double ARRIVAL_LAG_DECAY_PER_SECOND = 0.001;
+	// Lets the jitter estimate fall by 10 ms per second once the network calms down
+	static constexpr double JITTER_DECAY_PER_SECOND = 0.01;
+
+	bool m_reset;
+	// The timeline is the frames received at the current sample rate on top of the time accumulated at earlier rates
+	// and skipped over gaps
+	double m_clockBase;
+	uint64 m_clockFrames;
+	int32 m_clockSampleRate;
+	double m_arrivalOrigin;
+	double m_minArrivalLag;
+	double m_jitterEstimate;
+
+	// Lag of the first packet after a suspected gap and the timeline position it arrived at
+	bool m_gapSuspected;
+	double m_suspectedLag;
+	double m_suspectedAt;
+};
+
+#endif // HOLOLIGHT_UNREAL_FSTREAMMICROPHONEARRIVALCLOCK_H
\ No newline at end of file
@@ -5,8 +5,13 @@
 #include "FStreamMicrophoneCaptureStream.h"
 
 #include "IStreamHMD.h"
+#include "StreamAudio.h"
 
-#include <vector>
+#include "ProfilingDebugging/CsvProfiler.h"
+
+#include <chrono>
+
+CSV_DEFINE_CATEGORY(StreamMicrophone, true);
 
 DEFINE_LOG_CATEGORY(LogHLSMicrophoneCapture);
 
@@ -20,17 +25,48 @@ FStreamMicrophoneCaptureStream::FStreamMicrophoneCaptureStream() : m_connected(f
 																   m_isCapturing(false),
 																   m_isTrackOpen(false),
 																   m_startMicrophoneOnConnection(false),
+																   m_outputSampleRate(SAMPLE_RATE),
+																   m_outputChannels(NUM_CHANNELS),
+																   m_framesPerCallback(SAMPLE_RATE / CHUNKS_PER_SECOND),
+																   m_inputSampleRate(0),
+																   m_inputChannels(0),
+																   m_jitterBuffer(JITTER_BUFFER_CAPACITY),
+																   m_resetArrivalClock(true),
+																   m_targetDepthSeconds(MIN_JITTER_BUFFER_SECONDS),
+																   m_pendingGapSeconds(0.0),
+																   m_pendingOverflow(false),
+																   m_starved(false),
+																   m_gapSuspected(false),
+																   m_outputFifoFrames(0),
+																   m_deliveredFrames(0),
+																   m_deliveredBase(0.0),
 																   m_streamTime(0.0),
-																   m_onCaptureCallback(nullptr)
+																   m_bufferDepthSeconds(0.0),
+																   m_latePackets(0),
+																   m_underruns(0),
+																   m_gapCount(0),
+																   m_droppedSamples(0),
+																   m_isRunning(true),
+																   m_onCaptureCallback(nullptr),
+																   m_onCaptureGeneration(0)
 {
 	if (auto* streamHMD = static_cast<IStreamHMD*>(GEngine->XRSystem.Get()))
 	{
 		streamHMD->SetMicrophoneCaptureStream(this);
 	}
+
+	m_deliveryThread = std::thread(&FStreamMicrophoneCaptureStream::DeliverAudio, this);
 }
 
 FStreamMicrophoneCaptureStream::~FStreamMicrophoneCaptureStream()
 {
+	if (m_deliveryThread.joinable())
+	{
+		m_isRunning = false;
+		m_newDataCv.notify_all();
+		m_deliveryThread.join();
+	}
+
 	if (IsCapturing())
 	{
 		StopStream();
@@ -107,13 +143,31 @@ bool FStreamMicrophoneCaptureStream::OpenAudioCaptureStream(const Audio::FAudioC
 															Audio::FOnAudioCaptureFunction inOnCapture,
 															uint32 numFramesDesired)
 {
+	std::scoped_lock lock(m_deliveryMutex);
+
 	m_onCaptureCallback = MoveTemp(inOnCapture);
+	m_onCaptureGeneration++;
+	// Zero asks for the device defaults
+	m_outputSampleRate = inParams.SampleRate > 0 ? inParams.SampleRate : SAMPLE_RATE;
+	m_outputChannels = inParams.NumInputChannels > 0 ? FMath::Min(inParams.NumInputChannels, MAX_NUM_CHANNELS)
+													 : NUM_CHANNELS;
+	m_framesPerCallback = numFramesDesired > 0 ? numFramesDesired : m_outputSampleRate / CHUNKS_PER_SECOND;
+
+	m_outputFifoFrames = 0;
+	m_deliveredFrames = 0;
+	m_deliveredBase = 0.0;
+	m_streamTime = 0.0;
 	m_isStreamOpen = true;
 	return true;
 }
 
 bool FStreamMicrophoneCaptureStream::CloseStream()
 {
+	const FStreamMicrophoneCaptureStats stats = GetStats();
+	UE_LOG(LogHLSMicrophoneCapture, Log,
+		   TEXT("Microphone jitter buffer: target %.1f ms, late packets %llu, underruns %llu, gaps %llu, dropped samples %llu"),
+		   stats.targetDepthMs, stats.latePackets, stats.underruns, stats.gaps, stats.droppedSamples);
+
 	m_isStreamOpen = false;
 	return true;
 }
@@ -141,16 +195,26 @@ bool FStreamMicrophoneCaptureStream::AbortStream()
 
 bool FStreamMicrophoneCaptureStream::GetStreamTime(double& outStreamTime)
 {
-	outStreamTime = m_streamTime;
+	outStreamTime = m_streamTime.load(std::memory_order_relaxed);
 	return true;
 }
 
 void FStreamMicrophoneCaptureStream::OnAudioCapture(void* inBuffer, uint32 inBufferFrames, double streamTime,
 													bool overflow)
 {
-	if (m_onCaptureCallback)
+	Audio::FOnAudioCaptureFunction onCapture;
+	int32 outputChannels;
+	int32 outputSampleRate;
+	{
+		std::scoped_lock lock(m_deliveryMutex);
+		onCapture = m_onCaptureCallback;
+		outputChannels = m_outputChannels;
+		outputSampleRate = m_outputSampleRate;
+	}
+
+	if (onCapture)
 	{
-		m_onCaptureCallback(inBuffer, inBufferFrames, NUM_CHANNELS, SAMPLE_RATE, streamTime, overflow);
+		onCapture(inBuffer, inBufferFrames, outputChannels, outputSampleRate, streamTime, overflow);
 	}
 }
 
@@ -164,6 +228,18 @@ bool FStreamMicrophoneCaptureStream::GetInputDevicesAvailable(TArray<Audio::FCap
 	return true;
 }
 
+FStreamMicrophoneCaptureStats FStreamMicrophoneCaptureStream::GetStats() const
+{
+	FStreamMicrophoneCaptureStats stats;
+	stats.bufferDepthMs = m_bufferDepthSeconds.load(std::memory_order_relaxed) * 1000.0;
+	stats.targetDepthMs = m_targetDepthSeconds.load(std::memory_order_relaxed) * 1000.0;
+	stats.latePackets = m_latePackets.load(std::memory_order_relaxed);
+	stats.underruns = m_underruns.load(std::memory_order_relaxed);
+	stats.gaps = m_gapCount.load(std::memory_order_relaxed);
+	stats.droppedSamples = m_droppedSamples.load(std::memory_order_relaxed) + m_jitterBuffer.GetOverflowCount();
+	return stats;
+}
+
 bool FStreamMicrophoneCaptureStream::OpenTrack()
 {
 	if (m_isTrackOpen)
@@ -181,6 +257,7 @@ bool FStreamMicrophoneCaptureStream::OpenTrack()
 		UE_LOG(LogHLSMicrophoneCapture, Display, TEXT("Failed to enable the microphone with error: %d"), err);
 		return false;
 	}
+	m_resetArrivalClock = true;
 	m_isTrackOpen = true;
 
 	return true;
@@ -239,6 +316,7 @@ void FStreamMicrophoneCaptureStream::OnConnectionStateChanged(isar::IsarConnecti
 					   TEXT("Failed to enable the microphone when connected with error: %d"), err);
 				return;
 			}
+			m_resetArrivalClock = true;
 			m_isTrackOpen = true;
 		}
 	}
@@ -262,12 +340,269 @@ void FStreamMicrophoneCaptureStream::OnMicrophoneCapture(isar::IsarAudioData con
 	if (!m_isTrackOpen)
 		return;
 
-	std::vector<float> data(audioData->samplesPerChannel * audioData->numberOfChannels);
-	for (int i = 0; i < data.size(); i++)
+	if (audioData->bitsPerSample != 16 || audioData->sampleRate <= 0 || audioData->numberOfChannels == 0 ||
+		audioData->numberOfChannels > MAX_NUM_CHANNELS)
+	{
+		UE_LOG(LogHLSMicrophoneCapture, Verbose,
+			   TEXT("Dropping microphone packet with %d bits per sample, %d channels at %d Hz."),
+			   audioData->bitsPerSample, (int32)audioData->numberOfChannels, audioData->sampleRate);
+		return;
+	}
+
+	const int32 numChannels = static_cast<int32>(audioData->numberOfChannels);
+	if (m_inputSampleRate != audioData->sampleRate || m_inputChannels != numChannels)
+	{
+		// The delivery thread notices the change, drops what was queued in the old format and reconfigures
+		m_inputSampleRate = audioData->sampleRate;
+		m_inputChannels = numChannels;
+	}
+
+	if (m_starved.exchange(false))
+	{
+		m_latePackets.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	const double gapSeconds = UpdateArrivalClock(audioData->samplesPerChannel, audioData->sampleRate);
+	if (gapSeconds > 0.0)
+	{
+		m_pendingGapSeconds.fetch_add(gapSeconds);
+		m_pendingOverflow = true;
+	}
+
+	const uint32 numSamples = static_cast<uint32>(audioData->samplesPerChannel * audioData->numberOfChannels);
+	if (!m_jitterBuffer.Write(reinterpret_cast<const int16_t*>(audioData->data), numSamples))
 	{
-		data[i] = reinterpret_cast<const int16_t*>(audioData->data)[i] / (float)MAX_int16;
+		m_pendingOverflow = true;
 	}
+	m_newDataCv.notify_all();
+}
+
+double FStreamMicrophoneCaptureStream::UpdateArrivalClock(uint32 numFrames, int32 sampleRate)
+{
+	if (m_resetArrivalClock.exchange(false))
+	{
+		m_arrivalClock.Reset();
+	}
+
+	const double gap = m_arrivalClock.Update(numFrames, sampleRate, FPlatformTime::Seconds());
+	if (gap > 0.0)
+	{
+		m_gapCount.fetch_add(1, std::memory_order_relaxed);
+		UE_LOG(LogHLSMicrophoneCapture, Verbose, TEXT("Microphone audio gap of %.1f ms detected."), gap * 1000.0);
+	}
+	m_gapSuspected = m_arrivalClock.IsGapSuspected();
+
+	const double packetSeconds = double(numFrames) / sampleRate;
+	m_targetDepthSeconds = FMath::Clamp(m_arrivalClock.GetJitterEstimate() + packetSeconds,
+										MIN_JITTER_BUFFER_SECONDS, MAX_JITTER_BUFFER_SECONDS);
+	return gap;
+}
 
-	m_streamTime += 0.01;
-	OnAudioCapture(data.data(), audioData->samplesPerChannel, m_streamTime, false);
+bool FStreamMicrophoneCaptureStream::ProcessChunk(int32 inputSampleRate, int32 inputChannels, int32 outputSampleRate,
+												  int32 outputChannels)
+{
+	const uint32 queuedFrames = m_jitterBuffer.Num() / inputChannels;
+	const int32 numFrames = FMath::Min<int32>(queuedFrames, inputSampleRate / CHUNKS_PER_SECOND);
+	if (numFrames == 0 || !m_jitterBuffer.Read(m_inputChunk.GetData(), numFrames * inputChannels))
+	{
+		return false;
+	}
+
+	stream::audio::Pcm16ToFloat(m_inputChunk.GetData(), m_floatChunk.GetData(), numFrames * inputChannels);
+
+	const float* remapped = m_floatChunk.GetData();
+	if (outputChannels < inputChannels && outputChannels <= stream::audio::FStreamAudioDownmix::MAX_OUTPUT_CHANNELS)
+	{
+		m_downmix.Process(m_floatChunk.GetData(), numFrames, m_remapChunk.GetData());
+		remapped = m_remapChunk.GetData();
+	}
+	else if (outputChannels != inputChannels)
+	{
+		// Wider outputs repeat the client channels, narrower ones beyond stereo keep the first channels
+		for (int32 frame = 0; frame < numFrames; frame++)
+		{
+			for (int32 channel = 0; channel < outputChannels; channel++)
+			{
+				m_remapChunk[frame * outputChannels + channel] =
+					m_floatChunk[frame * inputChannels + channel % inputChannels];
+			}
+		}
+		remapped = m_remapChunk.GetData();
+	}
+
+	int32 outputFrames = numFrames;
+	if (!m_resampler.IsPassthrough())
+	{
+		outputFrames = m_resampler.Process(remapped, numFrames, m_resampleChunk.GetData());
+		remapped = m_resampleChunk.GetData();
+	}
+
+	const int32 fifoSamples = (m_outputFifoFrames + outputFrames) * outputChannels;
+	if (m_outputFifo.Num() < fifoSamples)
+	{
+		m_outputFifo.SetNumUninitialized(fifoSamples);
+	}
+	FMemory::Memcpy(m_outputFifo.GetData() + m_outputFifoFrames * outputChannels, remapped,
+					outputFrames * outputChannels * sizeof(float));
+	m_outputFifoFrames += outputFrames;
+	return true;
+}
+
+void FStreamMicrophoneCaptureStream::DeliverAudio()
+{
+	using Clock = std::chrono::steady_clock;
+	constexpr auto idleWait = std::chrono::milliseconds(1000 / CHUNKS_PER_SECOND);
+
+	Clock::time_point nextDelivery = Clock::now();
+	bool buffering = true;
+	Audio::FOnAudioCaptureFunction onCapture;
+	uint32 onCaptureGeneration = 0;
+	// Input format the conversion was last configured for
+	int32 configuredSampleRate = 0;
+	int32 configuredChannels = 0;
+
+	while (m_isRunning)
+	{
+		const int32 inputSampleRate = m_inputSampleRate;
+		const int32 inputChannels = m_inputChannels;
+		if (!m_isTrackOpen || !m_isStreamOpen || inputSampleRate == 0)
+		{
+			buffering = true;
+			std::unique_lock lock(m_deliveryMutex);
+			m_newDataCv.wait_for(lock, idleWait, [this] { return !m_isRunning; });
+			continue;
+		}
+
+		std::unique_lock lock(m_deliveryMutex);
+		const int32 outputSampleRate = m_outputSampleRate;
+		const int32 outputChannels = m_outputChannels;
+		const int32 framesPerCallback = static_cast<int32>(m_framesPerCallback);
+
+		const int32 downmixChannels =
+			FMath::Min3(outputChannels, inputChannels, stream::audio::FStreamAudioDownmix::MAX_OUTPUT_CHANNELS);
+
+		if (!m_resampler.IsConfiguredFor(inputSampleRate, outputSampleRate, outputChannels) ||
+			!m_downmix.IsConfiguredFor(inputChannels, downmixChannels))
+		{
+			// Input or requested format changed, allocate for the new one here instead of on every chunk
+			if (!m_resampler.Configure(inputSampleRate, outputSampleRate, outputChannels))
+			{
+				UE_LOG(LogHLSMicrophoneCapture, Display, TEXT("Can not resample microphone audio from %d Hz to %d Hz."),
+					   inputSampleRate, outputSampleRate);
+				m_jitterBuffer.Reset();
+				m_newDataCv.wait_for(lock, idleWait, [this] { return !m_isRunning; });
+				continue;
+			}
+			m_downmix.Configure(inputChannels, downmixChannels);
+
+			const int32 chunkFrames = inputSampleRate / CHUNKS_PER_SECOND;
+			m_inputChunk.SetNumUninitialized(chunkFrames * inputChannels);
+			m_floatChunk.SetNumUninitialized(chunkFrames * inputChannels);
+			m_remapChunk.SetNumUninitialized(chunkFrames * outputChannels);
+			m_resampleChunk.SetNumUninitialized(m_resampler.GetMaxOutputFrames(chunkFrames) * outputChannels);
+			m_outputFifo.SetNumUninitialized((framesPerCallback + m_resampler.GetMaxOutputFrames(chunkFrames)) * outputChannels);
+			m_outputFifoFrames = 0;
+			// What was queued before the first configuration or a new request from the engine is already in the input
+			// format, only audio of an earlier input format has to go
+			if (configuredSampleRate != 0 &&
+				(configuredSampleRate != inputSampleRate || configuredChannels != inputChannels))
+			{
+				m_jitterBuffer.Reset();
+			}
+			configuredSampleRate = inputSampleRate;
+			configuredChannels = inputChannels;
+			buffering = true;
+		}
+
+		const double targetDepth = m_targetDepthSeconds.load(std::memory_order_relaxed);
+		const double queuedSeconds = double(m_jitterBuffer.Num()) / (inputChannels * inputSampleRate) +
+									 double(m_outputFifoFrames) / outputSampleRate;
+		m_bufferDepthSeconds.store(queuedSeconds, std::memory_order_relaxed);
+
+		if (buffering)
+		{
+			// Fill up to the target before delivery starts, so arrival jitter does not reach the engine. After running
+			// dry on a suspected gap, wait until it is settled, so the audio after it gets the right stream time.
+			if (queuedSeconds < targetDepth || m_gapSuspected)
+			{
+				m_newDataCv.wait_for(lock, idleWait, [this] { return !m_isRunning; });
+				continue;
+			}
+			buffering = false;
+			nextDelivery = Clock::now();
+		}
+
+		const auto blockDuration = std::chrono::microseconds(1000000LL * framesPerCallback / outputSampleRate);
+		m_newDataCv.wait_until(lock, nextDelivery, [this] { return !m_isRunning.load(); });
+		if (!m_isRunning)
+		{
+			break;
+		}
+		nextDelivery += blockDuration;
+		if (Clock::now() - nextDelivery > 4 * blockDuration)
+		{
+			nextDelivery = Clock::now();
+		}
+
+		// A burst after a network stall leaves far more queued than needed, drop the excess instead of adding latency
+		if (queuedSeconds > 2.0 * targetDepth + double(framesPerCallback) / outputSampleRate)
+		{
+			const uint32 excessFrames = static_cast<uint32>((queuedSeconds - targetDepth) * inputSampleRate);
+			const uint32 skipped = m_jitterBuffer.Skip(excessFrames * inputChannels);
+			m_droppedSamples.fetch_add(skipped, std::memory_order_relaxed);
+			// The dropped audio is still part of the client timeline
+			m_deliveredBase += double(skipped) / (inputChannels * inputSampleRate);
+			m_pendingOverflow = true;
+		}
+
+		while (m_outputFifoFrames < framesPerCallback)
+		{
+			if (!ProcessChunk(inputSampleRate, inputChannels, outputSampleRate, outputChannels))
+			{
+				break;
+			}
+		}
+
+		if (m_outputFifoFrames < framesPerCallback)
+		{
+			// Ran dry, the packet that should have been here is late
+			m_starved = true;
+			m_underruns.fetch_add(1, std::memory_order_relaxed);
+			buffering = true;
+			continue;
+		}
+
+		const bool overflow = m_pendingOverflow.exchange(false);
+		m_deliveredBase += m_pendingGapSeconds.exchange(0.0);
+		m_deliveredFrames += framesPerCallback;
+		const double streamTime = m_deliveredBase + double(m_deliveredFrames) / outputSampleRate;
+		m_streamTime = streamTime;
+
+		if (onCaptureGeneration != m_onCaptureGeneration)
+		{
+			onCapture = m_onCaptureCallback;
+			onCaptureGeneration = m_onCaptureGeneration;
+		}
+
+		// The engine callback may take engine locks or reopen the stream, so it must not run under the delivery
+		// lock. The output FIFO is only written on this thread and stays valid meanwhile.
+		lock.unlock();
+		if (onCapture)
+		{
+			onCapture(m_outputFifo.GetData(), framesPerCallback, outputChannels, outputSampleRate, streamTime,
+					  overflow);
+		}
+		lock.lock();
+
+		// A stream reopened during the callback already started over with an empty FIFO
+		if (onCaptureGeneration == m_onCaptureGeneration)
+		{
+			m_outputFifoFrames -= framesPerCallback;
+			FMemory::Memmove(m_outputFifo.GetData(), m_outputFifo.GetData() + framesPerCallback * outputChannels,
+							 m_outputFifoFrames * outputChannels * sizeof(float));
+		}
+
+		CSV_CUSTOM_STAT(StreamMicrophone, BufferDepthMs, static_cast<float>(queuedSeconds * 1000.0), ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(StreamMicrophone, TargetDepthMs, static_cast<float>(targetDepth * 1000.0), ECsvCustomStatOp::Set);
+	}
 }
\ No newline at end of file
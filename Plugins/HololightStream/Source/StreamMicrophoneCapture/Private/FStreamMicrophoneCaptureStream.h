@@ -12,6 +12,17 @@
 
 #include "IStreamExtension.h"
 
+#include "FStreamMicrophoneArrivalClock.h"
+
+#include "StreamAudioDownmix.h"
+#include "StreamAudioResampler.h"
+#include "StreamAudioRingBuffer.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 DECLARE_LOG_CATEGORY_EXTERN(LogHLSMicrophoneCapture, Log, All);
 
 namespace isar
@@ -20,12 +31,25 @@ struct IsarAudioData;
 enum IsarConnectionState;
 }
 
+struct FStreamMicrophoneCaptureStats
+{
+	double bufferDepthMs = 0.0;
+	double targetDepthMs = 0.0;
+	// Packets that arrived after the jitter buffer had already run dry
+	uint64 latePackets = 0;
+	uint64 underruns = 0;
+	uint64 gaps = 0;
+	uint64 droppedSamples = 0;
+};
 
 /// <summary>
 /// Implements the Unreal Engine Audio Capture Stream interface, which is created by the Audio Capture Factory
 /// implementations when a Audio Capture Component is created on the game. Audio Capture Component is responsible for
 /// using the capture data of the stream and playing it into a audio source. This class is created by the factory
 /// implementation: <see cref="FStreamMicrophoneCaptureFactory"/>
+/// Microphone packets are queued in a jitter buffer on arrival. A delivery thread hands them to the engine in blocks
+/// of the requested size, converted to the requested sample rate and channel count. The buffer depth adapts to the
+/// measured arrival jitter.
 /// </summary>
 class STREAMMICROPHONECAPTURE_API FStreamMicrophoneCaptureStream : public Audio::IAudioCaptureStream, public IStreamExtension
 {
@@ -51,7 +75,7 @@ public:
 	bool StopStream() override;
 	bool AbortStream() override;
 	bool GetStreamTime(double& outStreamTime) override;
-	int32 GetSampleRate() const override { return SAMPLE_RATE; }
+	int32 GetSampleRate() const override { return m_outputSampleRate; }
 	bool IsStreamOpen() const override { return m_isStreamOpen; }
 	bool IsCapturing() const override { return m_isCapturing; }
 	void OnAudioCapture(void* inBuffer, uint32 inBufferFrames, double streamTime, bool overflow) override;
@@ -60,28 +84,86 @@ public:
 	bool OpenTrack();
 	bool CloseTrack();
 
+	FStreamMicrophoneCaptureStats GetStats() const;
+
 private:
 	static constexpr int32 SAMPLE_RATE = 48000;
 	static constexpr int32 NUM_CHANNELS = 1;
 	static const FString DEVICE_NAME;
 	static const FString DEVICE_ID;
 	static constexpr bool SUPPORTS_HARDWARE_AEC = false;
+	static constexpr int32 MAX_NUM_CHANNELS = stream::audio::FStreamAudioDownmix::MAX_INPUT_CHANNELS;
+	// About 680 ms of audio at 48 kHz, the ring holds that many frames of the widest format the client may send
+	static constexpr uint32 JITTER_BUFFER_FRAMES = 1 << 15;
+	static constexpr uint32 JITTER_BUFFER_CAPACITY = JITTER_BUFFER_FRAMES * MAX_NUM_CHANNELS;
+	static constexpr double MIN_JITTER_BUFFER_SECONDS = 0.02;
+	static constexpr double MAX_JITTER_BUFFER_SECONDS = 0.2;
+	// Amount of audio the delivery thread converts at once
+	static constexpr int32 CHUNKS_PER_SECOND = 100;
 
 	bool m_connected;
 	isar::IsarConnection m_streamConnection;
 	isar::IsarServerApi* m_serverApi;
 
-	bool m_isStreamOpen;
+	std::atomic<bool> m_isStreamOpen;
 	// Engine has checks for IsCapturing, where the wrong value crashes the Engine.
 	// So m_isCapturing keeps the engine state, whereas m_isTrackOpen keeps the track state, which is necessary for us
 	bool m_isCapturing;
-	bool m_isTrackOpen;
+	std::atomic<bool> m_isTrackOpen;
 	bool m_startMicrophoneOnConnection;
 
-	double m_streamTime;
-
-	// Audio callback which will be called during audio capture.
+	// Format the engine asked for in OpenAudioCaptureStream, guarded by m_deliveryMutex
+	int32 m_outputSampleRate;
+	int32 m_outputChannels;
+	uint32 m_framesPerCallback;
+
+	// Format of the packets the client sends, written on the ISAR callback thread
+	std::atomic<int32> m_inputSampleRate;
+	std::atomic<int32> m_inputChannels;
+	stream::audio::FStreamAudioRingBuffer m_jitterBuffer;
+
+	// Timeline of the received audio, only touched on the ISAR callback thread
+	FStreamMicrophoneArrivalClock m_arrivalClock;
+	std::atomic<bool> m_resetArrivalClock;
+
+	// Handed from the ISAR callback thread to the delivery thread
+	std::atomic<double> m_targetDepthSeconds;
+	std::atomic<double> m_pendingGapSeconds;
+	std::atomic<bool> m_pendingOverflow;
+	std::atomic<bool> m_starved;
+	// Audio arriving after a suspected gap can only be timestamped once the gap is confirmed or ruled out
+	std::atomic<bool> m_gapSuspected;
+
+	// Only touched on the delivery thread
+	stream::audio::FStreamAudioDownmix m_downmix;
+	stream::audio::FStreamAudioResampler m_resampler;
+	TArray<int16_t> m_inputChunk;
+	TArray<float> m_floatChunk;
+	TArray<float> m_remapChunk;
+	TArray<float> m_resampleChunk;
+	TArray<float> m_outputFifo;
+	int32 m_outputFifoFrames;
+	uint64 m_deliveredFrames;
+	double m_deliveredBase;
+
+	// Stream time is the end of the last block delivered to the engine
+	std::atomic<double> m_streamTime;
+
+	std::atomic<double> m_bufferDepthSeconds;
+	std::atomic<uint64> m_latePackets;
+	std::atomic<uint64> m_underruns;
+	std::atomic<uint64> m_gapCount;
+	std::atomic<uint64> m_droppedSamples;
+
+	std::thread m_deliveryThread;
+	std::atomic<bool> m_isRunning;
+	std::mutex m_deliveryMutex;
+	std::condition_variable m_newDataCv;
+
+	// Audio callback which will be called during audio capture, guarded by m_deliveryMutex. The delivery thread calls
+	// its own copy outside the lock and only copies it again when the generation changed.
 	Audio::FOnAudioCaptureFunction m_onCaptureCallback;
+	uint32 m_onCaptureGeneration;
 
 	void RegisterCallbacks();
 	void UnregisterCallbacks();
@@ -91,6 +173,12 @@ private:
 
 	void OnConnectionStateChanged(isar::IsarConnectionState newState);
 	void OnMicrophoneCapture(isar::IsarAudioData const* audioData);
+	// Returns the duration of audio confirmed missing before this packet
+	double UpdateArrivalClock(uint32 numFrames, int32 sampleRate);
+
+	void DeliverAudio();
+	// Converts up to one chunk of queued audio to the output format, returns false if nothing was queued
+	bool ProcessChunk(int32 inputSampleRate, int32 inputChannels, int32 outputSampleRate, int32 outputChannels);
 };
 
 #endif // HOLOLIGHT_UNREAL_FSTREAMMICROPHONECAPTURESTREAM_H
\ No newline at end of file
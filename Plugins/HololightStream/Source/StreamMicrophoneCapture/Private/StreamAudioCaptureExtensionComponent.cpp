@@ -60,4 +60,14 @@ void UStreamAudioCaptureExtensionComponent::Stop()
 	{
 		m_captureStream->CloseTrack();
 	}
+}
+
+float UStreamAudioCaptureExtensionComponent::GetBufferDepthMs() const
+{
+	return m_captureStream ? static_cast<float>(m_captureStream->GetStats().bufferDepthMs) : 0.0f;
+}
+
+int64 UStreamAudioCaptureExtensionComponent::GetLatePacketCount() const
+{
+	return m_captureStream ? static_cast<int64>(m_captureStream->GetStats().latePackets) : 0;
 }
\ No newline at end of file
@@ -0,0 +1,236 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#include "Misc/AutomationTest.h"
+
+#include "FStreamMicrophoneArrivalClock.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+constexpr int32 PACKET_RATE = 48000;
+constexpr uint32 PACKET_FRAMES = 480;
+constexpr double PACKET_SECONDS = double(PACKET_FRAMES) / PACKET_RATE;
+constexpr double NETWORK_DELAY = 0.03;
+
+struct FArrivalReplay
+{
+	double totalGap = 0.0;
+	int32 numGaps = 0;
+	// Index of the packet the first gap was confirmed on
+	int32 firstGapPacket = INDEX_NONE;
+};
+
+// Feeds packets to the clock, arrivalTimes holds the arrival of each packet that was not lost. Packets are 10 ms long
+// unless packetFrames holds their sizes.
+FArrivalReplay ReplayArrivals(FStreamMicrophoneArrivalClock& clock, const TArray<double>& arrivalTimes,
+							  const TArray<uint32>& packetFrames = {})
+{
+	FArrivalReplay replay;
+	for (int32 index = 0; index < arrivalTimes.Num(); index++)
+	{
+		const uint32 numFrames = packetFrames.IsValidIndex(index) ? packetFrames[index] : PACKET_FRAMES;
+		const double gap = clock.Update(numFrames, PACKET_RATE, arrivalTimes[index]);
+		if (gap > 0.0)
+		{
+			replay.totalGap += gap;
+			replay.numGaps++;
+			if (replay.firstGapPacket == INDEX_NONE)
+			{
+				replay.firstGapPacket = index;
+			}
+		}
+	}
+	return replay;
+}
+
+// Sizes the client may send, 256 frames, 10 ms at 44.1 kHz and 20 ms at 48 kHz
+const uint32 MIXED_PACKET_FRAMES[] = {256, 441, 960};
+
+struct FMixedPacket
+{
+	uint32 numFrames;
+	// Client time the packet is sent at, once its last frame was recorded
+	double sent;
+};
+
+TArray<FMixedPacket> MakeMixedPackets(FRandomStream& random, double duration)
+{
+	TArray<FMixedPacket> packets;
+	uint64 recordedFrames = 0;
+	while (recordedFrames < duration * PACKET_RATE)
+	{
+		const int32 sizeIndex = random.RandRange(0, int32(UE_ARRAY_COUNT(MIXED_PACKET_FRAMES)) - 1);
+		const uint32 numFrames = MIXED_PACKET_FRAMES[sizeIndex];
+		recordedFrames += numFrames;
+		packets.Add({numFrames, double(recordedFrames) / PACKET_RATE});
+	}
+	return packets;
+}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamMicrophoneArrivalClockJitterTest,
+								 "HololightStream.Microphone.ArrivalClock.Jitter",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamMicrophoneArrivalClockJitterTest::RunTest(const FString& Parameters)
+{
+	// Up to 20 ms of arrival jitter on top of the network delay
+	FRandomStream random(7);
+	TArray<double> arrivals;
+	for (int32 packet = 0; packet < 500; packet++)
+	{
+		arrivals.Add(packet * PACKET_SECONDS + NETWORK_DELAY + (packet == 0 ? 0.0 : random.FRandRange(0.0f, 0.02f)));
+	}
+
+	FStreamMicrophoneArrivalClock clock;
+	const FArrivalReplay replay = ReplayArrivals(clock, arrivals);
+	TestEqual(TEXT("Jitter below the gap threshold is no gap"), replay.numGaps, 0);
+	TestTrue(TEXT("Jitter estimate covers the worst arrival delay"), clock.GetJitterEstimate() > 0.015);
+	TestTrue(TEXT("Jitter estimate does not exceed the worst arrival delay"), clock.GetJitterEstimate() <= 0.0201);
+	TestEqual(TEXT("Timeline is the audio received"), clock.GetReceivedSeconds(), 500 * PACKET_SECONDS, 1e-9);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamMicrophoneArrivalClockLateBurstTest,
+								 "HololightStream.Microphone.ArrivalClock.LateBurst",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamMicrophoneArrivalClockLateBurstTest::RunTest(const FString& Parameters)
+{
+	// A 300 ms network stall, the held back packets arrive at once when it clears
+	TArray<double> arrivals;
+	for (int32 packet = 0; packet < 200; packet++)
+	{
+		const double sent = packet * PACKET_SECONDS;
+		arrivals.Add(NETWORK_DELAY + (packet >= 50 && packet < 80 ? 80 * PACKET_SECONDS : sent));
+	}
+
+	FStreamMicrophoneArrivalClock clock;
+	const FArrivalReplay replay = ReplayArrivals(clock, arrivals);
+	TestEqual(TEXT("Late audio is not a gap"), replay.numGaps, 0);
+	TestFalse(TEXT("Suspicion is cleared once the late audio caught up"), clock.IsGapSuspected());
+	TestEqual(TEXT("Timeline is only the audio received"), clock.GetReceivedSeconds(), 200 * PACKET_SECONDS, 1e-9);
+
+	// The same stall with the packets trickling in at three times the client pace
+	arrivals.Reset();
+	for (int32 packet = 0; packet < 200; packet++)
+	{
+		const double sent = packet * PACKET_SECONDS;
+		const double released = 80 * PACKET_SECONDS + (packet - 50) * PACKET_SECONDS / 3.0;
+		arrivals.Add(NETWORK_DELAY + (packet >= 50 && packet < 110 ? FMath::Max(sent, released) : sent));
+	}
+	FStreamMicrophoneArrivalClock trickleClock;
+	const FArrivalReplay trickle = ReplayArrivals(trickleClock, arrivals);
+	TestEqual(TEXT("Late audio catching up slowly is not a gap"), trickle.numGaps, 0);
+	TestEqual(TEXT("Slow catch up leaves the timeline alone"), trickleClock.GetReceivedSeconds(), 200 * PACKET_SECONDS,
+			  1e-9);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamMicrophoneArrivalClockLostAudioTest,
+								 "HololightStream.Microphone.ArrivalClock.LostAudio",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamMicrophoneArrivalClockLostAudioTest::RunTest(const FString& Parameters)
+{
+	// 300 ms of packets never arrive, the ones after them are on time
+	TArray<double> arrivals;
+	for (int32 packet = 0; packet < 200; packet++)
+	{
+		if (packet < 50 || packet >= 80)
+		{
+			arrivals.Add(packet * PACKET_SECONDS + NETWORK_DELAY);
+		}
+	}
+
+	FStreamMicrophoneArrivalClock clock;
+	const FArrivalReplay replay = ReplayArrivals(clock, arrivals);
+	TestEqual(TEXT("Lost audio is one gap"), replay.numGaps, 1);
+	TestEqual(TEXT("Gap is the duration of the lost audio"), replay.totalGap, 30 * PACKET_SECONDS, 0.002);
+	TestTrue(TEXT("Gap is only confirmed after the packets following it kept the client pace"),
+			 replay.firstGapPacket >= 50 + int32(0.05 / PACKET_SECONDS));
+	TestEqual(TEXT("Timeline keeps pace with the client"), clock.GetReceivedSeconds(), 200 * PACKET_SECONDS, 0.002);
+	TestTrue(TEXT("Gap is not mistaken for jitter"), clock.GetJitterEstimate() < 0.01);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamMicrophoneArrivalClockSampleRateTest,
+								 "HololightStream.Microphone.ArrivalClock.SampleRateChange",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamMicrophoneArrivalClockSampleRateTest::RunTest(const FString& Parameters)
+{
+	// 10 ms packets that switch from 48 kHz to 16 kHz and back
+	FStreamMicrophoneArrivalClock clock;
+	int32 numGaps = 0;
+	for (int32 packet = 0; packet < 300; packet++)
+	{
+		const int32 sampleRate = packet >= 100 && packet < 200 ? 16000 : PACKET_RATE;
+		numGaps += clock.Update(sampleRate / 100, sampleRate, packet * PACKET_SECONDS + NETWORK_DELAY) > 0.0;
+	}
+	TestEqual(TEXT("Rate changes are no gap"), numGaps, 0);
+	TestEqual(TEXT("Timeline is continuous across rate changes"), clock.GetReceivedSeconds(), 300 * PACKET_SECONDS,
+			  1e-9);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamMicrophoneArrivalClockMixedSizesTest,
+								 "HololightStream.Microphone.ArrivalClock.MixedPacketSizes",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamMicrophoneArrivalClockMixedSizesTest::RunTest(const FString& Parameters)
+{
+	// Packets of 5 to 20 ms with up to 20 ms of arrival jitter, they never overtake each other
+	FRandomStream random(11);
+	const TArray<FMixedPacket> packets = MakeMixedPackets(random, 6.0);
+	TArray<double> arrivals;
+	TArray<uint32> packetFrames;
+	uint64 totalFrames = 0;
+	for (const FMixedPacket& packet : packets)
+	{
+		const double jitter = arrivals.IsEmpty() ? 0.0 : random.FRandRange(0.0f, 0.02f);
+		arrivals.Add(FMath::Max(packet.sent + NETWORK_DELAY + jitter, arrivals.IsEmpty() ? 0.0 : arrivals.Last()));
+		packetFrames.Add(packet.numFrames);
+		totalFrames += packet.numFrames;
+	}
+
+	FStreamMicrophoneArrivalClock clock;
+	const FArrivalReplay replay = ReplayArrivals(clock, arrivals, packetFrames);
+	TestEqual(TEXT("Jitter with mixed packet sizes is no gap"), replay.numGaps, 0);
+	TestTrue(TEXT("Jitter estimate covers the worst arrival delay"), clock.GetJitterEstimate() > 0.015);
+	TestTrue(TEXT("Larger packets are not mistaken for late ones"), clock.GetJitterEstimate() <= 0.0201);
+	TestEqual(TEXT("Timeline is the audio received"), clock.GetReceivedSeconds(), double(totalFrames) / PACKET_RATE,
+			  1e-9);
+
+	// The packets sent between 1 s and 1.3 s never arrive, the ones after them are on time
+	arrivals.Reset();
+	packetFrames.Reset();
+	uint64 lostFrames = 0;
+	for (const FMixedPacket& packet : packets)
+	{
+		if (packet.sent >= 1.0 && packet.sent < 1.3)
+		{
+			lostFrames += packet.numFrames;
+			continue;
+		}
+		arrivals.Add(packet.sent + NETWORK_DELAY);
+		packetFrames.Add(packet.numFrames);
+	}
+	FStreamMicrophoneArrivalClock lossClock;
+	const FArrivalReplay loss = ReplayArrivals(lossClock, arrivals, packetFrames);
+	TestEqual(TEXT("Lost audio between mixed packet sizes is one gap"), loss.numGaps, 1);
+	TestEqual(TEXT("Gap is the duration of the lost packets"), loss.totalGap, double(lostFrames) / PACKET_RATE, 0.002);
+	TestEqual(TEXT("Timeline keeps pace with the client"), lossClock.GetReceivedSeconds(),
+			  double(totalFrames) / PACKET_RATE, 0.002);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
\ No newline at end of file
@@ -0,0 +1,374 @@
+/*
+ * Copyright 2025 Holo-Light GmbH. All Rights Reserved.
+ */
+
+#include "Misc/AutomationTest.h"
+
+#include "FStreamMicrophoneCaptureStream.h"
+
+#include "HAL/MemoryBase.h"
+#include "HAL/PlatformTLS.h"
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+constexpr int32 PACKET_RATE = 48000;
+constexpr int32 PACKET_FRAMES = PACKET_RATE / 100;
+
+// The capture stream only registers its handlers for a valid connection, the mocks never look at it
+int32 GMockConnection = 0;
+isar::IsarServerAudioDataReceivedCallback GMicrophoneCallback = nullptr;
+void* GMicrophoneUserData = nullptr;
+
+void MockRegisterMicrophoneCaptureHandler(isar::IsarConnection connection, isar::IsarServerAudioDataReceivedCallback cb,
+										  void* userData)
+{
+	GMicrophoneCallback = cb;
+	GMicrophoneUserData = userData;
+}
+
+void MockUnregisterMicrophoneCaptureHandler(isar::IsarConnection connection,
+											isar::IsarServerAudioDataReceivedCallback cb, void* userData)
+{
+	GMicrophoneCallback = nullptr;
+	GMicrophoneUserData = nullptr;
+}
+
+void MockConnectionStateHandler(isar::IsarConnection connection, isar::IsarConnectionStateChangedCallback cb,
+								void* userData)
+{
+}
+
+isar::IsarError MockSetMicrophoneCaptureEnabled(isar::IsarConnection connection, int32_t enabled)
+{
+	return isar::IsarError::eNone;
+}
+
+isar::IsarServerApi MakeMockServerApi()
+{
+	GMicrophoneCallback = nullptr;
+	GMicrophoneUserData = nullptr;
+	isar::IsarServerApi serverApi = {};
+	serverApi.registerConnectionStateHandler = &MockConnectionStateHandler;
+	serverApi.unregisterConnectionStateHandler = &MockConnectionStateHandler;
+	serverApi.registerMicrophoneCaptureHandler = &MockRegisterMicrophoneCaptureHandler;
+	serverApi.unregisterMicrophoneCaptureHandler = &MockUnregisterMicrophoneCaptureHandler;
+	serverApi.setMicrophoneCaptureEnabled = &MockSetMicrophoneCaptureEnabled;
+	return serverApi;
+}
+
+// The server API has to outlive the stream. Packets are accepted from here on.
+void StartCapture(FStreamMicrophoneCaptureStream& stream, isar::IsarServerApi& serverApi)
+{
+	stream.SetStreamApi(&GMockConnection, &serverApi);
+	stream.SetConnected(true);
+	stream.StartStream();
+}
+
+// Hands a packet to the stream the way ISAR does, on the calling thread
+void ReceivePacket(const int16_t* samples, int32 numFrames, int32 sampleRate = PACKET_RATE, int32 numChannels = 1)
+{
+	isar::IsarAudioData audioData = {};
+	audioData.data = samples;
+	audioData.bitsPerSample = 16;
+	audioData.sampleRate = sampleRate;
+	audioData.numberOfChannels = numChannels;
+	audioData.samplesPerChannel = numFrames;
+	GMicrophoneCallback(&audioData, GMicrophoneUserData);
+}
+
+// Every frame carries its position in the client timeline, wrapped to what a positive PCM16 sample holds
+constexpr uint32 FRAME_NUMBER_PERIOD = uint32(MAX_int16) + 1;
+
+/// <summary>
+/// Stands in for the engine capture callback. Decodes the frame numbers of every delivered block, so each block can
+/// be checked against the stream time it came with.
+/// </summary>
+class FCaptureRecorder
+{
+public:
+	struct FBlock
+	{
+		double streamTime;
+		int32 numFrames;
+		bool overflow;
+		bool consecutive;
+		uint32 lastFrame;
+	};
+
+	Audio::FOnAudioCaptureFunction MakeCallback()
+	{
+		return [this](const void* buffer, int32 numFrames, int32 numChannels, int32 sampleRate, double streamTime,
+					  bool overflow)
+		{
+			const float* samples = static_cast<const float*>(buffer);
+			const uint32 firstFrame = DecodeFrame(samples[0]);
+			FBlock block = {streamTime, numFrames, overflow, numChannels == 1 && sampleRate == PACKET_RATE, 0};
+			for (int32 frame = 0; frame < numFrames; frame++)
+			{
+				block.lastFrame = DecodeFrame(samples[frame * numChannels]);
+				block.consecutive &= block.lastFrame == (firstFrame + frame) % FRAME_NUMBER_PERIOD;
+			}
+
+			std::scoped_lock lock(m_mutex);
+			m_blocks.Add(block);
+		};
+	}
+
+	TArray<FBlock> GetBlocks()
+	{
+		std::scoped_lock lock(m_mutex);
+		return m_blocks;
+	}
+
+private:
+	std::mutex m_mutex;
+	TArray<FBlock> m_blocks;
+
+	static uint32 DecodeFrame(float sample)
+	{
+		return static_cast<uint32>(FMath::RoundToInt(sample * MAX_int16));
+	}
+};
+
+/// <summary>
+/// Forwards to the allocator it replaces while installed as GMalloc and counts what the installing thread allocates.
+/// </summary>
+class FThreadAllocationCounter : public FMalloc
+{
+public:
+	void Install()
+	{
+		m_threadId = FPlatformTLS::GetCurrentThreadId();
+		m_allocations = 0;
+		m_inner = GMalloc;
+		GMalloc = this;
+	}
+
+	void Uninstall()
+	{
+		GMalloc = m_inner;
+	}
+
+	uint64 GetAllocations() const { return m_allocations; }
+
+	void* Malloc(SIZE_T count, uint32 alignment) override
+	{
+		Count();
+		return m_inner->Malloc(count, alignment);
+	}
+
+	void* TryMalloc(SIZE_T count, uint32 alignment) override
+	{
+		Count();
+		return m_inner->TryMalloc(count, alignment);
+	}
+
+	void* Realloc(void* original, SIZE_T count, uint32 alignment) override
+	{
+		Count();
+		return m_inner->Realloc(original, count, alignment);
+	}
+
+	void* TryRealloc(void* original, SIZE_T count, uint32 alignment) override
+	{
+		Count();
+		return m_inner->TryRealloc(original, count, alignment);
+	}
+
+	void Free(void* original) override { m_inner->Free(original); }
+	SIZE_T QuantizeSize(SIZE_T count, uint32 alignment) override { return m_inner->QuantizeSize(count, alignment); }
+	bool GetAllocationSize(void* original, SIZE_T& sizeOut) override
+	{
+		return m_inner->GetAllocationSize(original, sizeOut);
+	}
+	void Trim(bool trimThreadCaches) override { m_inner->Trim(trimThreadCaches); }
+	void SetupTLSCachesOnCurrentThread() override { m_inner->SetupTLSCachesOnCurrentThread(); }
+	void MarkTLSCachesAsUsedOnCurrentThread() override { m_inner->MarkTLSCachesAsUsedOnCurrentThread(); }
+	void MarkTLSCachesAsUnusedOnCurrentThread() override { m_inner->MarkTLSCachesAsUnusedOnCurrentThread(); }
+	void ClearAndDisableTLSCachesOnCurrentThread() override { m_inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+	bool IsInternallyThreadSafe() const override { return m_inner->IsInternallyThreadSafe(); }
+	bool ValidateHeap() override { return m_inner->ValidateHeap(); }
+	const TCHAR* GetDescriptiveName() override { return m_inner->GetDescriptiveName(); }
+
+private:
+	FMalloc* m_inner = nullptr;
+	uint32 m_threadId = 0;
+	uint64 m_allocations = 0;
+
+	void Count()
+	{
+		if (FPlatformTLS::GetCurrentThreadId() == m_threadId)
+		{
+			m_allocations++;
+		}
+	}
+};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamMicrophoneCaptureBenchmarkTest, "HololightStream.Microphone.Capture.Benchmark",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::PerfFilter)
+
+bool FStreamMicrophoneCaptureBenchmarkTest::RunTest(const FString& Parameters)
+{
+	// Five seconds of mono audio per stream, the jitter buffer holds all of it while the stream is not open, so every
+	// packet takes the same path into the ring as it does while the engine captures
+	constexpr int32 PACKETS_PER_STREAM = 500;
+	constexpr int32 NUM_STREAMS = 20;
+
+	TArray<int16_t> packet;
+	packet.SetNumUninitialized(PACKET_FRAMES);
+	for (int32 frame = 0; frame < PACKET_FRAMES; frame++)
+	{
+		packet[frame] = static_cast<int16_t>(FMath::Sin(2.0 * DOUBLE_PI * 440.0 * frame / PACKET_RATE) * 10000.0);
+	}
+
+	FThreadAllocationCounter allocationCounter;
+	double seconds = 0.0;
+	uint64 allocations = 0;
+	uint64 droppedSamples = 0;
+	for (int32 streamIndex = 0; streamIndex < NUM_STREAMS; streamIndex++)
+	{
+		isar::IsarServerApi serverApi = MakeMockServerApi();
+		FStreamMicrophoneCaptureStream stream;
+		StartCapture(stream, serverApi);
+		if (!TestNotNull(TEXT("The microphone handler is registered"), GMicrophoneCallback))
+		{
+			return false;
+		}
+
+		allocationCounter.Install();
+		const double start = FPlatformTime::Seconds();
+		for (int32 packetIndex = 0; packetIndex < PACKETS_PER_STREAM; packetIndex++)
+		{
+			ReceivePacket(packet.GetData(), PACKET_FRAMES);
+		}
+		seconds += FPlatformTime::Seconds() - start;
+		allocationCounter.Uninstall();
+		allocations += allocationCounter.GetAllocations();
+		droppedSamples += stream.GetStats().droppedSamples;
+	}
+
+	constexpr int32 numPackets = PACKETS_PER_STREAM * NUM_STREAMS;
+	AddInfo(FString::Printf(TEXT("10 ms mono packets: %.0f ns per packet, %.3f allocations per packet"),
+							seconds * 1e9 / numPackets, double(allocations) / numPackets));
+	TestEqual(TEXT("Every packet fits into the jitter buffer"), droppedSamples, uint64(0));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStreamMicrophoneCaptureStreamTimeTest,
+								 "HololightStream.Microphone.Capture.StreamTime",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext |
+								 EAutomationTestFlags::EngineFilter)
+
+bool FStreamMicrophoneCaptureStreamTimeTest::RunTest(const FString& Parameters)
+{
+	using FClock = std::chrono::steady_clock;
+	// Sizes the client may send, 256 frames, 10 ms at 44.1 kHz and 20 ms at 48 kHz
+	const int32 packetFrames[] = {256, 441, 960};
+	constexpr double DURATION_SECONDS = 2.5;
+	constexpr double MAX_JITTER_SECONDS = 0.008;
+	// Packets sent in between never arrive
+	constexpr double LOST_FROM_SECONDS = 1.2;
+	constexpr double LOST_TO_SECONDS = 1.5;
+
+	FCaptureRecorder recorder;
+	FStreamMicrophoneCaptureStats stats;
+	{
+		isar::IsarServerApi serverApi = MakeMockServerApi();
+		FStreamMicrophoneCaptureStream stream;
+		Audio::FAudioCaptureDeviceParams params;
+		params.SampleRate = PACKET_RATE;
+		params.NumInputChannels = 1;
+		stream.OpenAudioCaptureStream(params, recorder.MakeCallback(), PACKET_FRAMES);
+		StartCapture(stream, serverApi);
+
+		// The client sends each packet once its last frame was recorded, it arrives up to MAX_JITTER_SECONDS later
+		// without overtaking the one before
+		FRandomStream random(5);
+		TArray<int16_t> packet;
+		packet.SetNumUninitialized(packetFrames[UE_ARRAY_COUNT(packetFrames) - 1]);
+		const FClock::time_point start = FClock::now();
+		FClock::time_point lastArrival = start;
+		uint32 clientFrames = 0;
+		while (clientFrames < DURATION_SECONDS * PACKET_RATE)
+		{
+			const int32 numFrames = packetFrames[random.RandRange(0, int32(UE_ARRAY_COUNT(packetFrames)) - 1)];
+			for (int32 frame = 0; frame < numFrames; frame++)
+			{
+				packet[frame] = static_cast<int16_t>((clientFrames + frame) % FRAME_NUMBER_PERIOD);
+			}
+			clientFrames += numFrames;
+
+			const double sent = double(clientFrames) / PACKET_RATE;
+			const double jitter = random.FRandRange(0.0f, MAX_JITTER_SECONDS);
+			if (sent > LOST_FROM_SECONDS && sent <= LOST_TO_SECONDS)
+			{
+				continue;
+			}
+			lastArrival = FMath::Max(lastArrival, start + std::chrono::duration_cast<FClock::duration>(
+															  std::chrono::duration<double>(sent + jitter)));
+			std::this_thread::sleep_until(lastArrival);
+			ReceivePacket(packet.GetData(), numFrames);
+		}
+		// Lets the delivery thread run dry
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		stats = stream.GetStats();
+	}
+
+	const TArray<FCaptureRecorder::FBlock> blocks = recorder.GetBlocks();
+	if (!TestTrue(TEXT("Audio is delivered"), blocks.Num() > 0))
+	{
+		return false;
+	}
+	TestEqual(TEXT("The lost audio is one gap"), stats.gaps, uint64(1));
+
+	constexpr double blockSeconds = double(PACKET_FRAMES) / PACKET_RATE;
+	int32 wrongSizes = 0;
+	int32 broken = 0;
+	int32 uneven = 0;
+	int32 overflows = 0;
+	int32 offTimeline = 0;
+	int32 offTimelineBeforeGap = 0;
+	for (int32 index = 0; index < blocks.Num(); index++)
+	{
+		const FCaptureRecorder::FBlock& block = blocks[index];
+		wrongSizes += block.numFrames != PACKET_FRAMES;
+		overflows += block.overflow;
+		if (index > 0 && !block.overflow)
+		{
+			// Without a discontinuity the audio goes on where the last block ended and so does the stream time
+			const FCaptureRecorder::FBlock& previous = blocks[index - 1];
+			const uint32 expectedLastFrame = (previous.lastFrame + PACKET_FRAMES) % FRAME_NUMBER_PERIOD;
+			broken += !block.consecutive || block.lastFrame != expectedLastFrame;
+			uneven += !FMath::IsNearlyEqual(block.streamTime - previous.streamTime, blockSeconds, 1e-9);
+		}
+
+		// Stream time is the end of the block in the client timeline, exact until the gap and off by no more than
+		// the arrival jitter the gap was measured with after it
+		const int32 timelineFrames = FMath::RoundToInt(block.streamTime * PACKET_RATE) % FRAME_NUMBER_PERIOD;
+		int32 offset = timelineFrames - int32((block.lastFrame + 1) % FRAME_NUMBER_PERIOD);
+		offset += offset > int32(FRAME_NUMBER_PERIOD / 2) ? -int32(FRAME_NUMBER_PERIOD) : 0;
+		offset += offset < -int32(FRAME_NUMBER_PERIOD / 2) ? int32(FRAME_NUMBER_PERIOD) : 0;
+		offTimeline += FMath::Abs(offset) > (MAX_JITTER_SECONDS + 0.002) * PACKET_RATE;
+		offTimelineBeforeGap += block.streamTime < LOST_FROM_SECONDS && FMath::Abs(offset) > 1;
+	}
+	TestEqual(TEXT("Every block has the requested size"), wrongSizes, 0);
+	TestEqual(TEXT("Audio is continuous between discontinuities"), broken, 0);
+	TestEqual(TEXT("Stream time advances by the block duration between discontinuities"), uneven, 0);
+	TestTrue(TEXT("The gap is flagged"), overflows >= 1);
+	TestEqual(TEXT("Stream time matches the client timeline of the audio before the gap"), offTimelineBeforeGap, 0);
+	TestEqual(TEXT("Stream time matches the client timeline of the audio"), offTimeline, 0);
+
+	AddInfo(FString::Printf(TEXT("%d blocks, %d discontinuities, target depth %.1f ms"), blocks.Num(), overflows,
+							stats.targetDepthMs));
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
\ No newline at end of file
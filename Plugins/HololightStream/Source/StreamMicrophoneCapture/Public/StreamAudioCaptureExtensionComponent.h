@@ -37,6 +37,18 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Hololight Stream")
 	void Stop();
 
+	/// <summary>
+	/// Returns the amount of microphone audio in milliseconds queued in the jitter buffer.
+	/// </summary>
+	UFUNCTION(BlueprintCallable, Category = "Hololight Stream")
+	float GetBufferDepthMs() const;
+
+	/// <summary>
+	/// Returns the number of microphone packets that arrived after the jitter buffer had run dry.
+	/// </summary>
+	UFUNCTION(BlueprintCallable, Category = "Hololight Stream")
+	int64 GetLatePacketCount() const;
+
 private:
 	FStreamMicrophoneCaptureStream* m_captureStream;
 };
\ No newline at end of file